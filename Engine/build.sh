@@ -14,7 +14,7 @@ compilerFlags="-g -shared -fdeclspec -fPIC"
 # -fms-extensions 
 # -Wall -Werror
 includeFlags="-Isrc"
-linkerFlags="-lvulkan -lxcb -lX11 -lX11-xcb -lxkbcommon -L/usr/X11R6/lib"
+linkerFlags="-lvulkan -lxcb -lX11 -lX11-xcb -lxkbcommon -lpthread -L/usr/X11R6/lib"
 defines="-D_DEBUG -DTEXPORT"
 
 echo "Building $assembly..."
@@ -0,0 +1,165 @@
+#include "Containers/RingQueue.h"
+#include "Core/TMemory.h"
+#include "Core/Logger.h"
+#include "Platform/Atomic.h"
+
+// Each slot starts with its sequence number, followed by the element itself.
+#define SLOT_HEADER_SIZE sizeof(u64)
+
+static u64 SlotStride(u64 elementSize)
+{
+    // Keep every sequence number 8-byte aligned.
+    return SLOT_HEADER_SIZE + ((elementSize + 7) & ~(u64)7);
+}
+
+TINLINE u64* SlotSequence(ring_queue* queue, u64 position)
+{
+    return (u64*)(queue->memory + (position & (queue->capacity - 1)) * queue->slotStride);
+}
+
+u64 RingQueueMemoryRequirement(u64 elementSize, u64 capacity)
+{
+    return SlotStride(elementSize) * capacity;
+}
+
+b8 RingQueueCreate(u64 elementSize, u64 capacity, void* memory, ring_queue* outQueue)
+{
+    if (!outQueue || elementSize == 0 || capacity == 0 || (capacity & (capacity - 1)) != 0)
+    {
+        TERROR("RingQueueCreate - capacity must be a non-zero power of 2 and elementSize non-zero.");
+        return false;
+    }
+
+    TZeroMemory(outQueue, sizeof(ring_queue));
+    outQueue->elementSize = elementSize;
+    outQueue->slotStride = SlotStride(elementSize);
+    outQueue->capacity = capacity;
+    outQueue->ownsMemory = (memory == 0);
+    if (memory)
+    {
+        outQueue->memory = memory;
+    }
+    else
+    {
+        outQueue->memory = TAllocate(RingQueueMemoryRequirement(elementSize, capacity), MEMORY_TAG_RING_QUEUE);
+    }
+
+    // A slot is free for the producer at position p when its sequence equals p.
+    for (u64 i = 0; i < capacity; i++)
+    {
+        *SlotSequence(outQueue, i) = i;
+    }
+
+    return true;
+}
+
+void RingQueueDestroy(ring_queue* queue)
+{
+    if (queue)
+    {
+        if (queue->ownsMemory && queue->memory)
+        {
+            TFree(queue->memory, RingQueueMemoryRequirement(queue->elementSize, queue->capacity), MEMORY_TAG_RING_QUEUE);
+        }
+        TZeroMemory(queue, sizeof(ring_queue));
+    }
+}
+
+void* RingQueueBeginPush(ring_queue* queue)
+{
+    u64 position = AtomicLoad64(&queue->pushCursor, ATOMIC_RELAXED);
+    for (;;)
+    {
+        u64* sequence = SlotSequence(queue, position);
+        u64 seq = AtomicLoad64(sequence, ATOMIC_ACQUIRE);
+        s64 diff = (s64)seq - (s64)position;
+        if (diff == 0)
+        {
+            // Slot is free; try to claim it. On failure, position is reloaded.
+            if (AtomicCompareExchange64(&queue->pushCursor, &position, position + 1, ATOMIC_RELAXED, ATOMIC_RELAXED))
+            {
+                return (u8*)sequence + SLOT_HEADER_SIZE;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer has not released this slot yet - full.
+            return 0;
+        }
+        else
+        {
+            // Another producer claimed it first.
+            position = AtomicLoad64(&queue->pushCursor, ATOMIC_RELAXED);
+        }
+    }
+}
+
+void RingQueueEndPush(ring_queue* queue, void* element)
+{
+    u64* sequence = (u64*)((u8*)element - SLOT_HEADER_SIZE);
+    // Publish: the slot now holds the element for position (seq), readable at seq + 1.
+    u64 seq = AtomicLoad64(sequence, ATOMIC_RELAXED);
+    AtomicStore64(sequence, seq + 1, ATOMIC_RELEASE);
+}
+
+void* RingQueueBeginPop(ring_queue* queue)
+{
+    u64 position = AtomicLoad64(&queue->popCursor, ATOMIC_RELAXED);
+    for (;;)
+    {
+        u64* sequence = SlotSequence(queue, position);
+        u64 seq = AtomicLoad64(sequence, ATOMIC_ACQUIRE);
+        s64 diff = (s64)seq - (s64)(position + 1);
+        if (diff == 0)
+        {
+            if (AtomicCompareExchange64(&queue->popCursor, &position, position + 1, ATOMIC_RELAXED, ATOMIC_RELAXED))
+            {
+                return (u8*)sequence + SLOT_HEADER_SIZE;
+            }
+        }
+        else if (diff < 0)
+        {
+            // Nothing has been published here yet - empty.
+            return 0;
+        }
+        else
+        {
+            position = AtomicLoad64(&queue->popCursor, ATOMIC_RELAXED);
+        }
+    }
+}
+
+void RingQueueEndPop(ring_queue* queue, void* element)
+{
+    u64* sequence = (u64*)((u8*)element - SLOT_HEADER_SIZE);
+    // Hand the slot back to producers for the next lap around the ring.
+    u64 seq = AtomicLoad64(sequence, ATOMIC_RELAXED);
+    AtomicStore64(sequence, seq + queue->capacity - 1, ATOMIC_RELEASE);
+}
+
+b8 RingQueuePush(ring_queue* queue, const void* element)
+{
+    void* slot = RingQueueBeginPush(queue);
+    if (!slot) return false;
+
+    TCopyMemory(slot, element, queue->elementSize);
+    RingQueueEndPush(queue, slot);
+    return true;
+}
+
+b8 RingQueuePop(ring_queue* queue, void* outElement)
+{
+    void* slot = RingQueueBeginPop(queue);
+    if (!slot) return false;
+
+    TCopyMemory(outElement, slot, queue->elementSize);
+    RingQueueEndPop(queue, slot);
+    return true;
+}
+
+u64 RingQueueLength(ring_queue* queue)
+{
+    u64 pushed = AtomicLoad64(&queue->pushCursor, ATOMIC_ACQUIRE);
+    u64 popped = AtomicLoad64(&queue->popCursor, ATOMIC_ACQUIRE);
+    return pushed > popped ? pushed - popped : 0;
+}
\ No newline at end of file
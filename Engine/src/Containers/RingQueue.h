@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Bounded, lock-free multi-producer/multi-consumer queue of fixed-size elements.
+
+Every element slot is prefixed by a sequence number which tells producers and
+consumers whether the slot is free, being written, or ready to be read. Pushing
+and popping are a single compare-and-swap in the uncontended case and never
+take a lock. When the queue is full, pushes fail rather than block; the caller
+decides whether to spin, drop or fall back.
+
+Elements can either be copied in and out with RingQueuePush/RingQueuePop, or
+written/read in place with the Begin/End pairs to avoid an extra copy of large
+elements.
+*/
+
+typedef struct ring_queue
+{
+    // Size of a single element, in bytes.
+    u64 elementSize;
+    // Distance between slots in bytes (element + sequence header, padded).
+    u64 slotStride;
+    // Number of slots. Always a power of 2.
+    u64 capacity;
+    u8* memory;
+    b8 ownsMemory;
+
+    // Producer and consumer cursors are kept on separate cache lines
+    // so producers do not invalidate the consumer's line and vice versa.
+    u8 padding0[64];
+    u64 pushCursor;
+    u8 padding1[64];
+    u64 popCursor;
+    u8 padding2[64];
+} ring_queue;
+
+/**
+ * @brief Obtains the amount of memory required to back a queue of the given shape.
+ *
+ * @param elementSize The size of a single element in bytes.
+ * @param capacity The number of elements. Must be a power of 2.
+ * @return u64 The number of bytes required.
+ */
+TAPI u64 RingQueueMemoryRequirement(u64 elementSize, u64 capacity);
+
+/**
+ * @brief Creates a new ring queue.
+ *
+ * @param elementSize The size of a single element in bytes.
+ * @param capacity The number of elements. Must be a power of 2.
+ * @param memory A block of at least RingQueueMemoryRequirement() bytes, or 0 to have the queue allocate its own.
+ * @param outQueue A pointer to hold the created queue.
+ * @return b8 True on success; otherwise false.
+ */
+TAPI b8 RingQueueCreate(u64 elementSize, u64 capacity, void* memory, ring_queue* outQueue);
+TAPI void RingQueueDestroy(ring_queue* queue);
+
+/**
+ * @brief Copies an element into the queue. Safe to call from any thread.
+ *
+ * @return b8 True if pushed; false if the queue was full.
+ */
+TAPI b8 RingQueuePush(ring_queue* queue, const void* element);
+
+/**
+ * @brief Copies the oldest element out of the queue. Safe to call from any thread.
+ *
+ * @return b8 True if popped; false if the queue was empty.
+ */
+TAPI b8 RingQueuePop(ring_queue* queue, void* outElement);
+
+/**
+ * @brief Reserves the next slot for writing in place. The slot is invisible to
+ * consumers until RingQueueEndPush is called with the returned pointer.
+ *
+ * @return void* A pointer to elementSize writable bytes, or 0 if the queue is full.
+ */
+TAPI void* RingQueueBeginPush(ring_queue* queue);
+TAPI void RingQueueEndPush(ring_queue* queue, void* element);
+
+/**
+ * @brief Reserves the oldest element for reading in place. The slot is not
+ * reused by producers until RingQueueEndPop is called with the returned pointer.
+ *
+ * @return void* A pointer to the element, or 0 if the queue is empty.
+ */
+TAPI void* RingQueueBeginPop(ring_queue* queue);
+TAPI void RingQueueEndPop(ring_queue* queue, void* element);
+
+/**
+ * @brief Gives an approximate number of elements in the queue. Only exact
+ * when no other thread is pushing or popping.
+ */
+TAPI u64 RingQueueLength(ring_queue* queue);
\ No newline at end of file
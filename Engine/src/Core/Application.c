@@ -6,9 +6,20 @@
 #include "Core/Event.h"
 #include "Core/Input.h"
 #include "Core/Clock.h"
+#include "Core/JobSystem.h"
+#include "Core/TaskGraph.h"
+#include "Core/Profiler.h"
+#include "Core/FrameStats.h"
 #include "Memory/LinearAllocator.h"
+#include "Platform/Atomic.h"
 #include "Renderer/RendererFrontEnd.h"
 
+// How long before a frame is due to stop sleeping and spin instead, as the OS can wake threads late.
+#define FRAME_PACING_SPIN_NS 500000ULL
+
+// The most fixed updates run in a frame, unless the game configures otherwise.
+#define DEFAULT_MAX_FIXED_STEPS_PER_FRAME 8
+
 typedef struct application_state
 {
     game* gameInst;
@@ -18,6 +29,18 @@ typedef struct application_state
     s16 height;
     clock clock;
     f64 lastTime;
+    // The time between frames when the frame rate is limited, in nanoseconds, or 0 if unlimited.
+    u64 framePeriodNs;
+    // When the next frame is due to start, from PlatformGetTimestampNs, or 0 to start pacing afresh.
+    u64 nextFrameNs;
+    // How late the last frame started compared to when it was due, in seconds.
+    f64 pacingError;
+    // The number of frames kicked off, for the frame limit.
+    u64 frameCount;
+    // With a fixed timestep, the time not yet simulated, in seconds. Written by the update task only.
+    f64 fixedAccumulator;
+    // How far between fixed updates the latest frame is, for rendering. Written by the update task only.
+    f32 interpolationAlpha;
     linear_allocator systemsAlloc;
     u64 eventSysMemRequired;
     void* eventSysState;
@@ -25,6 +48,14 @@ typedef struct application_state
     void* memorySysState;
     u64 logSysMemRequired;
     void* logSysState;
+    u64 profilerSysMemRequired;
+    void* profilerSysState;
+    u64 frameStatsSysMemRequired;
+    void* frameStatsSysState;
+    u64 jobSysMemRequired;
+    void* jobSysState;
+    u64 taskGraphSysMemRequired;
+    void* taskGraphSysState;
     u64 inputSysMemRequired;
     void* inputSysState;
     u64 platformSysMemRequired;
@@ -40,6 +71,23 @@ b8 ApplicationOnEvent(u16 code, void* sender, void* listenerInst, event_context
 b8 ApplicationOnKey(u16 code, void* sender, void* listenerInst, event_context context);
 b8 ApplicationOnResized(u16 code, void* sender, void* listenerInst, event_context context);
 
+// The engine's frame tasks, in the order they are added, which is also the order of their timings.
+typedef enum frame_task
+{
+    FRAME_TASK_PUMP_MESSAGES,
+    FRAME_TASK_GAME_UPDATE,
+    FRAME_TASK_GAME_RENDER,
+    FRAME_TASK_DRAW_FRAME,
+    FRAME_TASK_INPUT_UPDATE,
+    FRAME_TASK_CONSOLE_FLUSH,
+    FRAME_TASK_COUNT
+} frame_task;
+
+// Frame tasks
+static b8 RegisterFrameTasks();
+static void RecordFrameStats(f64 frameTime, f64 pacingError);
+static void PaceFrame();
+
 b8 ApplicationCreate(game* gameInst)
 {
     if (gameInst->applicationState)
@@ -54,6 +102,18 @@ b8 ApplicationCreate(game* gameInst)
     appState->gameInst = gameInst;
     appState->isRunning = false;
     appState->isSuspended = false;
+    ApplicationSetTargetFrameRate(gameInst->appConfig.targetFrameRate);
+    appState->fixedAccumulator = 0;
+    appState->interpolationAlpha = 1.0f;
+    if (gameInst->appConfig.fixedTimestep < 0)
+    {
+        TWARN("Negative fixed timestep given, updating by the frame's time instead.");
+        gameInst->appConfig.fixedTimestep = 0;
+    }
+    if (gameInst->appConfig.maxFixedStepsPerFrame == 0)
+    {
+        gameInst->appConfig.maxFixedStepsPerFrame = DEFAULT_MAX_FIXED_STEPS_PER_FRAME;
+    }
 
     // Setup linear allocator
     u64 systemsAllocTotalSize = 64 * 1024 * 1024; // 64MB
@@ -81,6 +141,39 @@ b8 ApplicationCreate(game* gameInst)
         return false;
     }
 
+    // Profiler, before anything which starts threads, so they can name themselves.
+    ProfilerInitialize(&appState->profilerSysMemRequired, 0);
+    appState->profilerSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->profilerSysMemRequired);
+    if (!ProfilerInitialize(&appState->profilerSysMemRequired, appState->profilerSysState))
+    {
+        TERROR("Failed to initialize profiler! Shutting down...");
+        return false;
+    }
+    ProfilerSetThreadName("Main");
+
+    // Jobs, with one worker per physical core.
+    JobSystemInitialize(&appState->jobSysMemRequired, 0, 0);
+    appState->jobSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->jobSysMemRequired);
+    if (!JobSystemInitialize(&appState->jobSysMemRequired, appState->jobSysState, 0))
+    {
+        TERROR("Failed to initialize job system! Shutting down...");
+        return false;
+    }
+
+    // Task graph
+    TaskGraphInitialize(&appState->taskGraphSysMemRequired, 0);
+    appState->taskGraphSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->taskGraphSysMemRequired);
+    if (!TaskGraphInitialize(&appState->taskGraphSysMemRequired, appState->taskGraphSysState))
+    {
+        TERROR("Failed to initialize task graph! Shutting down...");
+        return false;
+    }
+
+    // Frame statistics
+    FrameStatsInitialize(&appState->frameStatsSysMemRequired, 0);
+    appState->frameStatsSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->frameStatsSysMemRequired);
+    FrameStatsInitialize(&appState->frameStatsSysMemRequired, appState->frameStatsSysState);
+
     // Input
     InputSystemInitialize(&appState->inputSysMemRequired, 0);
     appState->inputSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->inputSysMemRequired);
@@ -91,31 +184,57 @@ b8 ApplicationCreate(game* gameInst)
     EventRegister(EVENT_CODE_KEY_PRESSED, 0, ApplicationOnKey);
     EventRegister(EVENT_CODE_KEY_RELEASED, 0, ApplicationOnKey);
     EventRegister(EVENT_CODE_RESIZED, 0, ApplicationOnResized);
+    // Only the latest of these matters each frame.
+    EventSetCoalescing(EVENT_CODE_MOUSE_MOVED, true);
+    EventSetCoalescing(EVENT_CODE_RESIZED, true);
 
-    // Platform
-    PlatformSystemStartup(&appState->platformSysMemRequired, 0, 0, 0, 0, 0, 0);
-    appState->platformSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->platformSysMemRequired);
-    if (!PlatformSystemStartup(
-            &appState->platformSysMemRequired,
-            appState->platformSysState,
-            gameInst->appConfig.name,
-            gameInst->appConfig.startPosX,
-            gameInst->appConfig.startPosY,
-            gameInst->appConfig.startWidth,
-            gameInst->appConfig.startHeight))
+    if (gameInst->appConfig.headless)
     {
-        return false;
+        // With no window to be resized, the configured size stands for good.
+        TINFO("Running headless, without a window.");
+        appState->width = gameInst->appConfig.startWidth;
+        appState->height = gameInst->appConfig.startHeight;
+    }
+    else
+    {
+        // Platform
+        PlatformSystemStartup(&appState->platformSysMemRequired, 0, 0, 0, 0, 0, 0);
+        appState->platformSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->platformSysMemRequired);
+        if (!PlatformSystemStartup(
+                &appState->platformSysMemRequired,
+                appState->platformSysState,
+                gameInst->appConfig.name,
+                gameInst->appConfig.startPosX,
+                gameInst->appConfig.startPosY,
+                gameInst->appConfig.startWidth,
+                gameInst->appConfig.startHeight))
+        {
+            return false;
+        }
     }
 
-    // Renderer
-    RendererSystemInitialize(&appState->rendererSysMemRequired, 0, 0);
+    // Renderer. Headless, it draws offscreen if asked, or else runs everything short of the GPU.
+    b8 offscreen = gameInst->appConfig.headless;
+    renderer_backend_type backendType = RENDERER_BACKEND_TYPE_VULKAN;
+    if (gameInst->appConfig.headless && !gameInst->appConfig.renderOffscreen)
+    {
+        backendType = RENDERER_BACKEND_TYPE_NULL;
+    }
+    RendererSystemInitialize(&appState->rendererSysMemRequired, 0, 0, backendType, offscreen);
     appState->rendererSysState = LinearAllocatorAllocate(&appState->systemsAlloc, appState->rendererSysMemRequired);
-    if (!RendererSystemInitialize(&appState->rendererSysMemRequired, appState->rendererSysState, gameInst->appConfig.name))
+    if (!RendererSystemInitialize(&appState->rendererSysMemRequired, appState->rendererSysState, gameInst->appConfig.name, backendType, offscreen))
     {
         TFATAL("Failed to initialize renderer. Aborting application");
         return false;
     }
 
+    // Before the game initializes, so tasks it adds come after the engine's.
+    if (!RegisterFrameTasks())
+    {
+        TFATAL("Failed to register frame tasks. Aborting application");
+        return false;
+    }
+
     // Initialize the game.
     if (!appState->gameInst->Initialize(appState->gameInst)) {
         TFATAL("Game failed to initialize.");
@@ -134,74 +253,72 @@ b8 ApplicationRun()
     ClockStart(&appState->clock);
     ClockUpdate(&appState->clock);
     appState->lastTime = appState->clock.elapsed;
-    f64 runningTime = 0;
-    u8 frameCount = 0;
-    f64 targetFrameSeconds = 1.0f / 60;
-    
+
     TINFO(GetMemoryUsageStr());
 
+    // Each frame is kicked off before waiting on the one before, so the next frame's
+    // simulation can run while the previous one is still being drawn.
+    u64 previousFrame = 0;
+    b8 previousFrameInFlight = false;
+    // The frame time and pacing error the frame in flight was kicked with, recorded with its
+    // task timings once it is done.
+    f64 previousFrameTime = 0;
+    f64 previousPacingError = 0;
     while (appState->isRunning)
     {
-        if(!PlatformPumpMessages())
-        {
-            appState->isRunning = false;
-        }
+        TPROFILE_SCOPE("Frame");
 
-        if(!appState->isSuspended)
+        if (appState->isSuspended)
         {
-            ClockUpdate(&appState->clock);
-            f64 currentTime = appState->clock.elapsed;
-            f64 delta = currentTime - appState->lastTime;
-            f64 frameStartTime = PlatformGetAbsoluteTime();
-            
-            if (!appState->gameInst->Update(appState->gameInst, (f32)delta))
+            // With no frames running, messages are pumped here instead, to notice being restored.
+            if (previousFrameInFlight)
             {
-                TFATAL("Game update failed, shutting down.");
-                appState->isRunning = false;
-                break;
+                previousFrameInFlight = false;
+                if (!TaskGraphWaitFrame(previousFrame))
+                {
+                    TFATAL("A frame task failed, shutting down.");
+                    appState->isRunning = false;
+                    break;
+                }
+                RecordFrameStats(previousFrameTime, previousPacingError);
             }
-
-            // Call the game's render routine.
-            if (!appState->gameInst->Render(appState->gameInst, (f32)delta))
+            if (!PlatformPumpMessages())
             {
-                TFATAL("Game render failed, shutting down.");
                 appState->isRunning = false;
-                break;
             }
+            EventDispatchQueued();
+            continue;
+        }
 
-            // TODO: refactor packet creation
-            render_packet packet;
-            packet.dt = delta;
-            RendererDrawFrame(&packet);
-
-            // Figure our how long the frame took and, if below...
-            f64 frameEndTime = PlatformGetAbsoluteTime();
-            f64 frameElapsedTime = frameEndTime - frameStartTime;
-            runningTime += frameElapsedTime;
-            f64 remainingSeconds = targetFrameSeconds - frameElapsedTime;
-
-            if (remainingSeconds > 0)
-            {
-                u64 remainingMs = remainingSeconds * 1000;
+        ClockUpdate(&appState->clock);
+        f64 currentTime = appState->clock.elapsed;
+        f64 delta = currentTime - appState->lastTime;
 
-                // If there is time left, give it back to the OS
-                b8 limitFrames = false;
-                if (remainingMs > 0 && limitFrames)
-                {
-                    PlatformSleep(remainingMs - 1);
-                }
+        u64 frame = TaskGraphKickFrame(delta);
+        if (previousFrameInFlight && !TaskGraphWaitFrame(previousFrame))
+        {
+            TFATAL("A frame task failed, shutting down.");
+            appState->isRunning = false;
+            break;
+        }
+        if (previousFrameInFlight) RecordFrameStats(previousFrameTime, previousPacingError);
+        previousFrame = frame;
+        previousFrameInFlight = true;
+        previousFrameTime = delta;
+        previousPacingError = appState->pacingError;
+        EventTraceEndFrame();
 
-                frameCount++;
-            }
+        // Hold the next frame back until it is due, if the frame rate is limited.
+        if (appState->framePeriodNs) PaceFrame();
 
-            // NOTE: Input update/state copying should always be handled
-            // after any input should be recorded; I.E. before this line.
-            // As a safety, input is the last thing to be updated before
-            // this frame ends.
-            InputUpdate(delta);
+        // Update last time
+        appState->lastTime = currentTime;
 
-            // Update last time
-            appState->lastTime = currentTime;
+        appState->frameCount++;
+        if (appState->gameInst->appConfig.frameLimit && appState->frameCount >= appState->gameInst->appConfig.frameLimit)
+        {
+            TINFO("Frame limit of %llu reached, shutting down.", appState->gameInst->appConfig.frameLimit);
+            appState->isRunning = false;
         }
     }
 
@@ -212,16 +329,39 @@ b8 ApplicationRun()
     EventUnregister(EVENT_CODE_KEY_PRESSED, 0, ApplicationOnKey);
     EventUnregister(EVENT_CODE_KEY_RELEASED, 0, ApplicationOnKey);
     EventUnregister(EVENT_CODE_RESIZED, 0, ApplicationOnResized);
+    // First, so no task or job is still running against a system being shut down.
+    TaskGraphShutdown(appState->taskGraphSysState);
+    JobSystemShutdown(appState->jobSysState);
+#if TPROFILE_ENABLED
+    // Once every thread has stopped recording, so nothing is missed.
+    const char* tracePath = appState->gameInst->appConfig.tracePath;
+    if (tracePath && !ProfilerWriteChromeTrace(tracePath))
+    {
+        TWARN("Failed to write the profiler trace to '%s'.", tracePath);
+    }
+#endif
+    FrameStatsShutdown(appState->frameStatsSysState);
+    ProfilerShutdown(appState->profilerSysState);
     InputSystemShutdown(&appState->inputSysState);
     RendererSystemShutdown(&appState->rendererSysState);
     PlatformSystemShutdown(&appState->platformSysState);
     MemorySystemShutdown(&appState->memorySysState);
     EventSystemShutdown(&appState->eventSysState);
+    // Last, so everything logged during shutdown still makes it out.
+    ShutdownLogging(appState->logSysState);
 
     return true;
 }
 
 void ApplicationGetFramebufferSize(u32* width, u32* height) {
+    // Without an application, such as in tests, there is no size to go by.
+    if (!appState)
+    {
+        *width = 0;
+        *height = 0;
+        return;
+    }
+
     *width = appState->width;
     *height = appState->height;
 }
@@ -315,4 +455,161 @@ b8 ApplicationOnResized(u16 code, void* sender, void* listenerInst, event_contex
 
     // Event purposely not handled to allow other listeners to get this.
     return false;
+}
+
+static b8 PumpMessagesTask(void* userData, const task_frame* frame)
+{
+    if (!PlatformPumpMessages())
+    {
+        appState->isRunning = false;
+    }
+
+    // Deliver everything the pump posted, in one go.
+    EventDispatchQueued();
+    return true;
+}
+
+static b8 GameUpdateTask(void* userData, const task_frame* frame)
+{
+    game* gameInst = appState->gameInst;
+    f64 step = gameInst->appConfig.fixedTimestep;
+    if (step == 0)
+    {
+        return gameInst->Update(gameInst, (f32)frame->dt);
+    }
+
+    // Simulate in whole steps for as long as real time is ahead of the simulation.
+    appState->fixedAccumulator += frame->dt;
+    u32 steps = 0;
+    while (appState->fixedAccumulator >= step && steps < gameInst->appConfig.maxFixedStepsPerFrame)
+    {
+        if (!gameInst->Update(gameInst, (f32)step)) return false;
+        appState->fixedAccumulator -= step;
+        steps++;
+    }
+
+    if (appState->fixedAccumulator >= step)
+    {
+        // Too far behind to catch up. Drop the whole steps still owed, slowing the simulation
+        // down rather than spending ever longer frames catching up, but keep the part step.
+        f64 dropped = (f64)(u64)(appState->fixedAccumulator / step) * step;
+        TDEBUG("Dropped %.1fms of simulation, after %u fixed updates in a frame.", dropped * 1000.0, steps);
+        appState->fixedAccumulator -= dropped;
+    }
+
+    // Whatever is left is less than a step, so this is in [0, 1).
+    appState->interpolationAlpha = (f32)(appState->fixedAccumulator / step);
+    return true;
+}
+
+static b8 GameRenderTask(void* userData, const task_frame* frame)
+{
+    // Ordered after this frame's update and before the next frame's, as both touch the game's state.
+    return appState->gameInst->Render(appState->gameInst, (f32)frame->dt, appState->interpolationAlpha);
+}
+
+static b8 DrawFrameTask(void* userData, const task_frame* frame)
+{
+    render_packet packet;
+    RendererBuildPacket((f32)frame->dt, &packet);
+    RendererDrawFrame(&packet);
+    return true;
+}
+
+static b8 InputUpdateTask(void* userData, const task_frame* frame)
+{
+    // NOTE: Input update/state copying should always be handled
+    // after any input should be recorded. The graph orders this after
+    // everything reading input this frame, and before the next pump.
+    InputUpdate(frame->dt);
+    return true;
+}
+
+static b8 ConsoleFlushTask(void* userData, const task_frame* frame)
+{
+    // Write out anything logged to the console this frame in one go.
+    PlatformConsoleFlush();
+    return true;
+}
+
+static b8 RegisterFrameTasks()
+{
+    u64 window = TaskGraphResource("window");
+    u64 input = TaskGraphResource("input");
+    u64 gameState = TaskGraphResource("game");
+    u64 renderData = TaskGraphResource("render_data");
+    u64 gpu = TaskGraphResource("gpu");
+    u64 console = TaskGraphResource("console");
+
+    // Pumping messages writes game state too, since events are handed to the game.
+    // The renderer only reads what the game hands it in render, so the next frame's
+    // update can run while this frame is drawn.
+    task_desc tasks[FRAME_TASK_COUNT] = {
+        [FRAME_TASK_PUMP_MESSAGES] = {"PumpMessages", PumpMessagesTask, 0, 0, window | input | gameState, true},
+        [FRAME_TASK_GAME_UPDATE] = {"GameUpdate", GameUpdateTask, 0, input, gameState, false},
+        [FRAME_TASK_GAME_RENDER] = {"GameRender", GameRenderTask, 0, gameState, renderData, false},
+        [FRAME_TASK_DRAW_FRAME] = {"DrawFrame", DrawFrameTask, 0, renderData, gpu, true},
+        [FRAME_TASK_INPUT_UPDATE] = {"InputUpdate", InputUpdateTask, 0, 0, input, true},
+        [FRAME_TASK_CONSOLE_FLUSH] = {"ConsoleFlush", ConsoleFlushTask, 0, 0, console, true}};
+
+    for (u32 i = 0; i < FRAME_TASK_COUNT; i++)
+    {
+        if (!TaskGraphAddTask(&tasks[i])) return false;
+    }
+    return true;
+}
+
+// Records the frame just finished, taking the stage times from its tasks.
+static void RecordFrameStats(f64 frameTime, f64 pacingError)
+{
+    u32 timingCount = 0;
+    const task_timing* timings = TaskGraphGetTimings(&timingCount);
+    if (timingCount < FRAME_TASK_COUNT) return;
+
+    f64 times[FRAME_STAT_MAX];
+    times[FRAME_STAT_FRAME] = frameTime;
+    times[FRAME_STAT_UPDATE] = timings[FRAME_TASK_GAME_UPDATE].duration;
+    times[FRAME_STAT_RENDER] = timings[FRAME_TASK_GAME_RENDER].duration;
+    times[FRAME_STAT_PRESENT] = timings[FRAME_TASK_DRAW_FRAME].duration;
+    times[FRAME_STAT_PACING_ERROR] = pacingError;
+    FrameStatsRecord(times);
+}
+
+void ApplicationSetTargetFrameRate(u32 framesPerSecond)
+{
+    if (!appState) return;
+
+    appState->framePeriodNs = framesPerSecond ? 1000000000ULL / framesPerSecond : 0;
+    appState->nextFrameNs = 0;
+    appState->pacingError = 0;
+}
+
+// Waits until the next frame is due. Sleeps for most of the wait, as that gives the
+// time back to the OS, then spins for the rest, as sleeps are not precise.
+static void PaceFrame()
+{
+    u64 now = PlatformGetTimestampNs();
+    u64 deadline = appState->nextFrameNs;
+
+    // On the first frame, or once more than a whole frame behind, start pacing afresh
+    // from now instead of rushing through frames to catch up.
+    if (deadline == 0 || now >= deadline + appState->framePeriodNs)
+    {
+        appState->nextFrameNs = now + appState->framePeriodNs;
+        appState->pacingError = 0;
+        return;
+    }
+
+    if (now + FRAME_PACING_SPIN_NS < deadline)
+    {
+        PlatformSleepNs(deadline - now - FRAME_PACING_SPIN_NS);
+    }
+    while ((now = PlatformGetTimestampNs()) < deadline)
+    {
+        AtomicPause();
+    }
+
+    // Scheduled from the deadline rather than now, so lateness does not build up over frames.
+    appState->pacingError = (f64)(now - deadline) / 1000000000.0;
+    appState->nextFrameNs = deadline + appState->framePeriodNs;
 }
\ No newline at end of file
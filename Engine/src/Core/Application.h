@@ -16,9 +16,34 @@ typedef struct application_config {
     s16 startHeight;
     // The application name used in windowing, if applicable.
     char* name;
+    // The most frames per second to run at, giving spare time back to the OS. 0 is unlimited.
+    u32 targetFrameRate;
+    // The time each update simulates, in seconds, for a fixed timestep. Updates then run as many
+    // times a frame as it takes to keep up with real time. 0 updates once a frame, by the frame's time.
+    f64 fixedTimestep;
+    // With a fixed timestep, the most updates run in one frame, so a slow frame can't lead
+    // to ever more updates to catch up. Any time left over is dropped. 0 uses the default.
+    u32 maxFixedStepsPerFrame;
+    // Runs without a window, such as on a server or in a benchmark. Frames run as fast
+    // as they can, or at targetFrameRate if set. The window size is still reported as the framebuffer size.
+    b8 headless;
+    // When headless, still draws every frame with Vulkan, into images the renderer owns rather than
+    // a window. Nothing is presented. Otherwise headless runs use the null renderer, which touches no GPU.
+    b8 renderOffscreen;
+    // Quits once this many frames have run, so benchmarks run for a set length. 0 runs until told to quit.
+    u64 frameLimit;
+    // Where to write the profiler's zones as a Chrome trace when shutting down. 0 writes none.
+    // Zones are only recorded when profiling is compiled in.
+    const char* tracePath;
 } application_config;
 
 
 TAPI b8 ApplicationCreate(struct game* gameInst);
 TAPI b8 ApplicationRun();
-void ApplicationGetFramebufferSize(u32* width, u32* height);
\ No newline at end of file
+void ApplicationGetFramebufferSize(u32* width, u32* height);
+
+/**
+ * Changes the most frames per second the application runs at.
+ * @param framesPerSecond The frame rate to limit to, or 0 for unlimited.
+ */
+TAPI void ApplicationSetTargetFrameRate(u32 framesPerSecond);
\ No newline at end of file
@@ -1,26 +1,134 @@
 #include "Core/Event.h"
+#include "Core/Asserts.h"
 #include "Core/TMemory.h"
+#include "Core/Logger.h"
+#include "Core/THash.h"
 #include "Containers/DArray.h"
+#include "Containers/RingQueue.h"
+#include "Platform/Platform.h"
+#include "Platform/Atomic.h"
 
 typedef struct registered_event
 {
     void* listener;
+    // 0 once unregistered, until the code's listeners are next compacted.
     PFN_on_event callback;
+    s32 priority;
+    // The slot the listener's handle refers to.
+    u32 slot;
 } registered_event;
 
 typedef struct event_code_entry
 {
+    u16 code;
+    // How many fires of the code are in progress. Listeners are only moved while this is 0.
+    u16 dispatchDepth;
+    // How many listeners at the front of events are in priority order. The rest were
+    // registered since the last compaction, which moves them into place.
+    u32 sortedCount;
+    // How many unregistered listeners are still held in events.
+    u32 tombstoneCount;
+    // The code's listeners, stored contiguously in the order they are called.
     registered_event* events;
 } event_code_entry;
 
-// This should be more than enough codes...
-#define MAX_MESSAGE_CODES 16384
+typedef struct listener_slot
+{
+    // Bumped each time the slot is freed, so stale handles to it are rejected.
+    u32 generation;
+    // While in use, the index of the listener's code in registered.
+    // While free, 1 + the index of the next free slot, or 0 at the end of the list.
+    u32 entryIndex;
+    // The listener's index in its code's events.
+    u32 eventIndex;
+    // Hash of the code, listener and callback, for the listener lookup.
+    u64 hash;
+} listener_slot;
+
+// The most distinct codes which can have listeners registered. This should be more than enough codes...
+#define MAX_REGISTERED_CODES 512
+
+// Slots in the code lookup table, kept at twice MAX_REGISTERED_CODES so probes stay short.
+#define CODE_TABLE_BITS 10
+#define CODE_TABLE_SIZE (1 << CODE_TABLE_BITS)
+
+// The smallest the listener lookup is ever made. Must be a power of 2.
+#define MIN_LISTENER_LOOKUP_CAPACITY 64
+
+// A code's listeners are compacted once unregistered ones make up more than half of them,
+// so unregistering without ever firing cannot grow them without bound.
+#define MIN_TOMBSTONES_TO_COMPACT 16
+
+// The most events which can be posted between dispatches. Must be a power of 2.
+#define EVENT_QUEUE_CAPACITY 4096
+
+// The most distinct codes which can ever have coalescing turned on.
+#define MAX_COALESCED_CODES 64
+
+// How many queued events a dispatch takes off the queue at a time before firing them.
+#define EVENT_DISPATCH_WINDOW 64
+
+typedef struct queued_event
+{
+    u16 code;
+    // Which post of a coalesced code this is, or 0 if the code was not coalesced when posted.
+    u32 post;
+    void* sender;
+    event_context context;
+} queued_event;
+
+// A code which has had coalescing turned on. Never moved once added, as other threads post to it.
+typedef struct coalesced_code
+{
+    u16 code;
+    // The post number of the code's latest post.
+    u32 latestPost;
+} coalesced_code;
+
+// Event tracing's records. Only allocated once tracing is first turned on.
+typedef struct event_trace
+{
+    // The frame in progress, indexed like registered.
+    event_trace_stats current[MAX_REGISTERED_CODES];
+    // Each code fired in the last finished frame, the costliest first.
+    event_trace_stats lastFrame[MAX_REGISTERED_CODES];
+    u32 lastFrameCount;
+    // Totals since the last summary was logged, indexed like registered.
+    event_trace_stats summary[MAX_REGISTERED_CODES];
+    u32 summaryFrameCount;
+    f64 summaryStartTime;
+} event_trace;
 
 // State structure.
 typedef struct event_system_state
 {
-    // Lookup table for event codes.
-    event_code_entry registered[MAX_MESSAGE_CODES];
+    // Open-addressed lookup from an event code to 1 + its index in registered, or 0 if the slot is empty.
+    u16 codeTable[CODE_TABLE_SIZE];
+    // Every code which has had a listener registered, densely packed.
+    event_code_entry registered[MAX_REGISTERED_CODES];
+    u32 registeredCount;
+    // One slot per registered listener, reused once it is unregistered. A darray.
+    listener_slot* slots;
+    // 1 + the index of the first free slot, or 0 if none are free.
+    u32 freeSlot;
+    // Open-addressed lookup from a listener's hash to 1 + its slot, or 0 if empty. Kept at most half full.
+    u32* listenerLookup;
+    u32 listenerLookupCapacity;
+    u32 listenerCount;
+    // Events posted since the last dispatch.
+    ring_queue queue;
+    // One bit per code, set when its posted events are coalesced.
+    u8 coalescedCodes[65536 / 8];
+    // Every code coalescing has been turned on for, even if since turned off.
+    coalesced_code coalesced[MAX_COALESCED_CODES];
+    u32 coalescedCount;
+    // Counts posts of coalesced codes, to number them.
+    u32 postCount;
+    b8 isTracing;
+    // The thread the system was initialized on, the only one allowed to touch the listeners.
+    u64 mainThreadId;
+    // Kept once allocated, even with tracing off, so turning it off inside a listener is safe.
+    event_trace* trace;
 } event_system_state;
 
 /**
@@ -28,13 +136,20 @@ typedef struct event_system_state
  */
 static event_system_state* statePtr;
 
+// Only posting is safe from other threads, such as from game update and render, which run as jobs.
+#define EVENT_ASSERT_MAIN_THREAD() TASSERT_DEBUG(PlatformThreadGetCurrentId() == statePtr->mainThreadId)
+
 void EventSystemInitialize(u64* memoryRequirements, void* state)
 {
-    *memoryRequirements = sizeof(event_system_state);
+    u64 queueMemoryRequirement = RingQueueMemoryRequirement(sizeof(queued_event), EVENT_QUEUE_CAPACITY);
+    *memoryRequirements = sizeof(event_system_state) + queueMemoryRequirement;
     if (state == 0) return;
 
-    TZeroMemory(state, sizeof(state));
+    TZeroMemory(state, *memoryRequirements);
     statePtr = state;
+    statePtr->slots = DArrayCreate(listener_slot);
+    statePtr->mainThreadId = PlatformThreadGetCurrentId();
+    RingQueueCreate(sizeof(queued_event), EVENT_QUEUE_CAPACITY, (u8*)state + sizeof(event_system_state), &statePtr->queue);
 }
 
 void EventSystemShutdown(void* state)
@@ -42,96 +157,684 @@ void EventSystemShutdown(void* state)
     if (statePtr)
     {
         // Free the events arrays. And objects pointed to should be destroyed on their own.
-        for (u16 i = 0; i < MAX_MESSAGE_CODES; i++)
+        for (u32 i = 0; i < statePtr->registeredCount; i++)
+        {
+            DArrayDestroy(statePtr->registered[i].events);
+            statePtr->registered[i].events = 0;
+        }
+        statePtr->registeredCount = 0;
+
+        DArrayDestroy(statePtr->slots);
+        statePtr->slots = 0;
+        if (statePtr->listenerLookup)
+        {
+            TFree(statePtr->listenerLookup, sizeof(u32) * statePtr->listenerLookupCapacity, MEMORY_TAG_ARRAY);
+            statePtr->listenerLookup = 0;
+        }
+        RingQueueDestroy(&statePtr->queue);
+        if (statePtr->trace)
         {
-            if (statePtr->registered[i].events != 0)
+            TFree(statePtr->trace, sizeof(event_trace), MEMORY_TAG_APPLICATION);
+            statePtr->trace = 0;
+        }
+    }
+
+    statePtr = 0;
+}
+
+TINLINE u32 CodeSlot(u16 code)
+{
+    // Fibonacci hashing spreads nearby codes across the table.
+    return ((u32)code * 2654435761U) >> (32 - CODE_TABLE_BITS);
+}
+
+/**
+ * Finds the entry for a code, or adds one if create is set.
+ * Returns 0 if the code has no entry and either create is not set or the registry is full.
+ */
+static event_code_entry* FindEntry(u16 code, b8 create)
+{
+    // The table is never more than half full, so there is always an empty slot to stop at.
+    u32 slot = CodeSlot(code);
+    while (statePtr->codeTable[slot] != 0)
+    {
+        event_code_entry* entry = &statePtr->registered[statePtr->codeTable[slot] - 1];
+        if (entry->code == code) return entry;
+        slot = (slot + 1) & (CODE_TABLE_SIZE - 1);
+    }
+
+    if (!create) return 0;
+
+    if (statePtr->registeredCount == MAX_REGISTERED_CODES)
+    {
+        TERROR("EventRegister - cannot register code %hu, as %u codes already have listeners.", code, MAX_REGISTERED_CODES);
+        return 0;
+    }
+
+    event_code_entry* entry = &statePtr->registered[statePtr->registeredCount++];
+    entry->code = code;
+    entry->events = DArrayCreate(registered_event);
+    statePtr->codeTable[slot] = (u16)statePtr->registeredCount;
+    return entry;
+}
+
+static u64 ListenerHash(u16 code, void* listener, PFN_on_event onEvent)
+{
+    struct
+    {
+        void* listener;
+        PFN_on_event callback;
+        u64 code;
+    } key = {listener, onEvent, code};
+    return Hash64(&key, sizeof(key), 0);
+}
+
+/**
+ * Finds the position in the listener lookup of the given registration.
+ * Returns the lookup's capacity if it is not registered.
+ */
+static u32 FindListener(u64 hash, u16 code, void* listener, PFN_on_event onEvent)
+{
+    u32 mask = statePtr->listenerLookupCapacity - 1;
+    for (u32 i = (u32)hash & mask; statePtr->listenerLookupCapacity && statePtr->listenerLookup[i]; i = (i + 1) & mask)
+    {
+        listener_slot* slot = &statePtr->slots[statePtr->listenerLookup[i] - 1];
+        if (slot->hash != hash) continue;
+
+        event_code_entry* entry = &statePtr->registered[slot->entryIndex];
+        registered_event* event = &entry->events[slot->eventIndex];
+        if (entry->code == code && event->listener == listener && event->callback == onEvent) return i;
+    }
+    return statePtr->listenerLookupCapacity;
+}
+
+static void InsertListenerLookup(u32 slotIndex)
+{
+    u32 mask = statePtr->listenerLookupCapacity - 1;
+    u32 i = (u32)statePtr->slots[slotIndex].hash & mask;
+    while (statePtr->listenerLookup[i])
+    {
+        i = (i + 1) & mask;
+    }
+    statePtr->listenerLookup[i] = slotIndex + 1;
+}
+
+// Grows the listener lookup if needed, so one more listener keeps it at most half full.
+static void ReserveListenerLookup()
+{
+    u32 oldCapacity = statePtr->listenerLookupCapacity;
+    if ((statePtr->listenerCount + 1) * 2 <= oldCapacity) return;
+
+    u32* oldLookup = statePtr->listenerLookup;
+    statePtr->listenerLookupCapacity = oldCapacity ? oldCapacity * 2 : MIN_LISTENER_LOOKUP_CAPACITY;
+    statePtr->listenerLookup = TAllocate(sizeof(u32) * statePtr->listenerLookupCapacity, MEMORY_TAG_ARRAY);
+    TZeroMemory(statePtr->listenerLookup, sizeof(u32) * statePtr->listenerLookupCapacity);
+
+    for (u32 i = 0; i < oldCapacity; i++)
+    {
+        if (oldLookup[i]) InsertListenerLookup(oldLookup[i] - 1);
+    }
+    if (oldLookup) TFree(oldLookup, sizeof(u32) * oldCapacity, MEMORY_TAG_ARRAY);
+}
+
+static void RemoveListenerLookup(u32 position)
+{
+    // Backward-shift deletion: pull later entries of the probe run into the hole, so finds never
+    // stop early at it. An entry can move back only as far as the slot it hashes to.
+    u32 mask = statePtr->listenerLookupCapacity - 1;
+    u32 hole = position;
+    for (u32 i = (position + 1) & mask; statePtr->listenerLookup[i]; i = (i + 1) & mask)
+    {
+        u32 home = (u32)statePtr->slots[statePtr->listenerLookup[i] - 1].hash & mask;
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            statePtr->listenerLookup[hole] = statePtr->listenerLookup[i];
+            hole = i;
+        }
+    }
+    statePtr->listenerLookup[hole] = 0;
+}
+
+/**
+ * Sorts listeners from the highest priority down, keeping those of equal priority in the order
+ * they were registered. A bottom-up merge sort, so registering many listeners in any order of
+ * priority costs O(n log n). Passes alternate between listeners and scratch, which must hold as
+ * many; whichever the last pass wrote to is returned.
+ */
+static registered_event* SortByPriority(registered_event* listeners, registered_event* scratch, u32 count)
+{
+    registered_event* from = listeners;
+    registered_event* to = scratch;
+    for (u32 width = 1; width < count; width *= 2)
+    {
+        for (u32 start = 0; start < count; start += 2 * width)
+        {
+            u32 middle = count - start > width ? start + width : count;
+            u32 end = count - middle > width ? middle + width : count;
+            u32 left = start;
+            u32 right = middle;
+            u32 out = start;
+            while (left < middle && right < end)
             {
-                DArrayDestroy(statePtr->registered[i].events);
-                statePtr->registered[i].events = 0;
+                // Ties are taken from the left, which was registered first.
+                if (from[right].priority > from[left].priority)
+                    to[out++] = from[right++];
+                else
+                    to[out++] = from[left++];
             }
+            while (left < middle) to[out++] = from[left++];
+            while (right < end) to[out++] = from[right++];
         }
+
+        registered_event* swap = from;
+        from = to;
+        to = swap;
     }
+    return from;
+}
 
-    statePtr = 0;
+/**
+ * Merges sorted newer listeners into the sortedCount listeners at the front of events, from the
+ * back, so events must have room for both. Newer must be held apart from events.
+ */
+static void MergeFromBack(registered_event* events, u32 sortedCount, const registered_event* newer, u32 newerCount)
+{
+    s64 older = (s64)sortedCount - 1;
+    s64 newest = (s64)newerCount - 1;
+    for (s64 out = (s64)sortedCount + newerCount - 1; newest >= 0; out--)
+    {
+        if (older >= 0 && events[older].priority < newer[newest].priority)
+            events[out] = events[older--];
+        else
+            events[out] = newer[newest--];
+    }
 }
 
-b8 EventRegister(u16 code, void* listener, PFN_on_event onEvent)
+/**
+ * Drops unregistered listeners from a code, and moves those registered since the last
+ * compaction into priority order. Must not be called while the code is being fired.
+ */
+static void CompactListeners(event_code_entry* entry)
 {
-    if (!statePtr) return false;
+    registered_event* events = entry->events;
+    u32 length = (u32)DArrayLength(events);
 
-    if (statePtr->registered[code].events == 0)
+    // Squeeze out the unregistered listeners, keeping the order of the rest.
+    u32 count = 0;
+    u32 sortedCount = 0;
+    for (u32 i = 0; i < length; i++)
     {
-        statePtr->registered[code].events = DArrayCreate(registered_event);
+        if (!events[i].callback) continue;
+        if (i < entry->sortedCount) sortedCount++;
+        events[count++] = events[i];
     }
 
-    u64 registeredCount = DArrayLength(statePtr->registered[code].events);
-    for (u64 i = 0; i < registeredCount; i++)
+    // Sort the newer listeners, then merge them in from the back, into the space they took up.
+    // On equal priorities, the older listener stays first.
+    registered_event* newer = events + sortedCount;
+    u32 newerCount = count - sortedCount;
+    if (newerCount)
     {
-        if (statePtr->registered[code].events[i].listener == listener)
+        // A single newer listener is already sorted, and only needs a copy to merge from.
+        registered_event single;
+        u64 scratchSize = sizeof(registered_event) * newerCount;
+        registered_event* scratch = newerCount > 1 ? TAllocate(scratchSize, MEMORY_TAG_ARRAY) : &single;
+        registered_event* sorted = SortByPriority(newer, scratch, newerCount);
+        if (sortedCount && events[sortedCount - 1].priority < sorted[0].priority)
+        {
+            // Merged from the scratch, as the merge writes over where the newer listeners are.
+            if (sorted != scratch) TCopyMemory(scratch, sorted, scratchSize);
+            MergeFromBack(events, sortedCount, scratch, newerCount);
+        }
+        else if (sorted != newer)
         {
-            // TODO: warn
-            return false;
+            TCopyMemory(newer, sorted, scratchSize);
         }
+        if (newerCount > 1) TFree(scratch, scratchSize, MEMORY_TAG_ARRAY);
+    }
+
+    DArrayLengthSet(events, count);
+    entry->sortedCount = count;
+    entry->tombstoneCount = 0;
+    for (u32 i = 0; i < count; i++)
+    {
+        statePtr->slots[events[i].slot].eventIndex = i;
+    }
+}
+
+TINLINE b8 NeedsCompaction(const event_code_entry* entry)
+{
+    return entry->dispatchDepth == 0 && (entry->tombstoneCount || entry->sortedCount < DArrayLength(entry->events));
+}
+
+// Unregisters the listener in a slot, leaving a tombstone in its code's listeners.
+static void RemoveListener(u32 slotIndex, u32 lookupPosition)
+{
+    listener_slot* slot = &statePtr->slots[slotIndex];
+    event_code_entry* entry = &statePtr->registered[slot->entryIndex];
+    entry->events[slot->eventIndex].callback = 0;
+    entry->tombstoneCount++;
+
+    RemoveListenerLookup(lookupPosition);
+    statePtr->listenerCount--;
+    slot->generation++;
+    slot->entryIndex = statePtr->freeSlot;
+    statePtr->freeSlot = slotIndex + 1;
+
+    u64 length = DArrayLength(entry->events);
+    if (entry->dispatchDepth == 0 && entry->tombstoneCount >= MIN_TOMBSTONES_TO_COMPACT && entry->tombstoneCount * 2 > length)
+    {
+        CompactListeners(entry);
+    }
+}
+
+event_handle EventRegisterPriority(u16 code, void* listener, PFN_on_event onEvent, s32 priority)
+{
+    if (!statePtr || !onEvent) return INVALID_EVENT_HANDLE;
+    EVENT_ASSERT_MAIN_THREAD();
+
+    u64 hash = ListenerHash(code, listener, onEvent);
+    if (FindListener(hash, code, listener, onEvent) != statePtr->listenerLookupCapacity)
+    {
+        TWARN("EventRegister - the listener and callback are already registered for code %hu.", code);
+        return INVALID_EVENT_HANDLE;
     }
 
-    // If at this point, no duplicate was found. Proceed with registration.
+    event_code_entry* entry = FindEntry(code, true);
+    if (!entry) return INVALID_EVENT_HANDLE;
+
+    u32 slotIndex;
+    if (statePtr->freeSlot)
+    {
+        slotIndex = statePtr->freeSlot - 1;
+        statePtr->freeSlot = statePtr->slots[slotIndex].entryIndex;
+    }
+    else
+    {
+        slotIndex = (u32)DArrayLength(statePtr->slots);
+        listener_slot newSlot = {0};
+        DArrayPush(statePtr->slots, newSlot);
+    }
+
+    // Append the listener; the next compaction moves it into place. Until then it stays
+    // out of the sorted front, unless it already belongs at the end.
+    u32 length = (u32)DArrayLength(entry->events);
+    if (entry->sortedCount == length && (length == 0 || entry->events[length - 1].priority >= priority))
+    {
+        entry->sortedCount++;
+    }
     registered_event event;
     event.listener = listener;
     event.callback = onEvent;
-    DArrayPush(statePtr->registered[code].events, event);
+    event.priority = priority;
+    event.slot = slotIndex;
+    DArrayPush(entry->events, event);
 
-    return true;
+    listener_slot* slot = &statePtr->slots[slotIndex];
+    slot->entryIndex = (u32)(entry - statePtr->registered);
+    slot->eventIndex = length;
+    slot->hash = hash;
+
+    ReserveListenerLookup();
+    InsertListenerLookup(slotIndex);
+    statePtr->listenerCount++;
+
+    return ((u64)slot->generation << 32) | (slotIndex + 1);
+}
+
+b8 EventRegister(u16 code, void* listener, PFN_on_event onEvent)
+{
+    return EventRegisterPriority(code, listener, onEvent, EVENT_PRIORITY_DEFAULT) != INVALID_EVENT_HANDLE;
 }
 
 b8 EventUnregister(u16 code, void* listener, PFN_on_event onEvent)
 {
     if (!statePtr) return false;
+    EVENT_ASSERT_MAIN_THREAD();
 
-    // On nothing is registered for the code, boot out.
-    if (statePtr->registered[code].events == 0)
+    u32 position = FindListener(ListenerHash(code, listener, onEvent), code, listener, onEvent);
+    if (position == statePtr->listenerLookupCapacity)
     {
-        // TODO: warn
+        // Not found.
         return false;
     }
 
-    u64 registeredCount = DArrayLength(statePtr->registered[code].events);
-    for (u64 i = 0; i < registeredCount; i++)
+    RemoveListener(statePtr->listenerLookup[position] - 1, position);
+    return true;
+}
+
+b8 EventUnregisterHandle(event_handle handle)
+{
+    if (!statePtr || handle == INVALID_EVENT_HANDLE) return false;
+    EVENT_ASSERT_MAIN_THREAD();
+
+    u32 slotIndex = (u32)(handle & 0xFFFFFFFF) - 1;
+    if (slotIndex >= DArrayLength(statePtr->slots)) return false;
+
+    // A stale handle, whose slot has since been freed or reused.
+    listener_slot* slot = &statePtr->slots[slotIndex];
+    if (slot->generation != (u32)(handle >> 32)) return false;
+
+    u32 mask = statePtr->listenerLookupCapacity - 1;
+    u32 position = (u32)slot->hash & mask;
+    while (statePtr->listenerLookup[position] != slotIndex + 1)
     {
-        registered_event e = statePtr->registered[code].events[i];
-        if (e.listener == listener && e.callback == onEvent)
-        {
-            // Found one, remove it
-            registered_event poppedEvent;
-            DArrayPopAt(statePtr->registered[code].events, i, &poppedEvent);
-            return true;
-        }
+        position = (position + 1) & mask;
     }
 
-    // Not found.
-    return false;
+    RemoveListener(slotIndex, position);
+    return true;
 }
 
 b8 EventFire(u16 code, void* sender, event_context context)
 {
     if (!statePtr) return false;
+    EVENT_ASSERT_MAIN_THREAD();
 
     // If nothing is registered for the code, boot out.
-    if (statePtr->registered[code].events == 0)
+    event_code_entry* entry = FindEntry(code, false);
+    if (!entry)
     {
         return false;
     }
 
-    u64 registeredCount = DArrayLength(statePtr->registered[code].events);
-    for (u64 i = 0; i < registeredCount; i++)
+    if (NeedsCompaction(entry)) CompactListeners(entry);
+
+    event_trace_stats* stats = 0;
+    if (statePtr->isTracing)
+    {
+        stats = &statePtr->trace->current[entry - statePtr->registered];
+        stats->fireCount++;
+    }
+
+    // Listeners registered by handlers are appended, past this count, so are left for the next fire.
+    // Those unregistered by handlers are left in place, as tombstones, until the fire finishes.
+    entry->dispatchDepth++;
+    b8 handled = false;
+    u64 registeredCount = DArrayLength(entry->events);
+    for (u64 i = 0; i < registeredCount && !handled; i++)
     {
-        registered_event e = statePtr->registered[code].events[i];
-        if (e.callback(code, sender, e.listener, context))
+        registered_event e = entry->events[i];
+        if (!e.callback) continue;
+
+        if (!stats)
         {
             // Message has been handled, do not send to other listeners.
-            return true;
+            handled = e.callback(code, sender, e.listener, context);
+            continue;
+        }
+
+        f64 start = PlatformGetAbsoluteTime();
+        handled = e.callback(code, sender, e.listener, context);
+        f64 elapsed = PlatformGetAbsoluteTime() - start;
+        stats->listenerTime += elapsed;
+        if (elapsed > stats->slowestListenerTime)
+        {
+            stats->slowestListenerTime = elapsed;
+            stats->slowestCallback = e.callback;
+            stats->slowestListener = e.listener;
+        }
+    }
+    entry->dispatchDepth--;
+
+    if (NeedsCompaction(entry)) CompactListeners(entry);
+
+    return handled;
+}
+
+TINLINE b8 IsCoalesced(u16 code)
+{
+    return (statePtr->coalescedCodes[code >> 3] >> (code & 7)) & 1;
+}
+
+static coalesced_code* FindCoalesced(u16 code)
+{
+    u32 count = AtomicLoad32(&statePtr->coalescedCount, ATOMIC_ACQUIRE);
+    for (u32 i = 0; i < count; i++)
+    {
+        if (statePtr->coalesced[i].code == code) return &statePtr->coalesced[i];
+    }
+    return 0;
+}
+
+// Whether post a came after post b. Post numbers wrap, so they are compared by their difference.
+TINLINE b8 IsLaterPost(u32 a, u32 b)
+{
+    return (s32)(a - b) > 0;
+}
+
+// Numbers a post of a coalesced code, and marks it as the code's latest.
+static u32 NumberCoalescedPost(u16 code)
+{
+    coalesced_code* entry = FindCoalesced(code);
+    if (!entry) return 0;
+
+    u32 post = AtomicFetchAdd32(&statePtr->postCount, 1, ATOMIC_RELAXED) + 1;
+    // Another thread may have posted the code since, so only ever move the latest forward.
+    u32 latest = AtomicLoad32(&entry->latestPost, ATOMIC_RELAXED);
+    while (IsLaterPost(post, latest) &&
+           !AtomicCompareExchange32(&entry->latestPost, &latest, post, ATOMIC_RELAXED, ATOMIC_RELAXED))
+    {
+    }
+    return post;
+}
+
+b8 EventPost(u16 code, void* sender, event_context context)
+{
+    if (!statePtr) return false;
+
+    queued_event* event = RingQueueBeginPush(&statePtr->queue);
+    if (!event) return false;
+
+    event->code = code;
+    event->post = IsCoalesced(code) ? NumberCoalescedPost(code) : 0;
+    event->sender = sender;
+    event->context = context;
+    RingQueueEndPush(&statePtr->queue, event);
+    return true;
+}
+
+// Whether a later post of the event's coalesced code had been made when the dispatch started.
+static b8 IsSuperseded(const queued_event* event, const u32* latestPosts, u32 coalescedCount)
+{
+    if (!event->post || !IsCoalesced(event->code)) return false;
+
+    coalesced_code* entry = FindCoalesced(event->code);
+    if (!entry) return false;
+
+    // Codes first coalesced during the dispatch have no latest post recorded.
+    u32 index = (u32)(entry - statePtr->coalesced);
+    return index < coalescedCount && IsLaterPost(latestPosts[index], event->post);
+}
+
+u32 EventDispatchQueued()
+{
+    if (!statePtr) return 0;
+    EVENT_ASSERT_MAIN_THREAD();
+
+    // Each coalesced code's latest post so far. Handlers' posts wait for the next dispatch, so
+    // must not supersede the events this one fires, or a code reposted every frame would never fire.
+    u32 coalescedCount = AtomicLoad32(&statePtr->coalescedCount, ATOMIC_ACQUIRE);
+    u32 latestPosts[MAX_COALESCED_CODES];
+    for (u32 i = 0; i < coalescedCount; i++)
+    {
+        latestPosts[i] = AtomicLoad32(&statePtr->coalesced[i].latestPost, ATOMIC_RELAXED);
+    }
+
+    // Take only what is queued now, a window at a time, so events posted by handlers wait for the next dispatch.
+    u64 remaining = RingQueueLength(&statePtr->queue);
+    queued_event window[EVENT_DISPATCH_WINDOW];
+    u32 firedCount = 0;
+    while (remaining)
+    {
+        u32 windowCount = 0;
+        while (windowCount < EVENT_DISPATCH_WINDOW && windowCount < remaining &&
+               RingQueuePop(&statePtr->queue, &window[windowCount]))
+        {
+            windowCount++;
+        }
+        if (!windowCount) break;
+        remaining -= windowCount;
+
+        for (u32 i = 0; i < windowCount; i++)
+        {
+            queued_event* event = &window[i];
+            if (IsSuperseded(event, latestPosts, coalescedCount)) continue;
+
+            EventFire(event->code, event->sender, event->context);
+            firedCount++;
+        }
+    }
+    return firedCount;
+}
+
+void EventSetCoalescing(u16 code, b8 coalesce)
+{
+    if (!statePtr) return;
+
+    if (coalesce)
+    {
+        if (!FindCoalesced(code))
+        {
+            if (statePtr->coalescedCount == MAX_COALESCED_CODES)
+            {
+                TWARN("EventSetCoalescing - cannot coalesce code %hu, as %u codes already have been.", code, MAX_COALESCED_CODES);
+                return;
+            }
+
+            // Filled in before it is counted, so threads posting the code never see it half written.
+            coalesced_code* entry = &statePtr->coalesced[statePtr->coalescedCount];
+            entry->code = code;
+            entry->latestPost = 0;
+            AtomicStore32(&statePtr->coalescedCount, statePtr->coalescedCount + 1, ATOMIC_RELEASE);
+        }
+        statePtr->coalescedCodes[code >> 3] |= (u8)(1 << (code & 7));
+    }
+    else
+    {
+        // The code keeps its entry, so threads posting it never see the entries move.
+        statePtr->coalescedCodes[code >> 3] &= (u8)~(1 << (code & 7));
+    }
+}
+
+void EventSetTracing(b8 enabled)
+{
+    if (!statePtr || statePtr->isTracing == enabled) return;
+    EVENT_ASSERT_MAIN_THREAD();
+
+    if (enabled)
+    {
+        if (!statePtr->trace)
+        {
+            statePtr->trace = TAllocate(sizeof(event_trace), MEMORY_TAG_APPLICATION);
+        }
+
+        // Start afresh, so nothing from an earlier session is counted.
+        TZeroMemory(statePtr->trace, sizeof(event_trace));
+        statePtr->trace->summaryStartTime = PlatformGetAbsoluteTime();
+    }
+    statePtr->isTracing = enabled;
+}
+
+// Keeps the larger of two slowest listeners in into.
+static void MergeSlowest(event_trace_stats* into, const event_trace_stats* from)
+{
+    if (from->slowestListenerTime > into->slowestListenerTime)
+    {
+        into->slowestListenerTime = from->slowestListenerTime;
+        into->slowestCallback = from->slowestCallback;
+        into->slowestListener = from->slowestListener;
+    }
+}
+
+// Sorts stats so the costliest code comes first. There are only ever a few codes.
+static void SortByListenerTime(event_trace_stats* stats, u32 count)
+{
+    for (u32 i = 1; i < count; i++)
+    {
+        event_trace_stats value = stats[i];
+        u32 j = i;
+        for (; j > 0 && stats[j - 1].listenerTime < value.listenerTime; j--)
+        {
+            stats[j] = stats[j - 1];
         }
+        stats[j] = value;
+    }
+}
+
+static void LogTraceSummary(event_trace* trace, f64 seconds)
+{
+    // Gather the codes fired since the last summary, costliest first.
+    u32 count = 0;
+    for (u32 i = 0; i < statePtr->registeredCount; i++)
+    {
+        if (trace->summary[i].fireCount == 0) continue;
+        trace->lastFrame[count] = trace->summary[i];
+        trace->lastFrame[count].code = statePtr->registered[i].code;
+        count++;
+    }
+
+    TDEBUG("Event trace: %u codes fired over %u frames in the last %.1fs.", count, trace->summaryFrameCount, seconds);
+    if (count == 0) return;
+
+    // The last frame's stats are rebuilt afterwards, so they can be borrowed for sorting.
+    SortByListenerTime(trace->lastFrame, count);
+    u32 shown = count < EVENT_TRACE_SUMMARY_CODES ? count : EVENT_TRACE_SUMMARY_CODES;
+    for (u32 i = 0; i < shown; i++)
+    {
+        event_trace_stats* stats = &trace->lastFrame[i];
+        TDEBUG("  code %u: %u fires, %.3fms in listeners (%.3fms/frame), slowest listener %.3fms (callback %p, instance %p).",
+               (u32)stats->code, stats->fireCount, stats->listenerTime * 1000.0,
+               stats->listenerTime * 1000.0 / trace->summaryFrameCount, stats->slowestListenerTime * 1000.0,
+               (void*)stats->slowestCallback, stats->slowestListener);
     }
+}
+
+void EventTraceEndFrame()
+{
+    if (!statePtr || !statePtr->isTracing) return;
+
+    event_trace* trace = statePtr->trace;
+    trace->summaryFrameCount++;
+    for (u32 i = 0; i < statePtr->registeredCount; i++)
+    {
+        event_trace_stats* current = &trace->current[i];
+        if (current->fireCount == 0) continue;
+
+        event_trace_stats* summary = &trace->summary[i];
+        summary->fireCount += current->fireCount;
+        summary->listenerTime += current->listenerTime;
+        MergeSlowest(summary, current);
+    }
+
+    f64 now = PlatformGetAbsoluteTime();
+    if (now - trace->summaryStartTime >= EVENT_TRACE_SUMMARY_INTERVAL)
+    {
+        LogTraceSummary(trace, now - trace->summaryStartTime);
+        TZeroMemory(trace->summary, sizeof(trace->summary));
+        trace->summaryFrameCount = 0;
+        trace->summaryStartTime = now;
+    }
+
+    // Publish the finished frame, and start the next one.
+    trace->lastFrameCount = 0;
+    for (u32 i = 0; i < statePtr->registeredCount; i++)
+    {
+        event_trace_stats* current = &trace->current[i];
+        if (current->fireCount == 0) continue;
+
+        current->code = statePtr->registered[i].code;
+        trace->lastFrame[trace->lastFrameCount++] = *current;
+        TZeroMemory(current, sizeof(event_trace_stats));
+    }
+    SortByListenerTime(trace->lastFrame, trace->lastFrameCount);
+}
+
+const event_trace_stats* EventTraceGetFrameStats(u32* outCount)
+{
+    *outCount = 0;
+    if (!statePtr || !statePtr->trace) return 0;
 
-    // Not found.
-    return false;
+    *outCount = statePtr->trace->lastFrameCount;
+    return statePtr->trace->lastFrame;
 }
\ No newline at end of file
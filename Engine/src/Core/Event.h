@@ -28,12 +28,22 @@ typedef struct event_context
 // Should return true if handled.
 typedef b8 (*PFN_on_event)(u16 code, void* sender, void* listenerInst, event_context data);
 
+// Identifies a registered listener, for EventUnregisterHandle.
+typedef u64 event_handle;
+
+// Never returned for a successful registration.
+#define INVALID_EVENT_HANDLE 0
+
+// The priority of listeners registered with EventRegister.
+#define EVENT_PRIORITY_DEFAULT 0
+
 void EventSystemInitialize(u64* memoryRequirements, void* state);
 void EventSystemShutdown(void* state);
 
 /**
- * Register to listen for when events are sent with the provided code. Events with duplicate
- * listener/callback combos will not be registered again and will cause this to return false.
+ * Register to listen for when events are sent with the provided code, at the default priority.
+ * Events with duplicate listener/callback combos will not be registered again and will cause
+ * this to return false. Must be called on the main thread.
  * @param code The event code to listen for.
  * @param listener A pointer to a listener instance. Can be 0/NULL.
  * @param onEvent The callback function pointer to be invoked when the event code is fired.
@@ -41,9 +51,24 @@ void EventSystemShutdown(void* state);
  */
 TAPI b8 EventRegister(u16 code, void* listener, PFN_on_event onEvent);
 
+/**
+ * Register to listen for when events are sent with the provided code. Listeners are called from
+ * the highest priority to the lowest, so higher priorities get the first chance to handle an
+ * event; those with equal priorities are called in the order they were registered. A listener
+ * registered while its code is being fired is first called on the next fire.
+ * Must be called on the main thread.
+ * @param code The event code to listen for.
+ * @param listener A pointer to a listener instance. Can be 0/NULL.
+ * @param onEvent The callback function pointer to be invoked when the event code is fired.
+ * @param priority The listener's priority, where EVENT_PRIORITY_DEFAULT suits most.
+ * @returns A handle to unregister the listener with, or INVALID_EVENT_HANDLE if it was already
+ * registered or the registry is full.
+ */
+TAPI event_handle EventRegisterPriority(u16 code, void* listener, PFN_on_event onEvent, s32 priority);
+
 /**
  * Unregister from listening for when events are sent with the provided code. If no matching
- * registration is found, this function returns false.
+ * registration is found, this function returns false. Must be called on the main thread.
  * @param code The event code to stop listening for.
  * @param listener A pointer to a listener instance. Can be 0/NULL.
  * @param onEvent The callback function pointer to be unregistered.
@@ -51,9 +76,19 @@ TAPI b8 EventRegister(u16 code, void* listener, PFN_on_event onEvent);
  */
 TAPI b8 EventUnregister(u16 code, void* listener, PFN_on_event onEvent);
 
+/**
+ * Unregisters the listener a handle refers to, in constant time. A listener unregistered
+ * while its code is being fired is not called for the rest of that fire.
+ * Must be called on the main thread.
+ * @param handle The handle returned by EventRegisterPriority.
+ * @returns true if the listener was unregistered; false if the handle was invalid or already used.
+ */
+TAPI b8 EventUnregisterHandle(event_handle handle);
+
 /**
  * Fires an event to listeners of the given code. If an event handler returns 
  * true, the event is considered handled and is not passed on to any more listeners.
+ * Must be called on the main thread; other threads should use EventPost.
  * @param code The event code to fire.
  * @param sender A pointer to the sender. Can be 0/NULL.
  * @param data The event data.
@@ -61,6 +96,77 @@ TAPI b8 EventUnregister(u16 code, void* listener, PFN_on_event onEvent);
  */
 TAPI b8 EventFire(u16 code, void* sender, event_context context);
 
+/**
+ * Queues an event to be fired by the next call to EventDispatchQueued, rather than
+ * right away. Unlike the other event functions, this is safe to call from any thread.
+ * @param code The event code to post.
+ * @param sender A pointer to the sender. Can be 0/NULL. Must stay valid until dispatched.
+ * @param context The event data.
+ * @returns true if the event was queued; false if the queue is full and it was dropped.
+ */
+TAPI b8 EventPost(u16 code, void* sender, event_context context);
+
+/**
+ * Fires every event posted before this call, in the order they were posted. Events posted
+ * while dispatching wait for the next call. Call once per frame from the main thread.
+ * @returns The number of events fired.
+ */
+TAPI u32 EventDispatchQueued();
+
+/**
+ * Sets whether posted events with the given code are coalesced. Of the coalesced events
+ * queued at each dispatch, only the latest one per code is fired, so for example a burst
+ * of mouse moves is delivered as just the final position.
+ * @param code The event code.
+ * @param coalesce True to coalesce events with the code; false to deliver every one.
+ */
+TAPI void EventSetCoalescing(u16 code, b8 coalesce);
+
+// How often, in seconds, event tracing logs a summary of the codes which took the longest.
+#define EVENT_TRACE_SUMMARY_INTERVAL 5.0
+
+// How many codes each event tracing summary lists.
+#define EVENT_TRACE_SUMMARY_CODES 5
+
+// What event tracing recorded for a code over a frame.
+typedef struct event_trace_stats
+{
+    u16 code;
+    // How many times the code was fired.
+    u32 fireCount;
+    // The total time spent in the code's listeners, in seconds. This includes any
+    // events the listeners fired themselves.
+    f64 listenerTime;
+    // The longest a single listener took, in seconds, and which listener that was.
+    f64 slowestListenerTime;
+    PFN_on_event slowestCallback;
+    void* slowestListener;
+} event_trace_stats;
+
+/**
+ * Turns event tracing on or off. While on, every fire of a code with listeners is timed,
+ * listener by listener, and a summary of the costliest codes is logged every
+ * EVENT_TRACE_SUMMARY_INTERVAL seconds. Off by default, when it costs nothing.
+ * Must be called on the main thread.
+ * @param enabled True to trace events; false to stop.
+ */
+TAPI void EventSetTracing(b8 enabled);
+
+/**
+ * Finishes the frame being traced, making its stats available through EventTraceGetFrameStats
+ * and logging a summary if one is due. Call once per frame from the main thread. Does nothing
+ * while tracing is off.
+ */
+TAPI void EventTraceEndFrame();
+
+/**
+ * Gets what event tracing recorded for the most recently finished frame.
+ * @param outCount A pointer to hold the number of codes fired in the frame.
+ * @returns The stats of each code fired, the costliest first, valid until the next frame
+ * finishes; or 0 if tracing has never been turned on.
+ */
+TAPI const event_trace_stats* EventTraceGetFrameStats(u32* outCount);
+
 // System internal event codes. Application should use codes beyond 255.
 typedef enum system_event_code
 {
@@ -0,0 +1,147 @@
+#include "Core/FrameStats.h"
+#include "Core/Logger.h"
+#include "Core/TMemory.h"
+#include "Core/TString.h"
+#include "Platform/Platform.h"
+
+typedef struct frame_stats_state
+{
+    u64 frameCount;
+    // The latest FRAME_STATS_WINDOW times of each stat, written round and round.
+    f64 samples[FRAME_STAT_MAX][FRAME_STATS_WINDOW];
+    u64 histogram[FRAME_STAT_MAX][FRAME_STATS_HISTOGRAM_BUCKETS];
+    f64 logInterval;
+    f64 lastLogTime;
+} frame_stats_state;
+
+static frame_stats_state* statePtr;
+
+static const char* statNames[FRAME_STAT_MAX] = {"frame", "update", "render", "present", "pacing error"};
+
+void FrameStatsInitialize(u64* memoryRequirement, void* state)
+{
+    *memoryRequirement = sizeof(frame_stats_state);
+    if (state == 0) return;
+
+    TZeroMemory(state, sizeof(frame_stats_state));
+    statePtr = state;
+}
+
+void FrameStatsShutdown(void* state)
+{
+    statePtr = 0;
+}
+
+// Sorts times in ascending order. Shell sort, since it needs no extra memory and the window is small.
+static void SortTimes(f64* times, u32 count)
+{
+    static const u32 gaps[] = {301, 132, 57, 23, 10, 4, 1};
+    for (u32 g = 0; g < sizeof(gaps) / sizeof(gaps[0]); g++)
+    {
+        u32 gap = gaps[g];
+        for (u32 i = gap; i < count; i++)
+        {
+            f64 value = times[i];
+            u32 j = i;
+            for (; j >= gap && times[j - gap] > value; j -= gap)
+            {
+                times[j] = times[j - gap];
+            }
+            times[j] = value;
+        }
+    }
+}
+
+// The nearest-rank percentile of sorted times.
+TINLINE f64 Percentile(const f64* sorted, u32 count, u32 percent)
+{
+    u32 rank = (count * percent + 99) / 100;
+    return sorted[rank ? rank - 1 : 0];
+}
+
+void FrameStatsGetSummary(frame_stat stat, frame_stat_summary* outSummary)
+{
+    TZeroMemory(outSummary, sizeof(frame_stat_summary));
+    if (!statePtr || statePtr->frameCount == 0) return;
+
+    u32 count = statePtr->frameCount < FRAME_STATS_WINDOW ? (u32)statePtr->frameCount : FRAME_STATS_WINDOW;
+    f64 sorted[FRAME_STATS_WINDOW];
+    f64 total = 0;
+    for (u32 i = 0; i < count; i++)
+    {
+        sorted[i] = statePtr->samples[stat][i];
+        total += sorted[i];
+    }
+    SortTimes(sorted, count);
+
+    outSummary->sampleCount = count;
+    outSummary->average = total / count;
+    outSummary->p50 = Percentile(sorted, count, 50);
+    outSummary->p95 = Percentile(sorted, count, 95);
+    outSummary->p99 = Percentile(sorted, count, 99);
+    outSummary->max = sorted[count - 1];
+}
+
+static void LogSummary()
+{
+    frame_stat_summary summaries[FRAME_STAT_MAX];
+    for (u32 i = 0; i < FRAME_STAT_MAX; i++)
+    {
+        FrameStatsGetSummary(i, &summaries[i]);
+    }
+
+    // One line, so it is easy to pick out of the log.
+    char line[512];
+    u64 length = 0;
+    for (u32 i = 0; i < FRAME_STAT_MAX && length < sizeof(line); i++)
+    {
+        length += StringFormatN(line + length, sizeof(line) - length, "%s%s %.2f/%.2f/%.2f/%.2f", i ? ", " : "", statNames[i],
+                                summaries[i].p50 * 1000.0, summaries[i].p95 * 1000.0, summaries[i].p99 * 1000.0, summaries[i].max * 1000.0);
+    }
+    TINFO("Frame times over %u frames (ms, p50/p95/p99/max): %s", summaries[0].sampleCount, line);
+}
+
+void FrameStatsRecord(const f64 times[FRAME_STAT_MAX])
+{
+    if (!statePtr) return;
+
+    u32 slot = (u32)(statePtr->frameCount % FRAME_STATS_WINDOW);
+    for (u32 i = 0; i < FRAME_STAT_MAX; i++)
+    {
+        f64 time = times[i] > 0 ? times[i] : 0;
+        statePtr->samples[i][slot] = time;
+
+        u32 bucket = FRAME_STATS_HISTOGRAM_BUCKETS - 1;
+        if (time < FRAME_STATS_HISTOGRAM_BUCKET_SECONDS * bucket) bucket = (u32)(time / FRAME_STATS_HISTOGRAM_BUCKET_SECONDS);
+        statePtr->histogram[i][bucket]++;
+    }
+    statePtr->frameCount++;
+
+    if (statePtr->logInterval > 0)
+    {
+        f64 now = PlatformGetAbsoluteTime();
+        if (now - statePtr->lastLogTime >= statePtr->logInterval)
+        {
+            statePtr->lastLogTime = now;
+            LogSummary();
+        }
+    }
+}
+
+const u64* FrameStatsGetHistogram(frame_stat stat)
+{
+    return statePtr ? statePtr->histogram[stat] : 0;
+}
+
+u64 FrameStatsGetFrameCount()
+{
+    return statePtr ? statePtr->frameCount : 0;
+}
+
+void FrameStatsSetLogInterval(f64 seconds)
+{
+    if (!statePtr) return;
+
+    statePtr->logInterval = seconds;
+    statePtr->lastLogTime = PlatformGetAbsoluteTime();
+}
\ No newline at end of file
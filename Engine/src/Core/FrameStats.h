@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Frame timing statistics.
+
+The application records how long each frame took, along with its update,
+render and present stages. The latest FRAME_STATS_WINDOW frames are kept, to
+summarize as percentiles, since averages hide the occasional long frame. A
+histogram of every frame since startup is kept as well.
+*/
+
+// The frames kept for percentiles.
+#define FRAME_STATS_WINDOW 512
+
+// Histogram buckets each cover this many seconds, from 0. The last bucket also
+// holds every time beyond the others.
+#define FRAME_STATS_HISTOGRAM_BUCKET_SECONDS 0.0005
+#define FRAME_STATS_HISTOGRAM_BUCKETS 64
+
+// What is timed each frame.
+typedef enum frame_stat
+{
+    // From the start of one frame to the start of the next.
+    FRAME_STAT_FRAME,
+    // The game's update.
+    FRAME_STAT_UPDATE,
+    // The game's render, which builds what is to be drawn.
+    FRAME_STAT_RENDER,
+    // Drawing and presenting the frame.
+    FRAME_STAT_PRESENT,
+    // How late the frame started compared to when the frame limiter meant it to. 0 when unlimited.
+    FRAME_STAT_PACING_ERROR,
+    FRAME_STAT_MAX
+} frame_stat;
+
+// A summary of the frames in the window. Times are in seconds.
+typedef struct frame_stat_summary
+{
+    // The number of frames summarized; at most FRAME_STATS_WINDOW.
+    u32 sampleCount;
+    f64 average;
+    f64 p50;
+    f64 p95;
+    f64 p99;
+    f64 max;
+} frame_stat_summary;
+
+/**
+ * @brief Initializes frame statistics. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state.
+ *
+ * @param memoryRequirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ */
+void FrameStatsInitialize(u64* memoryRequirement, void* state);
+
+/**
+ * @brief Shuts down frame statistics.
+ *
+ * @param state A pointer to the system's state.
+ */
+void FrameStatsShutdown(void* state);
+
+/**
+ * @brief Records a frame. Logs a summary too, if one is due.
+ *
+ * @param times How long each frame_stat took, in seconds, indexed by frame_stat.
+ */
+TAPI void FrameStatsRecord(const f64 times[FRAME_STAT_MAX]);
+
+/**
+ * @brief Summarizes one of the times over the frames in the window.
+ *
+ * @param stat The time to summarize.
+ * @param outSummary A pointer to hold the summary. Zeroed if no frames have been recorded.
+ */
+TAPI void FrameStatsGetSummary(frame_stat stat, frame_stat_summary* outSummary);
+
+/**
+ * @brief Gets the histogram of one of the times, over every frame recorded.
+ *
+ * @param stat The time to get the histogram of.
+ * @return const u64* FRAME_STATS_HISTOGRAM_BUCKETS counts, one per bucket; or 0 if not initialized.
+ */
+TAPI const u64* FrameStatsGetHistogram(frame_stat stat);
+
+// Gets the number of frames recorded since startup.
+TAPI u64 FrameStatsGetFrameCount();
+
+/**
+ * @brief Sets how often a summary of the frame times is logged.
+ *
+ * @param seconds The time between summaries, or 0 to stop logging them. 0 by default.
+ */
+TAPI void FrameStatsSetLogInterval(f64 seconds);
\ No newline at end of file
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_INPUT
+
 #include "Core/Input.h"
 #include "Core/Event.h"
 #include "Core/TMemory.h"
@@ -83,10 +85,10 @@ void InputProcessKey(keys key, b8 pressed)
             TINFO("Right control %s.", pressed ? "pressed" : "released");
         }
 
-        // Fire off an event for immediate processing.
+        // Queue an event, fired with the rest at the end of the pump.
         event_context context;
         context.data.u16[0] = key;
-        EventFire(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
+        EventPost(pressed ? EVENT_CODE_KEY_PRESSED : EVENT_CODE_KEY_RELEASED, 0, context);
     }
 }
 
@@ -97,10 +99,10 @@ void InputProcessButton(buttons button, b8 pressed)
     {
         statePtr->mouseCurrent.buttons[button] = pressed;
 
-        // Fire the event.
+        // Queue the event.
         event_context context;
         context.data.u16[0] = button;
-        EventFire(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
+        EventPost(pressed ? EVENT_CODE_BUTTON_PRESSED : EVENT_CODE_BUTTON_RELEASED, 0, context);
     }
 }
 
@@ -116,11 +118,11 @@ void InputProcessMouseMove(s16 x, s16 y)
         statePtr->mouseCurrent.x = x;
         statePtr->mouseCurrent.y = y;
 
-        // Fire the event.
+        // Queue the event. Moves are coalesced, so only the latest per frame is fired.
         event_context context;
         context.data.u16[0] = x;
         context.data.u16[1] = y;
-        EventFire(EVENT_CODE_MOUSE_MOVED, 0, context);
+        EventPost(EVENT_CODE_MOUSE_MOVED, 0, context);
     }
 }
 
@@ -128,10 +130,10 @@ void InputProcessMouseWheel(s8 zDelta)
 {
     // NOTE: no internal state to update.
 
-    // Fire the event.
+    // Queue the event.
     event_context context;
     context.data.u8[0] = zDelta;
-    EventFire(EVENT_CODE_MOUSE_WHEEL, 0, context);
+    EventPost(EVENT_CODE_MOUSE_WHEEL, 0, context);
 }
 
 // KEYBOARD INPUT
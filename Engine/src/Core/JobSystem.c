@@ -0,0 +1,650 @@
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include "Core/TMemory.h"
+#include "Core/TString.h"
+#include "Core/Profiler.h"
+#include "Containers/RingQueue.h"
+#include "Platform/Platform.h"
+#include "Platform/Atomic.h"
+
+// Jobs each worker's deque can hold, per priority. Must be a power of 2.
+#define JOB_DEQUE_CAPACITY 1024
+// Jobs the shared queue for non-worker threads can hold, per priority. Must be a power of 2.
+#define JOB_SHARED_QUEUE_CAPACITY 1024
+// Times an idle worker looks for work before going to sleep.
+#define JOB_IDLE_SPIN_COUNT 256
+// Longest an idle worker sleeps before looking again, as a safety net against missed wakeups.
+#define JOB_IDLE_TIMEOUT_MS 10
+// Times a waiting thread spins before yielding its time slice.
+#define JOB_WAIT_SPIN_COUNT 64
+
+typedef struct job
+{
+    PFN_job_entry entry;
+    void* params;
+    job_counter* counter;
+} job;
+
+/*
+Chase-Lev work-stealing deque of fixed capacity. The owning worker pushes and
+pops at the bottom; any other thread may steal from the top. Only taking the
+last job, or stealing, needs a compare-and-swap.
+*/
+typedef struct job_deque
+{
+    // Cursors are signed in spirit (bottom can briefly drop below top), but stored
+    // as u64 for the atomic wrappers.
+    u64 top;
+    u8 padding0[56];
+    u64 bottom;
+    u8 padding1[56];
+    job jobs[JOB_DEQUE_CAPACITY];
+} job_deque;
+
+#if JOB_FIBERS_ENABLED
+// What the fiber being switched to must do with the one switched away from.
+// It can only be done once the old fiber's context has been saved.
+typedef enum fiber_action {
+    FIBER_ACTION_NONE,
+    // Return it to the pool.
+    FIBER_ACTION_FREE,
+    // Park it until the counter it waits on reaches zero.
+    FIBER_ACTION_PARK
+} fiber_action;
+
+typedef struct job_fiber
+{
+    platform_fiber context;
+    // The counter this fiber is parked on.
+    job_counter* waitCounter;
+    // The fiber's stack, with a guard page below it. 0 for a thread's own fiber.
+    void* stack;
+} job_fiber;
+#endif
+
+typedef struct job_worker
+{
+    job_deque deques[JOB_PRIORITY_MAX];
+    platform_thread thread;
+#if JOB_FIBERS_ENABLED
+    // The worker thread's own fiber, which it starts and finishes on.
+    job_fiber threadFiber;
+    // The fiber currently running on this worker, or 0 if it has never switched.
+    job_fiber* currentFiber;
+    fiber_action pendingAction;
+    job_fiber* previousFiber;
+#endif
+} job_worker;
+
+typedef struct job_system_state
+{
+    u32 workerCount;
+    u8 isRunning;
+    // Workers which are asleep, waiting on workAvailable.
+    u32 sleepingCount;
+    platform_semaphore workAvailable;
+    // Jobs submitted by threads which are not workers.
+    ring_queue sharedQueues[JOB_PRIORITY_MAX];
+    job_worker* workers;
+#if JOB_FIBERS_ENABLED
+    // 0 when there are no worker threads to run fibers on.
+    u32 fiberCount;
+    job_fiber* fibers;
+    // Pointers to fibers which are ready to run a worker loop.
+    ring_queue freeFibers;
+    // Pointers to fibers parked on a counter.
+    ring_queue waitingFibers;
+#endif
+} job_system_state;
+
+static job_system_state* statePtr;
+
+// The calling thread's worker index, or -1 if it is not a worker.
+static _Thread_local s32 workerIndex = -1;
+// Seed for picking which worker to steal from first.
+static _Thread_local u32 stealSeed = 0;
+
+// A fiber can resume on a different thread, yet compilers assume a function stays on
+// one and may reuse a thread-local address worked out before the switch. Everything
+// which can run across a switch reads the worker index through here instead.
+static TNOINLINE s32 GetWorkerIndex()
+{
+    return workerIndex;
+}
+
+static TNOINLINE job_worker* CurrentWorker()
+{
+    s32 index = workerIndex;
+    return index >= 0 && statePtr ? &statePtr->workers[index] : 0;
+}
+
+// Each field is written and read atomically, since a thief may read a slot the
+// owner is about to reuse; the thief's compare-and-swap then fails and the copy is discarded.
+TINLINE void JobStore(job* slot, const job* value)
+{
+    AtomicStorePtr((void**)&slot->entry, (void*)value->entry, ATOMIC_RELAXED);
+    AtomicStorePtr(&slot->params, value->params, ATOMIC_RELAXED);
+    AtomicStorePtr((void**)&slot->counter, value->counter, ATOMIC_RELAXED);
+}
+
+TINLINE void JobLoad(job* slot, job* outValue)
+{
+    outValue->entry = (PFN_job_entry)AtomicLoadPtr((void**)&slot->entry, ATOMIC_RELAXED);
+    outValue->params = AtomicLoadPtr(&slot->params, ATOMIC_RELAXED);
+    outValue->counter = AtomicLoadPtr((void**)&slot->counter, ATOMIC_RELAXED);
+}
+
+static b8 DequePush(job_deque* deque, const job* value)
+{
+    s64 bottom = (s64)AtomicLoad64(&deque->bottom, ATOMIC_RELAXED);
+    s64 top = (s64)AtomicLoad64(&deque->top, ATOMIC_ACQUIRE);
+    if (bottom - top >= JOB_DEQUE_CAPACITY) return false;
+
+    JobStore(&deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)], value);
+    // The job must be visible before thieves can see the new bottom.
+    AtomicThreadFence(ATOMIC_RELEASE);
+    AtomicStore64(&deque->bottom, (u64)(bottom + 1), ATOMIC_RELAXED);
+    return true;
+}
+
+static b8 DequePop(job_deque* deque, job* outValue)
+{
+    s64 bottom = (s64)AtomicLoad64(&deque->bottom, ATOMIC_RELAXED) - 1;
+    AtomicStore64(&deque->bottom, (u64)bottom, ATOMIC_RELAXED);
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+    s64 top = (s64)AtomicLoad64(&deque->top, ATOMIC_RELAXED);
+
+    if (top > bottom)
+    {
+        // Empty.
+        AtomicStore64(&deque->bottom, (u64)(bottom + 1), ATOMIC_RELAXED);
+        return false;
+    }
+
+    JobLoad(&deque->jobs[bottom & (JOB_DEQUE_CAPACITY - 1)], outValue);
+    if (top != bottom) return true;
+
+    // This was the last job, so thieves may be after it too.
+    u64 expected = (u64)top;
+    b8 won = AtomicCompareExchange64(&deque->top, &expected, (u64)(top + 1), ATOMIC_SEQ_CST, ATOMIC_RELAXED);
+    AtomicStore64(&deque->bottom, (u64)(bottom + 1), ATOMIC_RELAXED);
+    return won;
+}
+
+static b8 DequeSteal(job_deque* deque, job* outValue)
+{
+    s64 top = (s64)AtomicLoad64(&deque->top, ATOMIC_ACQUIRE);
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+    s64 bottom = (s64)AtomicLoad64(&deque->bottom, ATOMIC_ACQUIRE);
+    if (top >= bottom) return false;
+
+    JobLoad(&deque->jobs[top & (JOB_DEQUE_CAPACITY - 1)], outValue);
+    u64 expected = (u64)top;
+    return AtomicCompareExchange64(&deque->top, &expected, (u64)(top + 1), ATOMIC_SEQ_CST, ATOMIC_RELAXED);
+}
+
+TINLINE u32 NextRandom(u32* seed)
+{
+    // xorshift32
+    u32 x = *seed ? *seed : 0x9E3779B9U;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+// Looks for a job to run, highest priority first: the caller's own deque, then the
+// shared queue, then the other workers' deques starting from a random one.
+static b8 FindJob(s32 self, job* outJob)
+{
+    u32 workerCount = statePtr->workerCount;
+    for (u32 priority = 0; priority < JOB_PRIORITY_MAX; priority++)
+    {
+        if (self >= 0 && DequePop(&statePtr->workers[self].deques[priority], outJob)) return true;
+        if (RingQueuePop(&statePtr->sharedQueues[priority], outJob)) return true;
+
+        u32 start = NextRandom(&stealSeed) % workerCount;
+        for (u32 i = 0; i < workerCount; i++)
+        {
+            u32 victim = (start + i) % workerCount;
+            if ((s32)victim == self) continue;
+            if (DequeSteal(&statePtr->workers[victim].deques[priority], outJob)) return true;
+        }
+    }
+    return false;
+}
+
+static void WakeWorkers(u32 jobCount);
+
+static void RunJob(const job* j)
+{
+    j->entry(j->params);
+    if (j->counter)
+    {
+        // Release, so whoever sees the counter reach zero also sees the job's results.
+        u32 remaining = AtomicFetchSub32(&j->counter->value, 1, ATOMIC_RELEASE) - 1;
+#if JOB_FIBERS_ENABLED
+        // A parked fiber may have been waiting on this; make sure a worker is awake to resume it.
+        if (remaining == 0 && statePtr && statePtr->fiberCount && RingQueueLength(&statePtr->waitingFibers))
+        {
+            WakeWorkers(1);
+        }
+#endif
+    }
+}
+
+static void WakeWorkers(u32 jobCount)
+{
+    // Pairs with the sleepingCount increment in WorkerThread: either the worker sees
+    // the new jobs when it looks again, or this sees it asleep.
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+    u32 sleeping = AtomicLoad32(&statePtr->sleepingCount, ATOMIC_RELAXED);
+    if (sleeping)
+    {
+        PlatformSemaphoreSignal(&statePtr->workAvailable, jobCount < sleeping ? jobCount : sleeping);
+    }
+}
+
+#if JOB_FIBERS_ENABLED
+// Runs the action requested by whoever switched to the calling fiber.
+static void FinishSwitch()
+{
+    job_worker* worker = CurrentWorker();
+    job_fiber* previous = worker->previousFiber;
+
+    switch (worker->pendingAction)
+    {
+        case FIBER_ACTION_FREE:
+            RingQueuePush(&statePtr->freeFibers, &previous);
+            break;
+        case FIBER_ACTION_PARK:
+            RingQueuePush(&statePtr->waitingFibers, &previous);
+            break;
+        default:
+            break;
+    }
+    worker->pendingAction = FIBER_ACTION_NONE;
+    worker->previousFiber = 0;
+}
+
+// Switches the calling worker to another fiber. Returns once something switches back,
+// which may be on another thread.
+static void SwitchToFiber(job_fiber* target, fiber_action action)
+{
+    job_worker* worker = CurrentWorker();
+    job_fiber* self = worker->currentFiber;
+    worker->pendingAction = action;
+    worker->previousFiber = self;
+    worker->currentFiber = target;
+    PlatformFiberSwitch(&self->context, &target->context);
+    FinishSwitch();
+}
+
+// Takes a parked fiber whose counter has reached zero, if there is one. Each parked
+// fiber is looked at once; those still waiting go back in the queue.
+static b8 FindReadyFiber(job_fiber** outFiber)
+{
+    u64 waitingCount = RingQueueLength(&statePtr->waitingFibers);
+    for (u64 i = 0; i < waitingCount; i++)
+    {
+        job_fiber* fiber;
+        if (!RingQueuePop(&statePtr->waitingFibers, &fiber)) return false;
+        if (JobIsDone(fiber->waitCounter))
+        {
+            *outFiber = fiber;
+            return true;
+        }
+        RingQueuePush(&statePtr->waitingFibers, &fiber);
+    }
+    return false;
+}
+#endif
+
+// Whether anything is still parked, and so needs a worker to resume it eventually.
+static b8 HasParkedWork()
+{
+#if JOB_FIBERS_ENABLED
+    return statePtr->fiberCount && RingQueueLength(&statePtr->waitingFibers) > 0;
+#else
+    return false;
+#endif
+}
+
+// Runs jobs until the job system shuts down and nothing is left parked.
+static void WorkerLoop()
+{
+    job j;
+    u32 idleSpins = 0;
+    for (;;)
+    {
+#if JOB_FIBERS_ENABLED
+        // Parked jobs come first; they were started before anything still queued.
+        job_fiber* ready;
+        if (statePtr->fiberCount && FindReadyFiber(&ready))
+        {
+            // This fiber goes back to the pool, and picks up from here when next used.
+            SwitchToFiber(ready, FIBER_ACTION_FREE);
+            idleSpins = 0;
+            continue;
+        }
+#endif
+
+        if (FindJob(GetWorkerIndex(), &j))
+        {
+            RunJob(&j);
+            idleSpins = 0;
+            continue;
+        }
+
+        if (!AtomicLoad8(&statePtr->isRunning, ATOMIC_ACQUIRE) && !HasParkedWork()) return;
+
+        if (++idleSpins < JOB_IDLE_SPIN_COUNT)
+        {
+            AtomicPause();
+            continue;
+        }
+
+        // Announce going to sleep before the last look, so a job submitted in between
+        // either gets found here or wakes this worker.
+        AtomicFetchAdd32(&statePtr->sleepingCount, 1, ATOMIC_SEQ_CST);
+        if (FindJob(GetWorkerIndex(), &j))
+        {
+            AtomicFetchSub32(&statePtr->sleepingCount, 1, ATOMIC_RELAXED);
+            RunJob(&j);
+        }
+        else
+        {
+            PlatformSemaphoreWait(&statePtr->workAvailable, JOB_IDLE_TIMEOUT_MS);
+            AtomicFetchSub32(&statePtr->sleepingCount, 1, ATOMIC_RELAXED);
+        }
+        idleSpins = 0;
+    }
+}
+
+#if JOB_FIBERS_ENABLED
+// Entry point of every pool fiber.
+static void FiberMain(void* params)
+{
+    FinishSwitch();
+    for (;;)
+    {
+        WorkerLoop();
+        // Shutting down; give the thread back to its own fiber. If this fiber is ever
+        // taken from the pool again, it carries on looking for work.
+        SwitchToFiber(&CurrentWorker()->threadFiber, FIBER_ACTION_FREE);
+    }
+}
+#endif
+
+static u32 WorkerThread(void* params)
+{
+    workerIndex = (s32)(u64)params;
+    stealSeed = (u32)workerIndex * 0x9E3779B9U + 1;
+
+    char name[32];
+    StringFormatN(name, sizeof(name), "Job worker %d", workerIndex);
+    ProfilerSetThreadName(name);
+
+#if JOB_FIBERS_ENABLED
+    job_worker* worker = CurrentWorker();
+    if (PlatformFiberConvertThread(&worker->threadFiber.context))
+    {
+        job_fiber* fiber;
+        if (RingQueuePop(&statePtr->freeFibers, &fiber))
+        {
+            worker->currentFiber = &worker->threadFiber;
+            SwitchToFiber(fiber, FIBER_ACTION_NONE);
+            // Only switched back to once shutting down.
+            PlatformFiberConvertBack(&worker->threadFiber.context);
+            return 0;
+        }
+        PlatformFiberConvertBack(&worker->threadFiber.context);
+    }
+    TWARN("Job worker %d has no fiber to run on; its jobs will wait by running other jobs instead.", workerIndex);
+#endif
+
+    WorkerLoop();
+    return 0;
+}
+
+b8 JobSystemInitialize(u64* memoryRequirement, void* state, u32 workerCount)
+{
+    if (workerCount == 0) workerCount = PlatformGetPhysicalCoreCount();
+    if (workerCount > JOB_MAX_WORKERS) workerCount = JOB_MAX_WORKERS;
+    if (workerCount == 0) workerCount = 1;
+
+    u64 queueMemoryRequirement = RingQueueMemoryRequirement(sizeof(job), JOB_SHARED_QUEUE_CAPACITY);
+    // Room to align the workers to a cache line.
+    *memoryRequirement = sizeof(job_system_state) + 64 + sizeof(job_worker) * workerCount + queueMemoryRequirement * JOB_PRIORITY_MAX;
+#if JOB_FIBERS_ENABLED
+    // Only worker threads run on fibers, so a lone main thread needs none.
+    u32 fiberCount = workerCount > 1 ? JOB_FIBER_COUNT : 0;
+    u64 fiberQueueMemoryRequirement = RingQueueMemoryRequirement(sizeof(job_fiber*), JOB_FIBER_COUNT);
+    if (fiberCount)
+    {
+        // The stacks are allocated separately, each with its own guard page.
+        *memoryRequirement += sizeof(job_fiber) * fiberCount + fiberQueueMemoryRequirement * 2;
+    }
+#endif
+    if (state == 0) return true;
+
+    statePtr = state;
+    TZeroMemory(statePtr, *memoryRequirement);
+
+    u8* memory = (u8*)state + sizeof(job_system_state);
+    memory = (u8*)(((u64)memory + 63) & ~(u64)63);
+    statePtr->workers = (job_worker*)memory;
+    memory += sizeof(job_worker) * workerCount;
+    for (u32 i = 0; i < JOB_PRIORITY_MAX; i++)
+    {
+        RingQueueCreate(sizeof(job), JOB_SHARED_QUEUE_CAPACITY, memory, &statePtr->sharedQueues[i]);
+        memory += queueMemoryRequirement;
+    }
+
+#if JOB_FIBERS_ENABLED
+    if (fiberCount)
+    {
+        statePtr->fibers = (job_fiber*)memory;
+        memory += sizeof(job_fiber) * fiberCount;
+        RingQueueCreate(sizeof(job_fiber*), JOB_FIBER_COUNT, memory, &statePtr->freeFibers);
+        memory += fiberQueueMemoryRequirement;
+        RingQueueCreate(sizeof(job_fiber*), JOB_FIBER_COUNT, memory, &statePtr->waitingFibers);
+        memory += fiberQueueMemoryRequirement;
+
+        for (u32 i = 0; i < fiberCount; i++)
+        {
+            job_fiber* fiber = &statePtr->fibers[i];
+            fiber->stack = PlatformFiberStackAllocate(JOB_FIBER_STACK_SIZE);
+            if (!fiber->stack || !PlatformFiberCreate(fiber->stack, JOB_FIBER_STACK_SIZE, FiberMain, 0, &fiber->context))
+            {
+                TERROR("Failed to create job fiber %u.", i);
+                PlatformFiberStackFree(fiber->stack, JOB_FIBER_STACK_SIZE);
+                fiber->stack = 0;
+                break;
+            }
+            RingQueuePush(&statePtr->freeFibers, &fiber);
+            statePtr->fiberCount++;
+        }
+    }
+#endif
+
+    if (!PlatformSemaphoreCreate(0, &statePtr->workAvailable))
+    {
+        TERROR("Failed to create the job system's semaphore.");
+        statePtr = 0;
+        return false;
+    }
+
+    statePtr->workerCount = workerCount;
+    statePtr->isRunning = true;
+
+    // The initializing thread is worker 0, which has no thread of its own.
+    workerIndex = 0;
+    stealSeed = 1;
+    for (u32 i = 1; i < workerCount; i++)
+    {
+        if (!PlatformThreadCreate(WorkerThread, (void*)(u64)i, &statePtr->workers[i].thread))
+        {
+            TERROR("Failed to start job worker thread %u.", i);
+            // Only stop the workers which did start.
+            statePtr->workerCount = i;
+            JobSystemShutdown(state);
+            return false;
+        }
+    }
+
+    TINFO("Job system started with %u workers.", workerCount);
+    return true;
+}
+
+void JobSystemShutdown(void* state)
+{
+    if (!statePtr) return;
+
+    // Workers finish off anything queued or parked before they exit.
+    AtomicStore8(&statePtr->isRunning, false, ATOMIC_RELEASE);
+    PlatformSemaphoreSignal(&statePtr->workAvailable, statePtr->workerCount);
+    for (u32 i = 1; i < statePtr->workerCount; i++)
+    {
+        PlatformThreadJoin(&statePtr->workers[i].thread);
+    }
+
+    // Anything left over is run here, so no counter is left waiting forever.
+    // Jobs submitted from now on run immediately.
+    job j;
+    while (FindJob(workerIndex, &j))
+    {
+        RunJob(&j);
+    }
+
+    PlatformSemaphoreDestroy(&statePtr->workAvailable);
+    for (u32 i = 0; i < JOB_PRIORITY_MAX; i++)
+    {
+        RingQueueDestroy(&statePtr->sharedQueues[i]);
+    }
+
+#if JOB_FIBERS_ENABLED
+    if (statePtr->fiberCount)
+    {
+        for (u32 i = 0; i < statePtr->fiberCount; i++)
+        {
+            PlatformFiberDestroy(&statePtr->fibers[i].context);
+            PlatformFiberStackFree(statePtr->fibers[i].stack, JOB_FIBER_STACK_SIZE);
+        }
+        RingQueueDestroy(&statePtr->freeFibers);
+        RingQueueDestroy(&statePtr->waitingFibers);
+    }
+#endif
+
+    workerIndex = -1;
+    statePtr = 0;
+}
+
+void JobSubmit(const job_desc* jobs, u32 count, job_counter* counter)
+{
+    if (!count) return;
+
+    if (!statePtr || !AtomicLoad8(&statePtr->isRunning, ATOMIC_ACQUIRE))
+    {
+        for (u32 i = 0; i < count; i++)
+        {
+            jobs[i].entry(jobs[i].params);
+        }
+        return;
+    }
+
+    // Counted up front, so the counter cannot reach zero while jobs are still being queued.
+    if (counter)
+    {
+        AtomicFetchAdd32(&counter->value, count, ATOMIC_RELAXED);
+    }
+
+    for (u32 i = 0; i < count; i++)
+    {
+        job j = {jobs[i].entry, jobs[i].params, counter};
+        job_priority priority = jobs[i].priority < JOB_PRIORITY_MAX ? jobs[i].priority : JOB_PRIORITY_LOW;
+
+        // Looked up every time, since a job run inline below may come back on another thread.
+        s32 self = GetWorkerIndex();
+        b8 queued;
+        if (self >= 0)
+            queued = DequePush(&statePtr->workers[self].deques[priority], &j);
+        else
+            queued = RingQueuePush(&statePtr->sharedQueues[priority], &j);
+
+        if (!queued)
+        {
+            // Out of room. Running it now keeps things moving rather than dropping it.
+            RunJob(&j);
+        }
+    }
+
+    WakeWorkers(count);
+}
+
+b8 JobIsDone(job_counter* counter)
+{
+    return AtomicLoad32(&counter->value, ATOMIC_ACQUIRE) == 0;
+}
+
+void JobWait(job_counter* counter)
+{
+    job j;
+    u32 spins = 0;
+    while (!JobIsDone(counter))
+    {
+#if JOB_FIBERS_ENABLED
+        // Only jobs on pool fibers can park; the main thread and fiberless workers help instead.
+        // Checked every time, since a job run below may come back on another worker.
+        job_worker* worker = CurrentWorker();
+        b8 canPark = worker && worker->currentFiber && worker->currentFiber->stack;
+
+        // Park on a ready fiber if there is one, otherwise on a fresh one from the pool.
+        job_fiber* next;
+        if (canPark && (FindReadyFiber(&next) || RingQueuePop(&statePtr->freeFibers, &next)))
+        {
+            worker->currentFiber->waitCounter = counter;
+            SwitchToFiber(next, FIBER_ACTION_PARK);
+            // Only resumed once the counter has reached zero. Pairs with the release in RunJob.
+            AtomicThreadFence(ATOMIC_ACQUIRE);
+            return;
+        }
+#endif
+
+        if (statePtr && FindJob(GetWorkerIndex(), &j))
+        {
+            RunJob(&j);
+            spins = 0;
+        }
+        else if (++spins < JOB_WAIT_SPIN_COUNT)
+        {
+            AtomicPause();
+        }
+        else
+        {
+            // The remaining jobs are running elsewhere; give the core to them.
+            PlatformThreadYield();
+            spins = 0;
+        }
+    }
+}
+
+b8 JobHelp()
+{
+    job j;
+    if (!statePtr || !FindJob(GetWorkerIndex(), &j)) return false;
+
+    RunJob(&j);
+    return true;
+}
+
+u32 JobSystemGetWorkerCount()
+{
+    return statePtr ? statePtr->workerCount : 1;
+}
+
+s32 JobSystemGetWorkerIndex()
+{
+    return workerIndex;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Work-stealing job system.
+
+There is one worker per physical core. The thread which initializes the job
+system (the main thread) is worker 0 and only runs jobs while it waits on a
+counter; every other worker has its own thread. Each worker owns a Chase-Lev
+deque per priority: it pushes and pops its own jobs at one end without
+contention, while idle workers steal the oldest jobs from the other end.
+Jobs submitted from threads which are not workers go into a shared queue.
+
+Completion is tracked with counters. Submitting jobs with a counter adds the
+number of jobs to it, and each job decrements it when done. Waiting on a
+counter runs other jobs until it reaches zero, so a job may submit child
+jobs and wait on them without tying up its worker.
+
+With fibers enabled, jobs on worker threads run on fibers from a fixed pool.
+A job which waits on a counter parks its fiber, and the worker carries on
+with other work on a fresh one; the parked fiber is resumed, possibly on a
+different thread, once the counter reaches zero. Chains of dependent work
+can then be written as straight-line code which simply waits. Because of
+this, thread-local values must not be relied upon across a JobWait.
+The main thread never switches fibers, and waits by running jobs instead.
+*/
+
+// Run jobs on fibers, so waiting parks the job instead of its worker.
+#define JOB_FIBERS_ENABLED 1
+
+// The most workers the job system will run, regardless of core count.
+#define JOB_MAX_WORKERS 64
+
+// The number of fibers in the pool, which bounds how many jobs can be parked at once.
+// Must be a power of 2. When every fiber is in use, waiting falls back to running jobs.
+#define JOB_FIBER_COUNT 128
+
+// The stack size of each fiber, in bytes. Each stack has a guard page below it, so a job
+// which overflows it faults on the spot.
+#define JOB_FIBER_STACK_SIZE (64 * 1024)
+
+typedef void (*PFN_job_entry)(void* params);
+
+typedef enum job_priority {
+    JOB_PRIORITY_HIGH,
+    JOB_PRIORITY_NORMAL,
+    JOB_PRIORITY_LOW,
+    JOB_PRIORITY_MAX
+} job_priority;
+
+// Describes a single job to be run.
+typedef struct job_desc
+{
+    // The function to run.
+    PFN_job_entry entry;
+    // Passed as-is to entry. Must stay valid until the job has run.
+    void* params;
+    job_priority priority;
+} job_desc;
+
+// The number of submitted jobs which have yet to finish. Zero-initialize before use.
+typedef struct job_counter
+{
+    u32 value;
+} job_counter;
+
+/**
+ * @brief Initializes the job system. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state. Must be called on the main thread.
+ *
+ * @param memoryRequirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @param workerCount The number of workers including the main thread, or 0 for one per physical core.
+ * Must be the same for both calls.
+ * @return b8 True on success; otherwise false.
+ */
+b8 JobSystemInitialize(u64* memoryRequirement, void* state, u32 workerCount);
+
+/**
+ * @brief Shuts down the job system. Jobs which are still queued are run first.
+ *
+ * @param state A pointer to the system's state.
+ */
+void JobSystemShutdown(void* state);
+
+/**
+ * @brief Submits jobs to be run. Safe to call from any thread, including from within a job.
+ * If the job system has not been started, the jobs are run immediately on the calling thread.
+ *
+ * @param jobs An array of jobs to run.
+ * @param count The number of jobs.
+ * @param counter Incremented by count, then decremented as each job finishes. May be 0.
+ */
+TAPI void JobSubmit(const job_desc* jobs, u32 count, job_counter* counter);
+
+/**
+ * @brief Waits for every job submitted with the counter to finish. Inside a job on a worker
+ * thread, the job is parked until then; otherwise the calling thread runs other jobs in the meantime.
+ *
+ * @param counter A pointer to the counter to wait on.
+ */
+TAPI void JobWait(job_counter* counter);
+
+/**
+ * @brief Runs one queued job on the calling thread, if there is one. For threads which
+ * wait on something other than a counter, and want to be useful in the meantime.
+ *
+ * @return b8 True if a job was run; otherwise false.
+ */
+TAPI b8 JobHelp();
+
+/**
+ * @brief Checks whether every job submitted with the counter has finished.
+ */
+TAPI b8 JobIsDone(job_counter* counter);
+
+// Gets the number of workers, including the main thread. 1 if the job system is not running.
+TAPI u32 JobSystemGetWorkerCount();
+
+// Gets the index of the calling thread's worker; 0 for the main thread, or -1 if it is not a worker.
+TAPI s32 JobSystemGetWorkerIndex();
\ No newline at end of file
@@ -2,25 +2,92 @@
 #include "Asserts.h"
 #include "Platform/Platform.h"
 #include "Platform/Filesystem.h"
+#include "Platform/Atomic.h"
+#include "Containers/RingQueue.h"
 #include "TString.h"
 #include "TMemory.h"
 
 // TODO: temporary
 #include <stdarg.h>
 
+// Size of a single queued log record, header included. Longer messages are truncated.
+#define LOG_RECORD_SIZE 1024
+// Number of records the queue can hold before callers have to wait. Power of 2.
+#define LOG_QUEUE_CAPACITY 1024
+// Size of the buffer log file writes are gathered in.
+#define LOG_BATCH_SIZE (64 * 1024)
+// Longest time, in seconds, a message may sit in the batch before being written to file.
+#define LOG_FLUSH_INTERVAL 0.1
+// The maximum number of distinct binary log formats.
+#define LOG_MAX_FORMATS 4096
+// Largest text a binary record can decode to.
+#define LOG_DECODE_SIZE 4096
+
+typedef enum log_record_kind {
+    // The text holds the formatted message.
+    LOG_RECORD_TEXT,
+    // The text holds a format ID and arguments, as written by LogBinaryEncode.
+    LOG_RECORD_BINARY
+} log_record_kind;
+
+typedef struct log_record
+{
+    u8 level;
+    u8 kind;
+    u16 length;
+    char text[LOG_RECORD_SIZE - 4];
+} log_record;
+
 typedef struct logger_system_state
 {
     file_handle logFileHandle;
+
+    // Async state. Only used when LOG_ASYNC_ENABLED is set and the writer thread started.
+    // Both are flags, accessed atomically.
+    u8 isAsync;
+    u8 isRunning;
+    platform_thread writerThread;
+    // Signalled to wake the writer when it is waiting for messages.
+    platform_semaphore wakeWriter;
+    u8 isWriterWaiting;
+    ring_queue queue;
+    // Number of records popped by the writer whose file writes have been issued.
+    u64 flushedCount;
+    // Log file writes are gathered here to keep syscalls down.
+    u64 batchLength;
+    char batch[LOG_BATCH_SIZE];
 } logger_system_state;
 
 static logger_system_state* statePtr;
 
-void AppendToLogFile(const char* message)
+// Registered binary log formats (const char*), indexed by ID - 1. Kept outside of
+// the system state so call sites can register before the logger is initialized.
+static void* formats[LOG_MAX_FORMATS];
+static u32 formatCount;
+
+// Release builds keep debug and trace out of the log unless asked for at runtime.
+#if TRELEASE == 1
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_DEFAULT_LEVEL LOG_LEVEL_TRACE
+#endif
+
+u8 logChannelLevels[LOG_CHANNEL_MAX] = {
+    [LOG_CHANNEL_CORE] = LOG_DEFAULT_LEVEL,
+    [LOG_CHANNEL_RENDERER] = LOG_DEFAULT_LEVEL,
+    // Validation layer chatter is only wanted when chasing a Vulkan problem.
+    [LOG_CHANNEL_VULKAN] = LOG_LEVEL_INFO,
+    [LOG_CHANNEL_INPUT] = LOG_DEFAULT_LEVEL,
+    [LOG_CHANNEL_MEMORY] = LOG_DEFAULT_LEVEL,
+    [LOG_CHANNEL_GAME] = LOG_DEFAULT_LEVEL};
+
+static const char* levelStrings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
+
+void AppendToLogFile(const char* message, u64 length)
 {
     if (statePtr && statePtr->logFileHandle.isValid)
     {
         // Since the message already contains a '\n', just write the bytes directly.
-        u64 length = StringLength(message);
         u64 written = 0;
         if (!FilesystemWrite(&statePtr->logFileHandle, length, message, &written))
         {
@@ -29,12 +96,121 @@ void AppendToLogFile(const char* message)
     }
 }
 
+static void WriteToConsole(const char* message, log_level level)
+{
+    if (level < LOG_LEVEL_WARN)
+        PlatformConsoleWriteError(message, level);
+    else
+        PlatformConsoleWrite(message, level);
+}
+
+static void FlushBatch(logger_system_state* state)
+{
+    if (state->batchLength)
+    {
+        AppendToLogFile(state->batch, state->batchLength);
+        state->batchLength = 0;
+    }
+}
+
+// Turns a record into a full line at the end of the batch, echoes it to the console,
+// and leaves it there to be written to the log file with the rest of the batch.
+static void WriteRecord(logger_system_state* state, const log_record* record)
+{
+    const char* text = record->text;
+    u64 length = record->length;
+    char decoded[LOG_DECODE_SIZE];
+    if (record->kind == LOG_RECORD_BINARY)
+    {
+        length = LogBinaryDecode(record->text, record->length, decoded, sizeof(decoded));
+        text = decoded;
+    }
+
+    u64 prefixLength = StringLength(levelStrings[record->level]);
+    // Prefix, message, '\n' and the terminator the console needs.
+    u64 lineLength = prefixLength + length + 1;
+    if (state->batchLength + lineLength + 1 > LOG_BATCH_SIZE)
+    {
+        FlushBatch(state);
+    }
+
+    char* line = state->batch + state->batchLength;
+    TCopyMemory(line, levelStrings[record->level], prefixLength);
+    TCopyMemory(line + prefixLength, text, length);
+    line[lineLength - 1] = '\n';
+    line[lineLength] = 0;
+
+    WriteToConsole(line, record->level);
+    state->batchLength += lineLength;
+}
+
+static u32 LogWriterThread(void* params)
+{
+    logger_system_state* state = params;
+    f64 lastFlushTime = PlatformGetAbsoluteTime();
+    u64 poppedCount = 0;
+
+    for (;;)
+    {
+        // Read before draining, so a stop request is only honoured once everything
+        // pushed ahead of it has been written.
+        b8 running = AtomicLoad8(&state->isRunning, ATOMIC_ACQUIRE);
+
+        u32 processed = 0;
+        b8 flushNow = false;
+        log_record* record;
+        while ((record = RingQueueBeginPop(&state->queue)) != 0)
+        {
+            WriteRecord(state, record);
+            // Errors go to disk right away, in case the process is about to go down.
+            if (record->level <= LOG_LEVEL_ERROR) flushNow = true;
+            RingQueueEndPop(&state->queue, record);
+            poppedCount++;
+            processed++;
+        }
+
+        // One console write for everything drained this pass.
+        if (processed) PlatformConsoleFlush();
+
+        f64 now = PlatformGetAbsoluteTime();
+        if (flushNow || !running || now - lastFlushTime >= LOG_FLUSH_INTERVAL)
+        {
+            FlushBatch(state);
+            lastFlushTime = now;
+        }
+        if (state->batchLength == 0)
+        {
+            AtomicStore64(&state->flushedCount, poppedCount, ATOMIC_RELEASE);
+        }
+
+        if (!running && processed == 0) break;
+
+        if (processed == 0)
+        {
+            // Sleep until something is logged, or it is time to flush the batch.
+            AtomicStore8(&state->isWriterWaiting, true, ATOMIC_RELAXED);
+            // Pairs with the fence in EndRecord so either the writer sees the new record
+            // or the producer sees the writer waiting.
+            AtomicThreadFence(ATOMIC_SEQ_CST);
+            if (RingQueueLength(&state->queue) == 0 && AtomicLoad8(&state->isRunning, ATOMIC_ACQUIRE))
+            {
+                PlatformSemaphoreWait(&state->wakeWriter, (u64)(LOG_FLUSH_INTERVAL * 1000));
+            }
+            AtomicStore8(&state->isWriterWaiting, false, ATOMIC_RELAXED);
+        }
+    }
+
+    return 0;
+}
+
 b8 LoggingSystemInitialize(u64* memoryRequirement, void* state)
 {
-    *memoryRequirement = sizeof(logger_system_state);
+    u64 queueMemoryRequirement = RingQueueMemoryRequirement(sizeof(log_record), LOG_QUEUE_CAPACITY);
+    *memoryRequirement = sizeof(logger_system_state) + queueMemoryRequirement;
     if (state == 0) return true;
-    
+
     statePtr = state;
+    TZeroMemory(statePtr, sizeof(logger_system_state));
 
     // Create new/wipe existing log file, then open it.
     if (!FilesystemOpen("console.log", FILE_MODE_WRITE, false, &statePtr->logFileHandle))
@@ -43,56 +219,444 @@ b8 LoggingSystemInitialize(u64* memoryRequirement, void* state)
         return false;
     }
 
+#if LOG_ASYNC_ENABLED == 1
+    // The queue's storage lives right after the state block.
+    RingQueueCreate(sizeof(log_record), LOG_QUEUE_CAPACITY, (u8*)state + sizeof(logger_system_state), &statePtr->queue);
+    statePtr->isRunning = true;
+    if (PlatformSemaphoreCreate(0, &statePtr->wakeWriter) &&
+        PlatformThreadCreate(LogWriterThread, statePtr, &statePtr->writerThread))
+    {
+        statePtr->isAsync = true;
+    }
+    else
+    {
+        // Logging still works, it just blocks the caller.
+        statePtr->isRunning = false;
+        PlatformSemaphoreDestroy(&statePtr->wakeWriter);
+        TWARN("Unable to start the log writer thread. Logging will be synchronous.");
+    }
+#endif
+
     // TODO: Remove this
     TFATAL("A test message: %f", 3.14f);
     TERROR("A test message: %f", 3.14f);
     TWARN("A test message: %f", 3.14f);
     TINFO("A test message: %f", 3.14f);
     TDEBUG("A test message: %f", 3.14f);
-    TTRACE("A test message: %f", 3.14f); 
-    
+    TTRACE("A test message: %f", 3.14f);
+
     return true;
 }
 
 void ShutdownLogging(void* state)
 {
-    // TODO: cleanup logging/write queued entries.
+    if (statePtr)
+    {
+        if (statePtr->isAsync)
+        {
+            // Anything logged from here on is written directly. The writer drains
+            // what is already queued before it exits.
+            AtomicStore8(&statePtr->isAsync, false, ATOMIC_RELEASE);
+            AtomicStore8(&statePtr->isRunning, false, ATOMIC_RELEASE);
+            PlatformSemaphoreSignal(&statePtr->wakeWriter, 1);
+            PlatformThreadJoin(&statePtr->writerThread);
+            PlatformSemaphoreDestroy(&statePtr->wakeWriter);
+            RingQueueDestroy(&statePtr->queue);
+        }
+
+        FilesystemClose(&statePtr->logFileHandle);
+    }
+
     statePtr = 0;
 }
 
-void LogOutput(log_level level, const char* message, ...)
+void LogFlush()
+{
+    if (!statePtr || !AtomicLoad8(&statePtr->isAsync, ATOMIC_ACQUIRE)) return;
+
+    // Everything claimed up to now has been written once the writer has flushed this many.
+    u64 target = AtomicLoad64(&statePtr->queue.pushCursor, ATOMIC_ACQUIRE);
+    while (AtomicLoad64(&statePtr->flushedCount, ATOMIC_ACQUIRE) < target)
+    {
+        PlatformSleep(0);
+    }
+}
+
+void LogSetChannelLevel(log_channel channel, log_level level)
 {
-    // TODO: These string operations are all pretty slow. This needs to be
-    // moved to another thread eventually, along with the file writes, to
-    // avoid slowing things down while the engine is trying to run.
-    const char* levelStrings[6] = {"[FATAL]: ", "[ERROR]: ", "[WARN]:  ", "[INFO]:  ", "[DEBUG]: ", "[TRACE]: "};
-    b8 isError = level < LOG_LEVEL_WARN;
+    if (channel >= LOG_CHANNEL_MAX) return;
+
+    // Errors and worse are always logged.
+    if (level < LOG_LEVEL_ERROR) level = LOG_LEVEL_ERROR;
+    AtomicStore8(&logChannelLevels[channel], (u8)level, ATOMIC_RELAXED);
+}
 
+log_level LogGetChannelLevel(log_channel channel)
+{
+    if (channel >= LOG_CHANNEL_MAX) return LOG_LEVEL_FATAL;
+    return (log_level)AtomicLoad8(&logChannelLevels[channel], ATOMIC_RELAXED);
+}
+
+static void WriteLineSync(log_level level, const char* line, u64 length)
+{
+    // Print message to console. Without the writer thread there is no one else
+    // to flush it, so it goes straight out.
+    WriteToConsole(line, level);
+    PlatformConsoleFlush();
+
+    // Queue a copy to be written to the log file.
+    AppendToLogFile(line, length);
+}
+
+static void LogOutputSync(log_level level, const char* message, __builtin_va_list argPtr)
+{
     // Technically imposes a 32k character limit on a single log entry, but...
     // DON'T DO THAT!
     char outMessage[32000];
-    TZeroMemory(outMessage, sizeof(outMessage));
 
-    // Format original message.
+    // Prepend log level to message, then format the original message after it,
+    // leaving room for the newline.
+    u64 prefixLength = StringLength(levelStrings[level]);
+    TCopyMemory(outMessage, levelStrings[level], prefixLength);
+    u64 length = prefixLength + StringFormatNV(outMessage + prefixLength, sizeof(outMessage) - prefixLength - 1, message, argPtr);
+    outMessage[length++] = '\n';
+    outMessage[length] = 0;
+
+    WriteLineSync(level, outMessage, length);
+}
+
+// Reserves the next record in the queue, waiting for room if need be.
+static log_record* BeginRecord(log_level level, log_record_kind kind)
+{
+    log_record* record;
+    while ((record = RingQueueBeginPush(&statePtr->queue)) == 0)
+    {
+        // The writer has fallen behind. Wait for room rather than drop the message.
+        PlatformSleep(0);
+    }
+
+    record->level = (u8)level;
+    record->kind = (u8)kind;
+    return record;
+}
+
+static void EndRecord(log_record* record)
+{
+    log_level level = record->level;
+    RingQueueEndPush(&statePtr->queue, record);
+
+    AtomicThreadFence(ATOMIC_SEQ_CST);
+    if (AtomicLoad8(&statePtr->isWriterWaiting, ATOMIC_RELAXED))
+    {
+        PlatformSemaphoreSignal(&statePtr->wakeWriter, 1);
+    }
+
+    if (level == LOG_LEVEL_FATAL)
+    {
+        // Make sure this is on screen and on disk before anything breaks into the debugger.
+        LogFlush();
+    }
+}
+
+static void LogOutputAsync(log_level level, const char* message, __builtin_va_list argPtr)
+{
+    // Only the message body is formatted here, straight into the queue slot. The level
+    // prefix, console output and file writes all happen on the writer thread.
+    log_record* record = BeginRecord(level, LOG_RECORD_TEXT);
+    record->length = (u16)StringFormatNV(record->text, sizeof(record->text), message, argPtr);
+    EndRecord(record);
+}
+
+void LogOutput(log_level level, const char* message, ...)
+{
     // NOTE: Oddly enough, MS's headers override the GCC/Clang va_list type with a "typedef char* va_list" in some
     // cases, and as a result throws a strange error here. The workaround for now is to just use __builtin_va_list,
     // which is the type GCC/Clang's va_start expects.
     __builtin_va_list argPtr;
     va_start(argPtr, message);
-    StringFormatV(outMessage, message, argPtr);
+    if (statePtr && AtomicLoad8(&statePtr->isAsync, ATOMIC_ACQUIRE))
+        LogOutputAsync(level, message, argPtr);
+    else
+        LogOutputSync(level, message, argPtr);
     va_end(argPtr);
+}
+
+u32 LogRegisterFormat(u32* formatId, const char* format)
+{
+    u32 id = AtomicLoad32(formatId, ATOMIC_ACQUIRE);
+    if (id) return id;
+
+    u32 index = AtomicFetchAdd32(&formatCount, 1, ATOMIC_RELAXED);
+    if (index >= LOG_MAX_FORMATS) return 0;
+
+    AtomicStorePtr(&formats[index], (void*)format, ATOMIC_RELEASE);
+    // If another thread registered this call site first, use its ID. The slot
+    // taken here is simply never referenced.
+    u32 expected = 0;
+    if (!AtomicCompareExchange32(formatId, &expected, index + 1, ATOMIC_ACQ_REL, ATOMIC_ACQUIRE))
+    {
+        return expected;
+    }
+    return index + 1;
+}
 
-    // Prepend log level to message.
-    StringFormat(outMessage, "%s%s\n", levelStrings[level], outMessage);
+const char* LogGetFormat(u32 formatId)
+{
+    if (formatId == 0 || formatId > LOG_MAX_FORMATS) return 0;
+    return AtomicLoadPtr(&formats[formatId - 1], ATOMIC_ACQUIRE);
+}
+
+// A record starts with the format ID and the argTypes descriptor.
+#define BINARY_HEADER_SIZE (sizeof(u32) + sizeof(u64))
+
+TINLINE log_arg_type ArgTypeAt(u64 argTypes, u32 argCount, u32 index)
+{
+    // The first argument's type is in the highest nibble in use.
+    return (log_arg_type)((argTypes >> (4 * (argCount - index))) & 0xF);
+}
 
-    // Print message to console
-    if (isError)
-        PlatformConsoleWriteError(outMessage, level);
+static u64 EncodeBinaryV(u8* dest, u64 destSize, u32 formatId, u64 argTypes, __builtin_va_list args)
+{
+    // NOTE: This runs on the caller's thread, so copies go through __builtin_memcpy
+    // to be inlined rather than calling out to the platform layer for every argument.
+    u32 argCount = argTypes & 0xF;
+    // Every argument is given at least 8 bytes, so only strings ever need to be truncated.
+    if (destSize < BINARY_HEADER_SIZE + argCount * sizeof(u64)) return 0;
+
+    __builtin_memcpy(dest, &formatId, sizeof(u32));
+    __builtin_memcpy(dest + sizeof(u32), &argTypes, sizeof(u64));
+    u64 offset = BINARY_HEADER_SIZE;
+
+    for (u32 i = 0; i < argCount; i++)
+    {
+        u64 value = 0;
+        switch (ArgTypeAt(argTypes, argCount, i))
+        {
+            case LOG_ARG_S32: value = (u64)(s64)va_arg(args, s32); break;
+            case LOG_ARG_U32: value = va_arg(args, u32); break;
+            case LOG_ARG_S64: value = (u64)va_arg(args, long long); break;
+            case LOG_ARG_U64: value = va_arg(args, unsigned long long); break;
+            case LOG_ARG_F64:
+            {
+                f64 f = va_arg(args, f64);
+                __builtin_memcpy(&value, &f, sizeof(f64));
+            } break;
+            case LOG_ARG_POINTER: value = (u64)va_arg(args, void*); break;
+            case LOG_ARG_STRING:
+            {
+                // Stored as a u16 length followed by the characters, without a terminator.
+                const char* string = va_arg(args, const char*);
+                if (!string) string = "(null)";
+                u64 length = StringLength(string);
+                u64 room = destSize - offset - sizeof(u16) - (argCount - i - 1) * sizeof(u64);
+                if (length > room) length = room;
+
+                u16 stored = (u16)length;
+                __builtin_memcpy(dest + offset, &stored, sizeof(u16));
+                __builtin_memcpy(dest + offset + sizeof(u16), string, length);
+                offset += sizeof(u16) + length;
+            } continue;
+            default: break;
+        }
+
+        __builtin_memcpy(dest + offset, &value, sizeof(u64));
+        offset += sizeof(u64);
+    }
+
+    return offset;
+}
+
+u64 LogBinaryEncode(void* dest, u64 destSize, u32 formatId, u64 argTypes, ...)
+{
+    __builtin_va_list argPtr;
+    va_start(argPtr, argTypes);
+    u64 size = EncodeBinaryV(dest, destSize, formatId, argTypes, argPtr);
+    va_end(argPtr);
+    return size;
+}
+
+void LogOutputBinary(log_level level, u32* formatId, const char* format, u64 argTypes, ...)
+{
+    u32 id = AtomicLoad32(formatId, ATOMIC_ACQUIRE);
+    if (!id) id = LogRegisterFormat(formatId, format);
+    b8 isAsync = statePtr && AtomicLoad8(&statePtr->isAsync, ATOMIC_ACQUIRE);
+
+    __builtin_va_list argPtr;
+    va_start(argPtr, argTypes);
+    if (!id)
+    {
+        // Out of format IDs. Format the message now instead, as usual.
+        if (isAsync)
+            LogOutputAsync(level, format, argPtr);
+        else
+            LogOutputSync(level, format, argPtr);
+    }
+    else if (isAsync)
+    {
+        log_record* record = BeginRecord(level, LOG_RECORD_BINARY);
+        record->length = (u16)EncodeBinaryV((u8*)record->text, sizeof(record->text), id, argTypes, argPtr);
+        EndRecord(record);
+    }
     else
-        PlatformConsoleWrite(outMessage, level);
-    
-    // Queue a copy to be written to the log file.
-    AppendToLogFile(outMessage);
+    {
+        // No writer thread to hand it to, so decode it right away.
+        log_record record;
+        u64 recordSize = EncodeBinaryV((u8*)record.text, sizeof(record.text), id, argTypes, argPtr);
+
+        char line[LOG_DECODE_SIZE];
+        u64 prefixLength = StringLength(levelStrings[level]);
+        TCopyMemory(line, levelStrings[level], prefixLength);
+        u64 length = prefixLength + LogBinaryDecode(record.text, recordSize, line + prefixLength, sizeof(line) - prefixLength - 1);
+        line[length++] = '\n';
+        line[length] = 0;
+
+        WriteLineSync(level, line, length);
+    }
+    va_end(argPtr);
+}
+
+// Reads the next argument out of a binary record. Strings are copied into stringBuffer
+// so they can be passed on null-terminated.
+static b8 ReadArg(const u8* record, u64 recordSize, u64* offset, u64 argTypes, u32* argIndex,
+                  log_arg_type* outType, u64* outValue, char* stringBuffer, u64 stringBufferSize)
+{
+    u32 argCount = argTypes & 0xF;
+    if (*argIndex >= argCount) return false;
+
+    *outType = ArgTypeAt(argTypes, argCount, *argIndex);
+    (*argIndex)++;
+
+    if (*outType == LOG_ARG_STRING)
+    {
+        u16 length;
+        if (*offset + sizeof(u16) > recordSize) return false;
+        TCopyMemory(&length, record + *offset, sizeof(u16));
+        *offset += sizeof(u16);
+        if (*offset + length > recordSize || length >= stringBufferSize) return false;
+
+        TCopyMemory(stringBuffer, record + *offset, length);
+        stringBuffer[length] = 0;
+        *offset += length;
+        return true;
+    }
+
+    if (*offset + sizeof(u64) > recordSize) return false;
+    TCopyMemory(outValue, record + *offset, sizeof(u64));
+    *offset += sizeof(u64);
+    return true;
+}
+
+static b8 IsConversion(char c)
+{
+    switch (c)
+    {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+        case 'c': case 's': case 'p': case 'n':
+            return true;
+        default:
+            return false;
+    }
+}
+
+u64 LogBinaryDecode(const void* record, u64 recordSize, char* dest, u64 destSize)
+{
+    if (!dest || destSize == 0) return 0;
+    dest[0] = 0;
+
+    const u8* data = record;
+    if (recordSize < BINARY_HEADER_SIZE) return 0;
+
+    u32 formatId;
+    u64 argTypes;
+    TCopyMemory(&formatId, data, sizeof(u32));
+    TCopyMemory(&argTypes, data + sizeof(u32), sizeof(u64));
+
+    const char* format = LogGetFormat(formatId);
+    if (!format)
+    {
+        return StringFormatN(dest, destSize, "<unknown log format %u>", formatId);
+    }
+
+    u64 offset = BINARY_HEADER_SIZE;
+    u32 argIndex = 0;
+    u64 written = 0;
+    char stringBuffer[LOG_RECORD_SIZE];
+
+    while (*format && written < destSize - 1)
+    {
+        if (*format != '%' || format[1] == '%')
+        {
+            dest[written++] = *format;
+            format += (*format == '%') ? 2 : 1;
+            continue;
+        }
+
+        // Copy out a single conversion: %[flags][width][.precision][length]conversion.
+        // A '*' width or precision is replaced by its value from the arguments.
+        char spec[64];
+        u64 specLength = 0;
+        const char* specStart = format;
+        spec[specLength++] = *format++;
+        b8 isValid = true;
+        while (*format && !IsConversion(*format) && specLength < sizeof(spec) - 16)
+        {
+            if (*format == '*')
+            {
+                log_arg_type type;
+                u64 value = 0;
+                isValid = ReadArg(data, recordSize, &offset, argTypes, &argIndex, &type, &value, stringBuffer, sizeof(stringBuffer));
+                specLength += StringFormatN(spec + specLength, sizeof(spec) - specLength, "%d", (s32)value);
+                format++;
+            }
+            else
+            {
+                spec[specLength++] = *format++;
+            }
+        }
+
+        if (!*format) break;
+        char conversion = *format++;
+        spec[specLength++] = conversion;
+        spec[specLength] = 0;
+
+        log_arg_type type;
+        u64 value = 0;
+        if (!isValid || conversion == 'n' || !ReadArg(data, recordSize, &offset, argTypes, &argIndex, &type, &value, stringBuffer, sizeof(stringBuffer)))
+        {
+            // Missing or unsupported argument; leave the conversion as written.
+            u64 length = format - specStart;
+            if (length > destSize - 1 - written) length = destSize - 1 - written;
+            TCopyMemory(dest + written, specStart, length);
+            written += length;
+            continue;
+        }
+
+        // Passed on as the type it was captured as, which is what the original call passed.
+        char* out = dest + written;
+        u64 room = destSize - written;
+        s32 length = 0;
+        switch (type)
+        {
+            case LOG_ARG_S32: length = StringFormatN(out, room, spec, (s32)(s64)value); break;
+            case LOG_ARG_U32: length = StringFormatN(out, room, spec, (u32)value); break;
+            case LOG_ARG_S64: length = StringFormatN(out, room, spec, (long long)value); break;
+            case LOG_ARG_U64: length = StringFormatN(out, room, spec, (unsigned long long)value); break;
+            case LOG_ARG_F64:
+            {
+                f64 f;
+                TCopyMemory(&f, &value, sizeof(f64));
+                length = StringFormatN(out, room, spec, f);
+            } break;
+            case LOG_ARG_STRING: length = StringFormatN(out, room, spec, stringBuffer); break;
+            case LOG_ARG_POINTER: length = StringFormatN(out, room, spec, (void*)value); break;
+            default: break;
+        }
+        if (length > 0) written += length;
+    }
+
+    dest[written] = 0;
+    return written;
 }
 
 void ReportAssertionFailure(const char* expression, const char* message, const char* file, s32 line)
@@ -1,16 +1,28 @@
 #pragma once
 
 #include "Defines.h"
+#include "Platform/Atomic.h"
 
 #define LOG_WARN_ENABLED 1
 #define LOG_INFO_ENABLED 1
-#define LOG_DEBUG_ENABLED 1
-#define LOG_TRACE_ENABLED 1
 
-// Disable debug and trace logging for release builds.
-#if TRELEASE == 1
+// When enabled, messages are queued and written out by a background thread
+// instead of blocking the caller on console and file I/O.
+#define LOG_ASYNC_ENABLED 1
+
+// When enabled, debug and trace messages are not formatted by the caller. Only
+// the format string's ID and the raw argument values are recorded; the text is
+// produced later, on the log writer thread. This makes them cheap enough to
+// leave on in release builds.
+#define LOG_BINARY_ENABLED 1
+
+// Disable debug and trace logging for release builds, unless they are binary.
+#if TRELEASE == 1 && LOG_BINARY_ENABLED != 1
 #define LOG_DEBUG_ENABLED 0
 #define LOG_TRACE_ENABLED 0
+#else
+#define LOG_DEBUG_ENABLED 1
+#define LOG_TRACE_ENABLED 1
 #endif
 
 typedef enum log_level {
@@ -22,6 +34,29 @@ typedef enum log_level {
     LOG_LEVEL_TRACE = 5
 } log_level;
 
+// Subsystems whose messages can be filtered separately at runtime.
+typedef enum log_channel {
+    LOG_CHANNEL_CORE,
+    LOG_CHANNEL_RENDERER,
+    LOG_CHANNEL_VULKAN,
+    LOG_CHANNEL_INPUT,
+    LOG_CHANNEL_MEMORY,
+    LOG_CHANNEL_GAME,
+    LOG_CHANNEL_MAX
+} log_channel;
+
+// The channel used by the logging macros without a _CH suffix. Define LOG_CHANNEL
+// at the top of a source file, before any includes, to log all of its messages to
+// a different channel.
+#ifndef LOG_CHANNEL
+#define LOG_CHANNEL LOG_CHANNEL_CORE
+#endif
+
+// The most verbose level logged on each channel. Read directly by the logging
+// macros so a filtered message costs only a load and compare. Use
+// LogSetChannelLevel to change it.
+TAPI extern u8 logChannelLevels[LOG_CHANNEL_MAX];
+
 /**
  * @brief Initializes logging system. Call twice; once with state = 0 to get required memory size,
  * then a second time passing allocated memory to state.
@@ -31,48 +66,221 @@ typedef enum log_level {
  * @return b8 True on success; otherwise false.
  */
 b8 LoggingSystemInitialize(u64* memoryRequirement, void* state);
+
+/**
+ * @brief Shuts down the logging system. Any queued messages are written out
+ * before this returns, so nothing logged beforehand is lost.
+ * 
+ * @param state A pointer to the system's state.
+ */
 void ShutdownLogging(void* state);
 
+/**
+ * @brief Blocks until every message logged so far has been written to the
+ * console and log file. Does nothing when logging is synchronous.
+ */
+TAPI void LogFlush();
+
+/**
+ * @brief Sets the most verbose level logged on a channel. Can be called at any
+ * time, from any thread. Fatal and error messages are always logged.
+ * 
+ * @param channel The channel to change.
+ * @param level The most verbose level to log; e.g. LOG_LEVEL_INFO logs info, warnings and errors.
+ */
+TAPI void LogSetChannelLevel(log_channel channel, log_level level);
+
+/**
+ * @brief Gets the most verbose level logged on a channel.
+ * 
+ * @param channel The channel to query.
+ * @return log_level The most verbose level logged.
+ */
+TAPI log_level LogGetChannelLevel(log_channel channel);
+
 TAPI void LogOutput(log_level level, const char* message, ...);
 
-#ifndef TERROR
-// Logs a fatal-level message.
+// Types an argument is recorded as by binary logging, after default argument promotion.
+typedef enum log_arg_type {
+    LOG_ARG_S32 = 1,
+    LOG_ARG_U32 = 2,
+    LOG_ARG_S64 = 3,
+    LOG_ARG_U64 = 4,
+    LOG_ARG_F64 = 5,
+    // Copied by value, since the pointer may not outlive the call.
+    LOG_ARG_STRING = 6,
+    LOG_ARG_POINTER = 7
+} log_arg_type;
+
+// The maximum number of arguments a single binary log call can take.
+#define LOG_BINARY_MAX_ARGS 12
+
+/**
+ * @brief Registers a format string for binary logging. Each call site registers
+ * once, the first time it is hit, and keeps the ID in formatId.
+ * 
+ * @param formatId A pointer to the call site's ID. Filled in on first registration.
+ * @param format The format string. Must have static storage duration.
+ * @return u32 The format's ID, or 0 if no more formats can be registered.
+ */
+TAPI u32 LogRegisterFormat(u32* formatId, const char* format);
+
+/**
+ * @brief Looks up a format string registered with LogRegisterFormat.
+ * 
+ * @param formatId The ID of the format.
+ * @return const char* The format string, or 0 if the ID is unknown.
+ */
+TAPI const char* LogGetFormat(u32 formatId);
+
+/**
+ * @brief Records a binary log message. Called by the logging macros; use those instead.
+ * 
+ * @param level The level of the message.
+ * @param formatId A pointer to the call site's format ID.
+ * @param format The format string.
+ * @param argTypes The argument types, as built by LOG_ARG_TYPES.
+ */
+TAPI void LogOutputBinary(log_level level, u32* formatId, const char* format, u64 argTypes, ...);
+
+/**
+ * @brief Packs a format ID and arguments into a binary log record. Strings which
+ * do not fit are truncated.
+ * 
+ * @param dest The destination for the record.
+ * @param destSize The size of dest in bytes.
+ * @param formatId The ID of a registered format.
+ * @param argTypes The argument types, as built by LOG_ARG_TYPES.
+ * @return u64 The size of the record in bytes.
+ */
+TAPI u64 LogBinaryEncode(void* dest, u64 destSize, u32 formatId, u64 argTypes, ...);
+
+/**
+ * @brief Turns a binary log record back into text.
+ * 
+ * @param record The record, as written by LogBinaryEncode.
+ * @param recordSize The size of the record in bytes.
+ * @param dest The destination for the text.
+ * @param destSize The size of dest in bytes.
+ * @return u64 The number of characters written, not including the null terminator.
+ */
+TAPI u64 LogBinaryDecode(const void* record, u64 recordSize, char* dest, u64 destSize);
+
+// Resolves to the log_arg_type an argument is passed as. long double is not supported.
+#define LOG_ARG_TYPE(arg) _Generic((arg),                                              \
+    _Bool: LOG_ARG_S32, char: LOG_ARG_S32, signed char: LOG_ARG_S32,                  \
+    unsigned char: LOG_ARG_S32, short: LOG_ARG_S32, unsigned short: LOG_ARG_S32,      \
+    int: LOG_ARG_S32, unsigned int: LOG_ARG_U32,                                      \
+    long: (sizeof(long) == 8 ? LOG_ARG_S64 : LOG_ARG_S32),                            \
+    unsigned long: (sizeof(long) == 8 ? LOG_ARG_U64 : LOG_ARG_U32),                   \
+    long long: LOG_ARG_S64, unsigned long long: LOG_ARG_U64,                          \
+    float: LOG_ARG_F64, double: LOG_ARG_F64,                                          \
+    char*: LOG_ARG_STRING, const char*: LOG_ARG_STRING,                               \
+    default: LOG_ARG_POINTER)
+
+#define LOG_ARG_COUNT(...) LOG_ARG_COUNT_(_, ##__VA_ARGS__, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_ARG_COUNT_(_, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, count, ...) count
+
+#define LOG_ARG_SHIFT(index, arg) | ((u64)LOG_ARG_TYPE(arg) << (4 * index))
+#define LOG_EACH_0(m)
+#define LOG_EACH_1(m, a) m(1, a)
+#define LOG_EACH_2(m, a, ...) m(2, a) LOG_EACH_1(m, __VA_ARGS__)
+#define LOG_EACH_3(m, a, ...) m(3, a) LOG_EACH_2(m, __VA_ARGS__)
+#define LOG_EACH_4(m, a, ...) m(4, a) LOG_EACH_3(m, __VA_ARGS__)
+#define LOG_EACH_5(m, a, ...) m(5, a) LOG_EACH_4(m, __VA_ARGS__)
+#define LOG_EACH_6(m, a, ...) m(6, a) LOG_EACH_5(m, __VA_ARGS__)
+#define LOG_EACH_7(m, a, ...) m(7, a) LOG_EACH_6(m, __VA_ARGS__)
+#define LOG_EACH_8(m, a, ...) m(8, a) LOG_EACH_7(m, __VA_ARGS__)
+#define LOG_EACH_9(m, a, ...) m(9, a) LOG_EACH_8(m, __VA_ARGS__)
+#define LOG_EACH_10(m, a, ...) m(10, a) LOG_EACH_9(m, __VA_ARGS__)
+#define LOG_EACH_11(m, a, ...) m(11, a) LOG_EACH_10(m, __VA_ARGS__)
+#define LOG_EACH_12(m, a, ...) m(12, a) LOG_EACH_11(m, __VA_ARGS__)
+#define LOG_CONCAT(a, b) LOG_CONCAT_(a, b)
+#define LOG_CONCAT_(a, b) a##b
+
+/**
+ * Builds the argTypes descriptor for LogOutputBinary at compile time. None of
+ * the arguments are evaluated. The argument count is in the lowest 4 bits; the
+ * type of the last argument is in the next 4 bits, working back to the first.
+ */
+#define LOG_ARG_TYPES(...) ((u64)LOG_ARG_COUNT(__VA_ARGS__) LOG_ARG_TYPES_(LOG_ARG_COUNT(__VA_ARGS__), ##__VA_ARGS__))
+#define LOG_ARG_TYPES_(count, ...) LOG_CONCAT(LOG_EACH_, count)(LOG_ARG_SHIFT, ##__VA_ARGS__)
+
+// Records a message in binary form. The format must be a string literal.
+#define LOG_BINARY(level, message, ...)                                                              \
+    do                                                                                               \
+    {                                                                                                \
+        static u32 logFormatId = 0;                                                                  \
+        LogOutputBinary(level, &logFormatId, "" message, LOG_ARG_TYPES(__VA_ARGS__), ##__VA_ARGS__); \
+    } while (0)
+
+// True when messages of the given level are logged on the given channel. This single
+// branch is all a filtered-out message costs; its arguments are never evaluated.
+#define LOG_LEVEL_ENABLED(channel, level) \
+    __builtin_expect(AtomicLoad8(&logChannelLevels[channel], ATOMIC_RELAXED) >= (level), (level) <= LOG_LEVEL_WARN)
+
+#define LOG_FILTERED(channel, level, logCall) \
+    do                                        \
+    {                                         \
+        if (LOG_LEVEL_ENABLED(channel, level)) \
+        {                                     \
+            logCall;                          \
+        }                                     \
+    } while (0)
+
+#ifndef TFATAL
+// Logs a fatal-level message. Never filtered.
 #define TFATAL(message, ...) LogOutput(LOG_LEVEL_FATAL, message, ##__VA_ARGS__);
 #endif
 
 #ifndef TERROR
-// Logs an error-level message.
+// Logs an error-level message. Never filtered.
 #define TERROR(message, ...) LogOutput(LOG_LEVEL_ERROR, message, ##__VA_ARGS__);
 #endif
 
 #if LOG_WARN_ENABLED == 1
-// Logs a warning-level message.
-#define TWARN(message, ...) LogOutput(LOG_LEVEL_WARN, message, ##__VA_ARGS__);
+// Logs a warning-level message on the given channel.
+#define TWARN_CH(channel, message, ...) LOG_FILTERED(channel, LOG_LEVEL_WARN, LogOutput(LOG_LEVEL_WARN, message, ##__VA_ARGS__))
 #else
 // Does nothing when LOG_WARN_ENABLED != 1
-#define TWARN(message, ...)
+#define TWARN_CH(channel, message, ...)
 #endif
 
 #if LOG_INFO_ENABLED == 1
-// Logs a info-level message.
-#define TINFO(message, ...) LogOutput(LOG_LEVEL_INFO, message, ##__VA_ARGS__);
+// Logs a info-level message on the given channel.
+#define TINFO_CH(channel, message, ...) LOG_FILTERED(channel, LOG_LEVEL_INFO, LogOutput(LOG_LEVEL_INFO, message, ##__VA_ARGS__))
 #else
 // Does nothing when LOG_INFO_ENABLED != 1
-#define TINFO(message, ...)
+#define TINFO_CH(channel, message, ...)
 #endif
 
-#if LOG_DEBUG_ENABLED == 1
-// Logs a debug-level message.
-#define TDEBUG(message, ...) LogOutput(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__);
+#if LOG_DEBUG_ENABLED == 1 && LOG_BINARY_ENABLED == 1
+// Logs a debug-level message on the given channel. The message must be a string literal.
+#define TDEBUG_CH(channel, message, ...) LOG_FILTERED(channel, LOG_LEVEL_DEBUG, LOG_BINARY(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__))
+#elif LOG_DEBUG_ENABLED == 1
+// Logs a debug-level message on the given channel.
+#define TDEBUG_CH(channel, message, ...) LOG_FILTERED(channel, LOG_LEVEL_DEBUG, LogOutput(LOG_LEVEL_DEBUG, message, ##__VA_ARGS__))
 #else
 // Does nothing when LOG_DEBUG_ENABLED != 1
-#define TDEBUG(message, ...)
+#define TDEBUG_CH(channel, message, ...)
 #endif
 
-#if LOG_TRACE_ENABLED == 1
-// Logs a trace-level message.
-#define TTRACE(message, ...) LogOutput(LOG_LEVEL_TRACE, message, ##__VA_ARGS__);
+#if LOG_TRACE_ENABLED == 1 && LOG_BINARY_ENABLED == 1
+// Logs a trace-level message on the given channel. The message must be a string literal.
+#define TTRACE_CH(channel, message, ...) LOG_FILTERED(channel, LOG_LEVEL_TRACE, LOG_BINARY(LOG_LEVEL_TRACE, message, ##__VA_ARGS__))
+#elif LOG_TRACE_ENABLED == 1
+// Logs a trace-level message on the given channel.
+#define TTRACE_CH(channel, message, ...) LOG_FILTERED(channel, LOG_LEVEL_TRACE, LogOutput(LOG_LEVEL_TRACE, message, ##__VA_ARGS__))
 #else
 // Does nothing when LOG_TRACE_ENABLED != 1
-#define TTRACE(message, ...)
-#endif
\ No newline at end of file
+#define TTRACE_CH(channel, message, ...)
+#endif
+
+// Logs a warning-level message on the file's channel.
+#define TWARN(message, ...) TWARN_CH(LOG_CHANNEL, message, ##__VA_ARGS__)
+// Logs a info-level message on the file's channel.
+#define TINFO(message, ...) TINFO_CH(LOG_CHANNEL, message, ##__VA_ARGS__)
+// Logs a debug-level message on the file's channel.
+#define TDEBUG(message, ...) TDEBUG_CH(LOG_CHANNEL, message, ##__VA_ARGS__)
+// Logs a trace-level message on the file's channel.
+#define TTRACE(message, ...) TTRACE_CH(LOG_CHANNEL, message, ##__VA_ARGS__)
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include "Core/Parallel.h"
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include "Core/TMemory.h"
+#include "Platform/Atomic.h"
+
+// With an automatic grain, aim for this many chunks per worker, so a slow
+// worker holds the rest up by no more than a small slice of the work.
+#define PARALLEL_CHUNKS_PER_WORKER 8
+
+// The state shared by every thread taking part in one ParallelFor or ParallelReduce.
+typedef struct parallel_context
+{
+    u64 count;
+    u64 grainSize;
+    // The next chunk to be claimed.
+    u64 nextChunk;
+    u64 chunkCount;
+    PFN_parallel_for forFn;
+    PFN_parallel_reduce reduceFn;
+    void* userData;
+    // For reductions, one cache line per participant so their partials do not contend.
+    u8 (*partials)[PARALLEL_REDUCE_MAX_RESULT_SIZE];
+} parallel_context;
+
+typedef struct parallel_helper
+{
+    parallel_context* context;
+    u32 participant;
+} parallel_helper;
+
+// Claims and processes chunks until none are left.
+static void ProcessChunks(parallel_context* context, u32 participant)
+{
+    for (;;)
+    {
+        u64 chunk = AtomicFetchAdd64(&context->nextChunk, 1, ATOMIC_RELAXED);
+        if (chunk >= context->chunkCount) return;
+
+        u64 start = chunk * context->grainSize;
+        u64 end = start + context->grainSize;
+        if (end > context->count) end = context->count;
+
+        if (context->reduceFn)
+            context->reduceFn(start, end, context->partials[participant], context->userData);
+        else
+            context->forFn(start, end, context->userData);
+    }
+}
+
+static void HelperJob(void* params)
+{
+    parallel_helper* helper = params;
+    ProcessChunks(helper->context, helper->participant);
+}
+
+// Works out the grain and chunk count, and returns how many helper jobs are worth submitting.
+static u32 PrepareContext(parallel_context* context, u64 count, u64 grainSize)
+{
+    u32 workerCount = JobSystemGetWorkerCount();
+    if (grainSize == 0)
+    {
+        grainSize = count / ((u64)workerCount * PARALLEL_CHUNKS_PER_WORKER);
+        if (grainSize == 0) grainSize = 1;
+    }
+
+    context->count = count;
+    context->grainSize = grainSize;
+    context->nextChunk = 0;
+    context->chunkCount = (count + grainSize - 1) / grainSize;
+
+    // Never more helpers than there are chunks beyond the caller's first.
+    u64 helperCount = workerCount - 1;
+    if (helperCount > context->chunkCount - 1) helperCount = context->chunkCount - 1;
+    return (u32)helperCount;
+}
+
+// Runs the chunks across the caller and helperCount helper jobs, returning once all are done.
+static void Run(parallel_context* context, u32 helperCount)
+{
+    parallel_helper helpers[JOB_MAX_WORKERS];
+    job_desc jobs[JOB_MAX_WORKERS];
+    for (u32 i = 0; i < helperCount; i++)
+    {
+        // The caller is participant 0.
+        helpers[i].context = context;
+        helpers[i].participant = i + 1;
+        jobs[i].entry = HelperJob;
+        jobs[i].params = &helpers[i];
+        jobs[i].priority = JOB_PRIORITY_HIGH;
+    }
+
+    job_counter counter = {0};
+    JobSubmit(jobs, helperCount, &counter);
+    ProcessChunks(context, 0);
+
+    // Helpers which start after the last chunk was claimed return straight away.
+    JobWait(&counter);
+}
+
+void ParallelFor(u64 count, u64 grainSize, PFN_parallel_for fn, void* userData)
+{
+    if (count == 0) return;
+
+    parallel_context context = {0};
+    context.forFn = fn;
+    context.userData = userData;
+    u32 helperCount = PrepareContext(&context, count, grainSize);
+    if (helperCount == 0)
+    {
+        fn(0, count, userData);
+        return;
+    }
+
+    Run(&context, helperCount);
+}
+
+b8 ParallelReduce(
+    u64 count,
+    u64 grainSize,
+    u64 resultSize,
+    const void* identity,
+    PFN_parallel_reduce reduce,
+    PFN_parallel_combine combine,
+    void* result,
+    void* userData)
+{
+    if (resultSize > PARALLEL_REDUCE_MAX_RESULT_SIZE)
+    {
+        TERROR("ParallelReduce - resultSize of %llu exceeds the limit of %u bytes.", resultSize, PARALLEL_REDUCE_MAX_RESULT_SIZE);
+        return false;
+    }
+    if (count == 0) return true;
+
+    _Alignas(64) u8 partials[JOB_MAX_WORKERS][PARALLEL_REDUCE_MAX_RESULT_SIZE];
+    parallel_context context = {0};
+    context.reduceFn = reduce;
+    context.userData = userData;
+    context.partials = partials;
+    u32 helperCount = PrepareContext(&context, count, grainSize);
+
+    for (u32 i = 0; i <= helperCount; i++)
+    {
+        TCopyMemory(partials[i], identity, resultSize);
+    }
+
+    if (helperCount == 0)
+    {
+        reduce(0, count, partials[0], userData);
+    }
+    else
+    {
+        Run(&context, helperCount);
+    }
+
+    for (u32 i = 0; i <= helperCount; i++)
+    {
+        combine(result, partials[i], userData);
+    }
+    return true;
+}
\ No newline at end of file
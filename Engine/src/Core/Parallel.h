@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Data-parallel loops on top of the job system.
+
+The range [0, count) is cut into chunks of grainSize items. Helper jobs are
+submitted, one per other worker, and they and the calling thread then claim
+chunks one at a time until none are left. Whoever is fastest takes the most
+chunks, so uneven work balances itself out, and the caller always does its
+share, finishing off whatever the helpers have not claimed. Both functions
+return once every item has been processed.
+
+If the job system is not running, or the range fits in a single chunk, the
+whole range runs on the calling thread with no jobs at all.
+*/
+
+// The largest result ParallelReduce can produce, in bytes. Enough for a mat4.
+#define PARALLEL_REDUCE_MAX_RESULT_SIZE 64
+
+/**
+ * @brief Processes the items in [start, end).
+ *
+ * @param start The first item to process.
+ * @param end One past the last item to process.
+ * @param userData The user data passed to ParallelFor.
+ */
+typedef void (*PFN_parallel_for)(u64 start, u64 end, void* userData);
+
+/**
+ * @brief Folds the items in [start, end) into a partial result.
+ *
+ * @param start The first item to process.
+ * @param end One past the last item to process.
+ * @param partial The partial result to fold into. Starts as a copy of the identity.
+ * @param userData The user data passed to ParallelReduce.
+ */
+typedef void (*PFN_parallel_reduce)(u64 start, u64 end, void* partial, void* userData);
+
+/**
+ * @brief Folds a partial result into the final result. Partial results are combined in
+ * no particular order, so this must be associative and commutative.
+ *
+ * @param result The result to fold into.
+ * @param partial A partial result produced by PFN_parallel_reduce.
+ * @param userData The user data passed to ParallelReduce.
+ */
+typedef void (*PFN_parallel_combine)(void* result, const void* partial, void* userData);
+
+/**
+ * @brief Calls fn over [0, count) in chunks, spread across the job system's workers.
+ *
+ * @param count The number of items.
+ * @param grainSize The number of items in each chunk, or 0 to pick one from the worker count.
+ * Larger grains cost less to hand out; smaller ones balance better.
+ * @param fn The function to call for each chunk. Called from several threads at once.
+ * @param userData Passed as-is to fn.
+ */
+TAPI void ParallelFor(u64 count, u64 grainSize, PFN_parallel_for fn, void* userData);
+
+/**
+ * @brief Reduces [0, count) to a single value, spread across the job system's workers.
+ * Each participating thread folds the chunks it claims into its own partial result,
+ * and the partial results are then combined into result on the calling thread.
+ *
+ * @param count The number of items.
+ * @param grainSize The number of items in each chunk, or 0 to pick one from the worker count.
+ * @param resultSize The size of the result, in bytes. At most PARALLEL_REDUCE_MAX_RESULT_SIZE.
+ * @param identity The value each partial result starts from, such as 0 for a sum.
+ * @param reduce The function folding each chunk into a partial result. Called from several threads at once.
+ * @param combine The function folding each partial result into result.
+ * @param result The result to combine into. Its value on entry is kept, so usually start it at the identity.
+ * @param userData Passed as-is to reduce and combine.
+ * @return b8 True on success; false if resultSize is too large.
+ */
+TAPI b8 ParallelReduce(
+    u64 count,
+    u64 grainSize,
+    u64 resultSize,
+    const void* identity,
+    PFN_parallel_reduce reduce,
+    PFN_parallel_combine combine,
+    void* result,
+    void* userData);
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "Core/Profiler.h"
+#include "Core/Logger.h"
+#include "Core/TMemory.h"
+#include "Core/TString.h"
+#include "Platform/Platform.h"
+#include "Platform/Atomic.h"
+#include "Platform/Filesystem.h"
+
+// Zones are gathered here while being written out, to keep writes down.
+#define TRACE_WRITE_BUFFER_SIZE (64 * 1024)
+
+// The longest a single line of the trace can be, including an escaped name.
+#define TRACE_MAX_LINE_LENGTH 512
+
+typedef struct profile_record
+{
+    const char* name;
+    u64 start;
+    u64 end;
+} profile_record;
+
+typedef struct profile_thread
+{
+    u64 threadId;
+    char name[32];
+    // The number of zones recorded. Only its own thread writes this; the latest
+    // PROFILER_ZONES_PER_THREAD zones are held in records.
+    u64 head;
+    profile_record* records;
+} profile_thread;
+
+typedef struct profiler_state
+{
+    u8 isEnabled;
+    // Timestamps are written out relative to this, so traces start at 0.
+    u64 startTimestamp;
+    // Held while registering a thread.
+    platform_mutex lock;
+    u32 threadCount;
+    profile_thread threads[PROFILER_MAX_THREADS];
+} profiler_state;
+
+static profiler_state* statePtr;
+
+// Bumped by each initialization, so threads notice their buffer is from an earlier one and gone.
+static u32 generation;
+
+// The calling thread's buffer, valid if threadGeneration matches generation. May be 0 if
+// there was no room for the thread.
+static _Thread_local profile_thread* threadBuffer;
+static _Thread_local u32 threadGeneration;
+
+b8 ProfilerInitialize(u64* memoryRequirement, void* state)
+{
+    *memoryRequirement = sizeof(profiler_state);
+    if (state == 0) return true;
+
+    TZeroMemory(state, sizeof(profiler_state));
+    statePtr = state;
+    if (!PlatformMutexCreate(&statePtr->lock))
+    {
+        TERROR("ProfilerInitialize - failed to create the mutex.");
+        statePtr = 0;
+        return false;
+    }
+
+    AtomicFetchAdd32(&generation, 1, ATOMIC_RELEASE);
+    statePtr->startTimestamp = PlatformGetTimestampNs();
+    statePtr->isEnabled = true;
+    return true;
+}
+
+void ProfilerShutdown(void* state)
+{
+    if (!statePtr) return;
+
+    for (u32 i = 0; i < statePtr->threadCount; i++)
+    {
+        TFree(statePtr->threads[i].records, sizeof(profile_record) * PROFILER_ZONES_PER_THREAD, MEMORY_TAG_PROFILER);
+    }
+    PlatformMutexDestroy(&statePtr->lock);
+    statePtr = 0;
+}
+
+void ProfilerSetEnabled(b8 enabled)
+{
+    if (statePtr) AtomicStore8(&statePtr->isEnabled, enabled, ATOMIC_RELAXED);
+}
+
+// Gets the calling thread's buffer, registering the thread the first time it is called.
+static profile_thread* CurrentThread()
+{
+    u32 currentGeneration = AtomicLoad32(&generation, ATOMIC_ACQUIRE);
+    if (threadGeneration == currentGeneration) return threadBuffer;
+
+    PlatformMutexLock(&statePtr->lock);
+    profile_thread* thread = 0;
+    if (statePtr->threadCount < PROFILER_MAX_THREADS)
+    {
+        thread = &statePtr->threads[statePtr->threadCount];
+        thread->records = TAllocate(sizeof(profile_record) * PROFILER_ZONES_PER_THREAD, MEMORY_TAG_PROFILER);
+        thread->threadId = PlatformThreadGetCurrentId();
+        StringFormatN(thread->name, sizeof(thread->name), "Thread %llu", thread->threadId);
+        // Published last, so the writer only ever sees threads which are ready.
+        AtomicStore32(&statePtr->threadCount, statePtr->threadCount + 1, ATOMIC_RELEASE);
+    }
+    else
+    {
+        TWARN("The profiler is already recording %u threads; zones on thread %llu are left out.", PROFILER_MAX_THREADS, PlatformThreadGetCurrentId());
+    }
+    PlatformMutexUnlock(&statePtr->lock);
+
+    threadBuffer = thread;
+    threadGeneration = currentGeneration;
+    return thread;
+}
+
+void ProfilerSetThreadName(const char* name)
+{
+    if (!statePtr) return;
+
+    profile_thread* thread = CurrentThread();
+    if (thread) StringFormatN(thread->name, sizeof(thread->name), "%s", name);
+}
+
+profile_zone ProfilerZoneBegin(const char* name)
+{
+    profile_zone zone;
+    zone.name = name;
+    zone.start = statePtr && AtomicLoad8(&statePtr->isEnabled, ATOMIC_RELAXED) ? PlatformGetTimestampNs() : 0;
+    return zone;
+}
+
+void ProfilerZoneEnd(profile_zone* zone)
+{
+    // Also skips zones begun before the profiler was enabled.
+    if (!zone->start || !statePtr || !AtomicLoad8(&statePtr->isEnabled, ATOMIC_RELAXED)) return;
+
+    u64 end = PlatformGetTimestampNs();
+    profile_thread* thread = CurrentThread();
+    if (!thread) return;
+
+    u64 head = thread->head;
+    profile_record* record = &thread->records[head & (PROFILER_ZONES_PER_THREAD - 1)];
+    record->name = zone->name;
+    record->start = zone->start;
+    record->end = end;
+    AtomicStore64(&thread->head, head + 1, ATOMIC_RELEASE);
+}
+
+typedef struct trace_writer
+{
+    file_handle file;
+    char* buffer;
+    u64 length;
+    b8 failed;
+} trace_writer;
+
+static void FlushTrace(trace_writer* writer)
+{
+    u64 written = 0;
+    if (writer->length && !FilesystemWrite(&writer->file, writer->length, writer->buffer, &written))
+    {
+        writer->failed = true;
+    }
+    writer->length = 0;
+}
+
+// Makes sure there is room for a line in the buffer.
+static char* ReserveLine(trace_writer* writer)
+{
+    if (writer->length + TRACE_MAX_LINE_LENGTH > TRACE_WRITE_BUFFER_SIZE) FlushTrace(writer);
+    return writer->buffer + writer->length;
+}
+
+// Writes a name as the inside of a JSON string, dropping anything which would need escaping.
+static u64 WriteName(char* dest, const char* name)
+{
+    u64 length = 0;
+    for (; *name && length < TRACE_MAX_LINE_LENGTH / 2; name++)
+    {
+        if (*name == '"' || *name == '\\' || (u8)*name < 0x20) continue;
+        dest[length++] = *name;
+    }
+    return length;
+}
+
+b8 ProfilerWriteChromeTrace(const char* path)
+{
+    if (!statePtr) return false;
+
+    trace_writer writer = {0};
+    if (!FilesystemOpen(path, FILE_MODE_WRITE, false, &writer.file))
+    {
+        TERROR("ProfilerWriteChromeTrace - unable to open '%s' for writing.", path);
+        return false;
+    }
+
+    writer.buffer = TAllocate(TRACE_WRITE_BUFFER_SIZE, MEMORY_TAG_PROFILER);
+    u64 snapshotSize = sizeof(profile_record) * PROFILER_ZONES_PER_THREAD;
+    profile_record* snapshot = TAllocate(snapshotSize, MEMORY_TAG_PROFILER);
+
+    writer.length = StringFormatN(writer.buffer, TRACE_WRITE_BUFFER_SIZE, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    b8 first = true;
+    u64 zoneCount = 0;
+    u32 threadCount = AtomicLoad32(&statePtr->threadCount, ATOMIC_ACQUIRE);
+    for (u32 t = 0; t < threadCount; t++)
+    {
+        profile_thread* thread = &statePtr->threads[t];
+
+        char* line = ReserveLine(&writer);
+        u64 length = StringFormatN(line, TRACE_MAX_LINE_LENGTH, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":0,\"tid\":%llu,\"args\":{\"name\":\"", first ? "" : ",\n", thread->threadId);
+        length += WriteName(line + length, thread->name);
+        length += StringFormatN(line + length, TRACE_MAX_LINE_LENGTH - length, "\"}}");
+        writer.length += length;
+        first = false;
+
+        // Copy the zones out, then drop any the thread overwrote while they were being copied.
+        u64 head = AtomicLoad64(&thread->head, ATOMIC_ACQUIRE);
+        u64 begin = head > PROFILER_ZONES_PER_THREAD ? head - PROFILER_ZONES_PER_THREAD : 0;
+        for (u64 i = begin; i < head; i++)
+        {
+            snapshot[i - begin] = thread->records[i & (PROFILER_ZONES_PER_THREAD - 1)];
+        }
+        AtomicThreadFence(ATOMIC_ACQUIRE);
+        u64 newHead = AtomicLoad64(&thread->head, ATOMIC_ACQUIRE);
+        u64 valid = newHead > PROFILER_ZONES_PER_THREAD ? newHead - PROFILER_ZONES_PER_THREAD : 0;
+        if (valid < begin) valid = begin;
+
+        for (u64 i = valid; i < head; i++)
+        {
+            profile_record* record = &snapshot[i - begin];
+            line = ReserveLine(&writer);
+            length = StringFormatN(line, TRACE_MAX_LINE_LENGTH, ",\n{\"ph\":\"X\",\"name\":\"");
+            length += WriteName(line + length, record->name);
+            length += StringFormatN(line + length, TRACE_MAX_LINE_LENGTH - length, "\",\"pid\":0,\"tid\":%llu,\"ts\":%.3f,\"dur\":%.3f}", thread->threadId,
+                                   (f64)(record->start - statePtr->startTimestamp) / 1000.0, (f64)(record->end - record->start) / 1000.0);
+            writer.length += length;
+            zoneCount++;
+        }
+    }
+
+    char* end = ReserveLine(&writer);
+    writer.length += StringFormatN(end, TRACE_MAX_LINE_LENGTH, "\n]}\n");
+    FlushTrace(&writer);
+    FilesystemClose(&writer.file);
+
+    TFree(snapshot, snapshotSize, MEMORY_TAG_PROFILER);
+    TFree(writer.buffer, TRACE_WRITE_BUFFER_SIZE, MEMORY_TAG_PROFILER);
+
+    if (writer.failed)
+    {
+        TERROR("ProfilerWriteChromeTrace - failed writing to '%s'.", path);
+        return false;
+    }
+
+    TINFO("Wrote %llu profiled zones from %u threads to '%s'.", zoneCount, threadCount, path);
+    return true;
+}
\ No newline at end of file
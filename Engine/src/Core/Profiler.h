@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Instrumentation profiler.
+
+Code marks the zones it wants timed with TPROFILE_SCOPE, which records when
+the enclosing scope is entered and left. Each thread writes its zones to its
+own ring buffer, without locking, so only the latest PROFILER_ZONES_PER_THREAD
+zones of each thread are kept. ProfilerWriteChromeTrace writes what is held
+out in the Chrome Trace Event format, for chrome://tracing or Perfetto.
+
+With TPROFILE_ENABLED set to 0, every zone compiles to nothing.
+*/
+
+// Whether profiling zones are compiled in. Release builds leave them out unless asked for.
+#ifndef TPROFILE_ENABLED
+#if TRELEASE == 1
+#define TPROFILE_ENABLED 0
+#else
+#define TPROFILE_ENABLED 1
+#endif
+#endif
+
+// The most threads which can record zones.
+#define PROFILER_MAX_THREADS 64
+
+// The zones kept per thread. Older ones are overwritten. Must be a power of 2.
+#define PROFILER_ZONES_PER_THREAD 16384
+
+// A zone in progress.
+typedef struct profile_zone
+{
+    // Must outlive the profiler; a string literal is best.
+    const char* name;
+    // When the zone began, in nanoseconds, or 0 if it is not being recorded.
+    u64 start;
+} profile_zone;
+
+/**
+ * @brief Initializes the profiler. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state. Zones are recorded from then on.
+ *
+ * @param memoryRequirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @return b8 True on success; otherwise false.
+ */
+b8 ProfilerInitialize(u64* memoryRequirement, void* state);
+
+/**
+ * @brief Shuts down the profiler, freeing every thread's zones. No thread may be recording
+ * a zone while this runs.
+ *
+ * @param state A pointer to the system's state.
+ */
+void ProfilerShutdown(void* state);
+
+/**
+ * @brief Pauses or resumes recording zones. Can be called from any thread.
+ *
+ * @param enabled True to record zones; false to ignore them.
+ */
+TAPI void ProfilerSetEnabled(b8 enabled);
+
+/**
+ * @brief Names the calling thread in exported traces.
+ *
+ * @param name The thread's name. Copied, and cut short if long.
+ */
+TAPI void ProfilerSetThreadName(const char* name);
+
+/**
+ * @brief Begins a zone. Prefer TPROFILE_SCOPE, which ends it automatically.
+ *
+ * @param name The zone's name. Must outlive the profiler; a string literal is best.
+ * @return profile_zone The zone, to pass to ProfilerZoneEnd.
+ */
+TAPI profile_zone ProfilerZoneBegin(const char* name);
+
+/**
+ * @brief Ends a zone, recording it against the calling thread.
+ *
+ * @param zone A pointer to the zone returned by ProfilerZoneBegin.
+ */
+TAPI void ProfilerZoneEnd(profile_zone* zone);
+
+/**
+ * @brief Writes every zone held to a file as Chrome Trace Event JSON. Threads can keep
+ * recording meanwhile; zones they overwrite during the write are left out.
+ *
+ * @param path The path of the file to write.
+ * @return b8 True on success; otherwise false.
+ */
+TAPI b8 ProfilerWriteChromeTrace(const char* path);
+
+#if TPROFILE_ENABLED
+
+#define TPROFILE_CONCAT_INNER(a, b) a##b
+#define TPROFILE_CONCAT(a, b) TPROFILE_CONCAT_INNER(a, b)
+
+// Times the rest of the enclosing scope as a zone with the given name.
+#define TPROFILE_SCOPE(name) \
+    profile_zone TPROFILE_CONCAT(profileZone, __LINE__) __attribute__((cleanup(ProfilerZoneEnd))) = ProfilerZoneBegin(name)
+
+// Times the rest of the enclosing function, as a zone named after it.
+#define TPROFILE_FUNCTION() TPROFILE_SCOPE(__func__)
+
+// Explicitly begins and ends a zone, for spans which do not match a scope.
+#define TPROFILE_BEGIN(zone, name) profile_zone zone = ProfilerZoneBegin(name)
+#define TPROFILE_END(zone) ProfilerZoneEnd(&zone)
+
+#else
+
+#define TPROFILE_SCOPE(name)
+#define TPROFILE_FUNCTION()
+#define TPROFILE_BEGIN(zone, name)
+#define TPROFILE_END(zone)
+
+#endif
\ No newline at end of file
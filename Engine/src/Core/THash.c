@@ -0,0 +1,362 @@
+#include "Core/THash.h"
+#include "Core/TMemory.h"
+
+#define PRIME32_1 0x9E3779B1U
+#define PRIME32_2 0x85EBCA77U
+#define PRIME32_3 0xC2B2AE3DU
+#define PRIME32_4 0x27D4EB2FU
+#define PRIME32_5 0x165667B1U
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define ROTL32(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+#define ROTL64(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+
+// NOTE: Reads go through __builtin_memcpy so that unaligned input is legal, while
+// still compiling down to a single load. The digests are defined on little-endian
+// input, so big-endian targets byte-swap after loading.
+TINLINE u32 Read32(const u8* p)
+{
+    u32 value;
+    __builtin_memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+TINLINE u64 Read64(const u8* p)
+{
+    u64 value;
+    __builtin_memcpy(&value, p, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// 32-bit
+// ---------------------------------------------------------------------------
+
+TINLINE u32 Round32(u32 acc, u32 input)
+{
+    acc += input * PRIME32_2;
+    acc = ROTL32(acc, 13);
+    acc *= PRIME32_1;
+    return acc;
+}
+
+TINLINE u32 Avalanche32(u32 h)
+{
+    h ^= h >> 15;
+    h *= PRIME32_2;
+    h ^= h >> 13;
+    h *= PRIME32_3;
+    h ^= h >> 16;
+    return h;
+}
+
+// Consumes the final (< 16) bytes and mixes the result.
+static u32 Finalize32(u32 h, const u8* p, u64 length)
+{
+    while (length >= 4)
+    {
+        h += Read32(p) * PRIME32_3;
+        h = ROTL32(h, 17) * PRIME32_4;
+        p += 4;
+        length -= 4;
+    }
+
+    while (length > 0)
+    {
+        h += (*p) * PRIME32_5;
+        h = ROTL32(h, 11) * PRIME32_1;
+        p++;
+        length--;
+    }
+
+    return Avalanche32(h);
+}
+
+// Consumes as many whole 16-byte stripes as possible, returning the first unconsumed byte.
+static const u8* Consume32(u32* v, const u8* p, const u8* limit)
+{
+    u32 v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    do
+    {
+        v1 = Round32(v1, Read32(p));
+        v2 = Round32(v2, Read32(p + 4));
+        v3 = Round32(v3, Read32(p + 8));
+        v4 = Round32(v4, Read32(p + 12));
+        p += 16;
+    } while (p <= limit);
+
+    v[0] = v1;
+    v[1] = v2;
+    v[2] = v3;
+    v[3] = v4;
+    return p;
+}
+
+u32 Hash32(const void* data, u64 length, u32 seed)
+{
+    const u8* p = (const u8*)data;
+    u32 h;
+
+    if (length >= 16)
+    {
+        u32 v[4] = {seed + PRIME32_1 + PRIME32_2, seed + PRIME32_2, seed, seed - PRIME32_1};
+        p = Consume32(v, p, p + length - 16);
+        h = ROTL32(v[0], 1) + ROTL32(v[1], 7) + ROTL32(v[2], 12) + ROTL32(v[3], 18);
+    }
+    else
+    {
+        h = seed + PRIME32_5;
+    }
+
+    h += (u32)length;
+    return Finalize32(h, p, length & 15);
+}
+
+void Hash32Reset(hash32_state* state, u32 seed)
+{
+    TZeroMemory(state, sizeof(hash32_state));
+    state->seed = seed;
+    state->v[0] = seed + PRIME32_1 + PRIME32_2;
+    state->v[1] = seed + PRIME32_2;
+    state->v[2] = seed;
+    state->v[3] = seed - PRIME32_1;
+}
+
+void Hash32Update(hash32_state* state, const void* data, u64 length)
+{
+    if (length == 0) return;
+
+    const u8* p = (const u8*)data;
+    const u8* end = p + length;
+    state->totalLength += length;
+
+    // Not enough for a full stripe yet, just stash it.
+    if (state->bufferSize + length < 16)
+    {
+        TCopyMemory(state->buffer + state->bufferSize, p, length);
+        state->bufferSize += (u32)length;
+        return;
+    }
+
+    // Complete the partially filled stripe first.
+    if (state->bufferSize)
+    {
+        u32 fill = 16 - state->bufferSize;
+        TCopyMemory(state->buffer + state->bufferSize, p, fill);
+        Consume32(state->v, state->buffer, state->buffer);
+        p += fill;
+        state->bufferSize = 0;
+    }
+
+    if (end - p >= 16)
+    {
+        p = Consume32(state->v, p, end - 16);
+    }
+
+    if (p < end)
+    {
+        state->bufferSize = (u32)(end - p);
+        TCopyMemory(state->buffer, p, state->bufferSize);
+    }
+}
+
+u32 Hash32Digest(const hash32_state* state)
+{
+    u32 h;
+    if (state->totalLength >= 16)
+    {
+        h = ROTL32(state->v[0], 1) + ROTL32(state->v[1], 7) + ROTL32(state->v[2], 12) + ROTL32(state->v[3], 18);
+    }
+    else
+    {
+        h = state->seed + PRIME32_5;
+    }
+
+    h += (u32)state->totalLength;
+    return Finalize32(h, state->buffer, state->bufferSize);
+}
+
+// ---------------------------------------------------------------------------
+// 64-bit
+// ---------------------------------------------------------------------------
+
+TINLINE u64 Round64(u64 acc, u64 input)
+{
+    acc += input * PRIME64_2;
+    acc = ROTL64(acc, 31);
+    acc *= PRIME64_1;
+    return acc;
+}
+
+TINLINE u64 MergeRound64(u64 acc, u64 value)
+{
+    value = Round64(0, value);
+    acc ^= value;
+    acc = acc * PRIME64_1 + PRIME64_4;
+    return acc;
+}
+
+TINLINE u64 Avalanche64(u64 h)
+{
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// Consumes the final (< 32) bytes and mixes the result.
+static u64 Finalize64(u64 h, const u8* p, u64 length)
+{
+    while (length >= 8)
+    {
+        h ^= Round64(0, Read64(p));
+        h = ROTL64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+        length -= 8;
+    }
+
+    if (length >= 4)
+    {
+        h ^= (u64)Read32(p) * PRIME64_1;
+        h = ROTL64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+        length -= 4;
+    }
+
+    while (length > 0)
+    {
+        h ^= (*p) * PRIME64_5;
+        h = ROTL64(h, 11) * PRIME64_1;
+        p++;
+        length--;
+    }
+
+    return Avalanche64(h);
+}
+
+// Consumes as many whole 32-byte stripes as possible, returning the first unconsumed byte.
+static const u8* Consume64(u64* v, const u8* p, const u8* limit)
+{
+    u64 v1 = v[0], v2 = v[1], v3 = v[2], v4 = v[3];
+    do
+    {
+        v1 = Round64(v1, Read64(p));
+        v2 = Round64(v2, Read64(p + 8));
+        v3 = Round64(v3, Read64(p + 16));
+        v4 = Round64(v4, Read64(p + 24));
+        p += 32;
+    } while (p <= limit);
+
+    v[0] = v1;
+    v[1] = v2;
+    v[2] = v3;
+    v[3] = v4;
+    return p;
+}
+
+static u64 Converge64(const u64* v)
+{
+    u64 h = ROTL64(v[0], 1) + ROTL64(v[1], 7) + ROTL64(v[2], 12) + ROTL64(v[3], 18);
+    h = MergeRound64(h, v[0]);
+    h = MergeRound64(h, v[1]);
+    h = MergeRound64(h, v[2]);
+    h = MergeRound64(h, v[3]);
+    return h;
+}
+
+u64 Hash64(const void* data, u64 length, u64 seed)
+{
+    const u8* p = (const u8*)data;
+    u64 h;
+
+    if (length >= 32)
+    {
+        u64 v[4] = {seed + PRIME64_1 + PRIME64_2, seed + PRIME64_2, seed, seed - PRIME64_1};
+        p = Consume64(v, p, p + length - 32);
+        h = Converge64(v);
+    }
+    else
+    {
+        h = seed + PRIME64_5;
+    }
+
+    h += length;
+    return Finalize64(h, p, length & 31);
+}
+
+void Hash64Reset(hash64_state* state, u64 seed)
+{
+    TZeroMemory(state, sizeof(hash64_state));
+    state->seed = seed;
+    state->v[0] = seed + PRIME64_1 + PRIME64_2;
+    state->v[1] = seed + PRIME64_2;
+    state->v[2] = seed;
+    state->v[3] = seed - PRIME64_1;
+}
+
+void Hash64Update(hash64_state* state, const void* data, u64 length)
+{
+    if (length == 0) return;
+
+    const u8* p = (const u8*)data;
+    const u8* end = p + length;
+    state->totalLength += length;
+
+    // Not enough for a full stripe yet, just stash it.
+    if (state->bufferSize + length < 32)
+    {
+        TCopyMemory(state->buffer + state->bufferSize, p, length);
+        state->bufferSize += (u32)length;
+        return;
+    }
+
+    // Complete the partially filled stripe first.
+    if (state->bufferSize)
+    {
+        u32 fill = 32 - state->bufferSize;
+        TCopyMemory(state->buffer + state->bufferSize, p, fill);
+        Consume64(state->v, state->buffer, state->buffer);
+        p += fill;
+        state->bufferSize = 0;
+    }
+
+    if (end - p >= 32)
+    {
+        p = Consume64(state->v, p, end - 32);
+    }
+
+    if (p < end)
+    {
+        state->bufferSize = (u32)(end - p);
+        TCopyMemory(state->buffer, p, state->bufferSize);
+    }
+}
+
+u64 Hash64Digest(const hash64_state* state)
+{
+    u64 h;
+    if (state->totalLength >= 32)
+    {
+        h = Converge64(state->v);
+    }
+    else
+    {
+        h = state->seed + PRIME64_5;
+    }
+
+    h += state->totalLength;
+    return Finalize64(h, state->buffer, state->bufferSize);
+}
\ No newline at end of file
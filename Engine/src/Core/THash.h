@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Fast, non-cryptographic hashing. The algorithms are XXH32 and XXH64, which
+produce the same digests as the reference xxHash implementation for the same
+seed. They must never be used where an attacker controls the input and a
+collision would matter (e.g. passwords, signatures).
+*/
+
+// Streaming state for 32-bit hashing. Treat as opaque.
+typedef struct hash32_state
+{
+    u64 totalLength;
+    u32 seed;
+    u32 v[4];
+    u32 bufferSize;
+    u8 buffer[16];
+} hash32_state;
+
+// Streaming state for 64-bit hashing. Treat as opaque.
+typedef struct hash64_state
+{
+    u64 totalLength;
+    u64 seed;
+    u64 v[4];
+    u32 bufferSize;
+    u8 buffer[32];
+} hash64_state;
+
+/**
+ * @brief Computes the 32-bit hash of the provided data in one shot.
+ *
+ * @param data A pointer to the data to be hashed. May be 0 if length is 0.
+ * @param length The size of the data in bytes.
+ * @param seed The seed value. Different seeds produce unrelated hashes.
+ * @return u32 The 32-bit hash.
+ */
+TAPI u32 Hash32(const void* data, u64 length, u32 seed);
+
+/**
+ * @brief Computes the 64-bit hash of the provided data in one shot. This
+ * is the faster of the two on 64-bit hardware and should be preferred.
+ *
+ * @param data A pointer to the data to be hashed. May be 0 if length is 0.
+ * @param length The size of the data in bytes.
+ * @param seed The seed value. Different seeds produce unrelated hashes.
+ * @return u64 The 64-bit hash.
+ */
+TAPI u64 Hash64(const void* data, u64 length, u64 seed);
+
+/**
+ * @brief Resets a 32-bit streaming state so a new hash can be computed.
+ *
+ * @param state A pointer to the state to be reset.
+ * @param seed The seed value.
+ */
+TAPI void Hash32Reset(hash32_state* state, u32 seed);
+
+/**
+ * @brief Feeds more data into a 32-bit streaming hash. Data may be split
+ * at any boundary; the digest is the same as hashing it in one shot.
+ *
+ * @param state A pointer to the streaming state.
+ * @param data A pointer to the data to be hashed.
+ * @param length The size of the data in bytes.
+ */
+TAPI void Hash32Update(hash32_state* state, const void* data, u64 length);
+
+/**
+ * @brief Produces the digest of everything fed into the state so far.
+ * Does not modify the state, so more data may be fed in afterward.
+ *
+ * @param state A pointer to the streaming state.
+ * @return u32 The 32-bit hash.
+ */
+TAPI u32 Hash32Digest(const hash32_state* state);
+
+/**
+ * @brief Resets a 64-bit streaming state so a new hash can be computed.
+ *
+ * @param state A pointer to the state to be reset.
+ * @param seed The seed value.
+ */
+TAPI void Hash64Reset(hash64_state* state, u64 seed);
+
+/**
+ * @brief Feeds more data into a 64-bit streaming hash. Data may be split
+ * at any boundary; the digest is the same as hashing it in one shot.
+ *
+ * @param state A pointer to the streaming state.
+ * @param data A pointer to the data to be hashed.
+ * @param length The size of the data in bytes.
+ */
+TAPI void Hash64Update(hash64_state* state, const void* data, u64 length);
+
+/**
+ * @brief Produces the digest of everything fed into the state so far.
+ * Does not modify the state, so more data may be fed in afterward.
+ *
+ * @param state A pointer to the streaming state.
+ * @return u64 The 64-bit hash.
+ */
+TAPI u64 Hash64Digest(const hash64_state* state);
\ No newline at end of file
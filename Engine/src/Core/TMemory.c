@@ -1,7 +1,10 @@
+#define LOG_CHANNEL LOG_CHANNEL_MEMORY
+
 #include "TMemory.h"
 #include "Core/TString.h"
 #include "Core/Logger.h"
 #include "Platform/Platform.h"
+#include "Platform/Atomic.h"
 
 // TODO: Custom string lib
 #include <string.h>
@@ -25,6 +28,7 @@ static const char* memoryTagStrings[MEMORY_TAG_MAX_TAGS] =
     "STRING     ",
     "APPLICATION",
     "JOB        ",
+    "PROFILER   ",
     "TEXTURE    ",
     "MAT_INST   ",
     "RENDERER   ",
@@ -67,9 +71,10 @@ void* TAllocate(u64 size, memory_tag tag)
 
     if (statePtr)
     {
-        statePtr->stats.totalAllocated += size;
-        statePtr->stats.taggedAllocations[tag] += size;
-        statePtr->allocCount++;
+        // Jobs allocate from any thread.
+        AtomicFetchAdd64(&statePtr->stats.totalAllocated, size, ATOMIC_RELAXED);
+        AtomicFetchAdd64(&statePtr->stats.taggedAllocations[tag], size, ATOMIC_RELAXED);
+        AtomicFetchAdd64(&statePtr->allocCount, 1, ATOMIC_RELAXED);
     }
 
     // TODO: Memory alignment
@@ -87,8 +92,8 @@ void TFree(void* block, u64 size, memory_tag tag)
 
     if (statePtr)
     {
-        statePtr->stats.totalAllocated -= size;
-        statePtr->stats.taggedAllocations[tag] -= size;
+        AtomicFetchSub64(&statePtr->stats.totalAllocated, size, ATOMIC_RELAXED);
+        AtomicFetchSub64(&statePtr->stats.taggedAllocations[tag], size, ATOMIC_RELAXED);
     }
 
     // TODO: Memory alignment
@@ -15,6 +15,7 @@ typedef enum memory_tag
     MEMORY_TAG_STRING,
     MEMORY_TAG_APPLICATION,
     MEMORY_TAG_JOB,
+    MEMORY_TAG_PROFILER,
     MEMORY_TAG_TEXTURE,
     MEMORY_TAG_MATERIAL_INSTANCE,
     MEMORY_TAG_RENDERER,
@@ -0,0 +1,270 @@
+#include "Core/TSort.h"
+#include "Core/TMemory.h"
+
+// The widest digit sorted on in one pass. Its histogram has to stay in the L1 cache.
+#define RADIX_MAX_BITS 11
+#define RADIX_MAX_SIZE (1 << RADIX_MAX_BITS)
+// Keys whose varying bits form more runs than this have their closest runs merged.
+#define RADIX_MAX_RUNS 4
+
+/*
+Where each run of varying key bits goes when a key is packed: masked out, then
+shifted down next to the runs below it. Unused runs have a zero mask, so they
+add nothing to a packed key.
+*/
+typedef struct radix_packing
+{
+    u64 masks[RADIX_MAX_RUNS];
+    u32 shifts[RADIX_MAX_RUNS];
+    u32 bitCount;
+} radix_packing;
+
+static inline u64 PackKey(const radix_packing* packing, u64 key)
+{
+    return ((key & packing->masks[0]) >> packing->shifts[0]) |
+           ((key & packing->masks[1]) >> packing->shifts[1]) |
+           ((key & packing->masks[2]) >> packing->shifts[2]) |
+           ((key & packing->masks[3]) >> packing->shifts[3]);
+}
+
+static void FindPacking(const u64* keys, u32 count, radix_packing* outPacking)
+{
+    u64 allSet = ~0ULL;
+    u64 anySet = 0;
+    for (u32 i = 0; i < count; i++)
+    {
+        allSet &= keys[i];
+        anySet |= keys[i];
+    }
+    u64 varying = allSet ^ anySet;
+
+    u32 runStarts[32];
+    u32 runWidths[32];
+    u32 runCount = 0;
+    for (u32 bit = 0; bit < 64;)
+    {
+        if (((varying >> bit) & 1) == 0)
+        {
+            bit++;
+            continue;
+        }
+        u32 start = bit;
+        while (bit < 64 && ((varying >> bit) & 1)) bit++;
+        runStarts[runCount] = start;
+        runWidths[runCount] = bit - start;
+        runCount++;
+    }
+
+    // Merging two runs brings the bits between them along, so merge the closest ones.
+    while (runCount > RADIX_MAX_RUNS)
+    {
+        u32 closest = 1;
+        u32 closestGap = 64;
+        for (u32 run = 1; run < runCount; run++)
+        {
+            u32 gap = runStarts[run] - (runStarts[run - 1] + runWidths[run - 1]);
+            if (gap < closestGap)
+            {
+                closestGap = gap;
+                closest = run;
+            }
+        }
+        runWidths[closest - 1] = runStarts[closest] + runWidths[closest] - runStarts[closest - 1];
+        for (u32 run = closest; run + 1 < runCount; run++)
+        {
+            runStarts[run] = runStarts[run + 1];
+            runWidths[run] = runWidths[run + 1];
+        }
+        runCount--;
+    }
+
+    TZeroMemory(outPacking, sizeof(radix_packing));
+    for (u32 run = 0; run < runCount; run++)
+    {
+        u64 runMask = runWidths[run] == 64 ? ~0ULL : (1ULL << runWidths[run]) - 1;
+        outPacking->masks[run] = runMask << runStarts[run];
+        outPacking->shifts[run] = runStarts[run] - outPacking->bitCount;
+        outPacking->bitCount += runWidths[run];
+    }
+}
+
+// Turns a histogram's counts into the offset each digit's keys start at.
+static void CountsToOffsets(u32* histogram, u32 digitCount)
+{
+    u32 offset = 0;
+    for (u32 digit = 0; digit < digitCount; digit++)
+    {
+        u32 keyCount = histogram[digit];
+        histogram[digit] = offset;
+        offset += keyCount;
+    }
+}
+
+/*
+Sorts keys whose packed digits after the first fit next to their index in
+32 bits. The first pass reads the keys themselves, every later pass moves
+4 bytes per key, and the last pass writes only the index. Each pass counts
+the digits of the next as it moves them. The packing is taken by value so
+that it stays in registers while the passes write memory.
+*/
+static void RadixSortPacked(const u64* keys, u32 count, radix_packing packing, u32 passCount, u32 digitBits,
+                            u32 indexBits, u32* histogram, u32* nextHistogram, u32* words, u32* tempWords,
+                            u32* outOrder)
+{
+    u32 digitCount = 1U << digitBits;
+    u32 digitMask = digitCount - 1;
+    TZeroMemory(nextHistogram, sizeof(u32) * digitCount);
+    for (u32 i = 0; i < count; i++)
+    {
+        u64 packed = PackKey(&packing, keys[i]);
+        u32 word = ((u32)(packed >> digitBits) << indexBits) | i;
+        words[histogram[packed & digitMask]++] = word;
+        nextHistogram[(word >> indexBits) & digitMask]++;
+    }
+
+    for (u32 pass = 1; pass < passCount - 1; pass++)
+    {
+        u32* swapHistogram = histogram;
+        histogram = nextHistogram;
+        nextHistogram = swapHistogram;
+        CountsToOffsets(histogram, digitCount);
+        TZeroMemory(nextHistogram, sizeof(u32) * digitCount);
+
+        u32 shift = indexBits + (pass - 1) * digitBits;
+        for (u32 i = 0; i < count; i++)
+        {
+            u32 word = words[i];
+            tempWords[histogram[(word >> shift) & digitMask]++] = word;
+            nextHistogram[(word >> (shift + digitBits)) & digitMask]++;
+        }
+
+        u32* swapWords = words;
+        words = tempWords;
+        tempWords = swapWords;
+    }
+
+    histogram = nextHistogram;
+    CountsToOffsets(histogram, digitCount);
+    u32 shift = indexBits + (passCount - 2) * digitBits;
+    u32 indexMask = (1U << indexBits) - 1;
+    for (u32 i = 0; i < count; i++)
+    {
+        u32 word = words[i];
+        outOrder[histogram[(word >> shift) & digitMask]++] = word & indexMask;
+    }
+}
+
+/*
+Sorts keys too wide to pack next to their index, moving each packed key and
+its index separately. Keys are shifted down a digit as they move, so each
+pass sorts by the lowest digit left.
+*/
+static void RadixSortWide(const u64* keys, u32 count, radix_packing packing, u32 passCount, u32 digitBits,
+                          u32* histogram, u32* nextHistogram, u64* packedKeys, u64* tempKeys, u32* indices,
+                          u32* tempIndices, u32* outOrder)
+{
+    u32 digitCount = 1U << digitBits;
+    u32 digitMask = digitCount - 1;
+    TZeroMemory(nextHistogram, sizeof(u32) * digitCount);
+    for (u32 i = 0; i < count; i++)
+    {
+        u64 packed = PackKey(&packing, keys[i]);
+        u32 destination = histogram[packed & digitMask]++;
+        packedKeys[destination] = packed >> digitBits;
+        indices[destination] = i;
+        nextHistogram[(packed >> digitBits) & digitMask]++;
+    }
+
+    for (u32 pass = 1; pass < passCount - 1; pass++)
+    {
+        u32* swapHistogram = histogram;
+        histogram = nextHistogram;
+        nextHistogram = swapHistogram;
+        CountsToOffsets(histogram, digitCount);
+        TZeroMemory(nextHistogram, sizeof(u32) * digitCount);
+
+        for (u32 i = 0; i < count; i++)
+        {
+            u64 packed = packedKeys[i];
+            u32 destination = histogram[packed & digitMask]++;
+            tempKeys[destination] = packed >> digitBits;
+            tempIndices[destination] = indices[i];
+            nextHistogram[(packed >> digitBits) & digitMask]++;
+        }
+
+        u64* swapKeys = packedKeys;
+        packedKeys = tempKeys;
+        tempKeys = swapKeys;
+        u32* swapIndices = indices;
+        indices = tempIndices;
+        tempIndices = swapIndices;
+    }
+
+    histogram = nextHistogram;
+    CountsToOffsets(histogram, digitCount);
+    for (u32 i = 0; i < count; i++)
+    {
+        outOrder[histogram[packedKeys[i] & digitMask]++] = indices[i];
+    }
+}
+
+u64 RadixSort64ScratchSize(u32 count)
+{
+    // Enough for the wide sort's two key and two index buffers; the packed sort uses part of it.
+    return (u64)count * (2 * sizeof(u64) + 2 * sizeof(u32));
+}
+
+void RadixSort64(const u64* keys, u32 count, void* scratch, u32* outOrder)
+{
+    radix_packing packing;
+    FindPacking(keys, count, &packing);
+
+    // Every key is equal (or there are fewer than two), so the order they came in is already sorted.
+    if (packing.bitCount == 0)
+    {
+        for (u32 i = 0; i < count; i++) outOrder[i] = i;
+        return;
+    }
+
+    // As few passes as the widest digit allows, with the bits shared evenly between them.
+    u32 passCount = (packing.bitCount + RADIX_MAX_BITS - 1) / RADIX_MAX_BITS;
+    u32 digitBits = (packing.bitCount + passCount - 1) / passCount;
+    u32 digitCount = 1U << digitBits;
+    u32 digitMask = digitCount - 1;
+
+    u32 histogram[RADIX_MAX_SIZE];
+    u32 nextHistogram[RADIX_MAX_SIZE];
+    TZeroMemory(histogram, sizeof(u32) * digitCount);
+    for (u32 i = 0; i < count; i++)
+    {
+        histogram[PackKey(&packing, keys[i]) & digitMask]++;
+    }
+    CountsToOffsets(histogram, digitCount);
+
+    if (passCount == 1)
+    {
+        for (u32 i = 0; i < count; i++)
+        {
+            outOrder[histogram[PackKey(&packing, keys[i]) & digitMask]++] = i;
+        }
+        return;
+    }
+
+    u32 indexBits = 1;
+    while (indexBits < 32 && ((count - 1) >> indexBits) != 0) indexBits++;
+
+    u64* packedKeys = scratch;
+    u64* tempKeys = packedKeys + count;
+    u32* indices = (u32*)(tempKeys + count);
+    u32* tempIndices = indices + count;
+    if (packing.bitCount - digitBits + indexBits <= 32)
+    {
+        RadixSortPacked(keys, count, packing, passCount, digitBits, indexBits, histogram, nextHistogram, indices,
+                        tempIndices, outOrder);
+    }
+    else
+    {
+        RadixSortWide(keys, count, packing, passCount, digitBits, histogram, nextHistogram, packedKeys, tempKeys,
+                      indices, tempIndices, outOrder);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Sorting of keyed items. The sorts are stable: items with equal keys keep the
+order they were given in.
+*/
+
+/**
+ * @brief Gets the size of the scratch memory RadixSort64 needs to sort count keys.
+ *
+ * @param count The number of keys.
+ * @return u64 The size in bytes.
+ */
+TAPI u64 RadixSort64ScratchSize(u32 count);
+
+/**
+ * @brief Finds the order which sorts 64-bit keys ascending, using an LSD radix sort. Only the bits
+ * which differ between keys are sorted on: they are packed together with each key's index into
+ * one word, so keys using few of their bits, such as draw keys, take few passes. Runs in linear
+ * time, so suits sorting every frame.
+ *
+ * @param keys The keys to be sorted. Left as they are.
+ * @param count The number of keys.
+ * @param scratch RadixSort64ScratchSize(count) bytes of scratch memory, 8-byte aligned.
+ * @param outOrder Count indices to hold the order: keys[outOrder[0]] is the smallest key.
+ */
+TAPI void RadixSort64(const u64* keys, u32 count, void* scratch, u32* outOrder);
\ No newline at end of file
@@ -50,4 +50,33 @@ s32 StringFormatV(char* dest, const char* format, void* vaListp)
         return written;
     }
     return -1;
+}
+
+s32 StringFormatN(char* dest, u64 destSize, const char* format, ...)
+{
+    if (dest)
+    {
+        __builtin_va_list argPtr;
+        va_start(argPtr, format);
+        s32 written = StringFormatNV(dest, destSize, format, argPtr);
+        va_end(argPtr);
+        return written;
+    }
+    return -1;
+}
+
+s32 StringFormatNV(char* dest, u64 destSize, const char* format, void* vaListp)
+{
+    if (dest && destSize)
+    {
+        s32 written = vsnprintf(dest, destSize, format, vaListp);
+        if (written < 0)
+        {
+            dest[0] = 0;
+            return 0;
+        }
+        // vsnprintf reports the untruncated length.
+        return (u64)written < destSize ? written : (s32)(destSize - 1);
+    }
+    return -1;
 }
\ No newline at end of file
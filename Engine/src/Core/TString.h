@@ -17,4 +17,26 @@ TAPI s32 StringFormat(char* dest, const char* format, ...);
  * @param vaList The variadic argument list.
  * @returns The size of the data written.
  */
-TAPI s32 StringFormatV(char* dest, const char* format, void* vaList);
\ No newline at end of file
+TAPI s32 StringFormatV(char* dest, const char* format, void* vaList);
+
+/**
+ * Performs string formatting to dest, writing no more than destSize bytes
+ * including the null terminator. Output which does not fit is truncated.
+ * @param dest The destination for the formatted string.
+ * @param destSize The size of dest in bytes.
+ * @param format The format string to use for the operation
+ * @param ... The format arguments.
+ * @returns The number of characters written, not including the null terminator.
+ */
+TAPI s32 StringFormatN(char* dest, u64 destSize, const char* format, ...);
+
+/**
+ * Performs variadic string formatting to dest, writing no more than destSize bytes
+ * including the null terminator. Output which does not fit is truncated.
+ * @param dest The destination for the formatted string.
+ * @param destSize The size of dest in bytes.
+ * @param format The string to be formatted.
+ * @param vaList The variadic argument list.
+ * @returns The number of characters written, not including the null terminator.
+ */
+TAPI s32 StringFormatNV(char* dest, u64 destSize, const char* format, void* vaList);
\ No newline at end of file
@@ -0,0 +1,360 @@
+#include "Core/TaskGraph.h"
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include "Core/TMemory.h"
+#include "Core/TString.h"
+#include "Core/Profiler.h"
+#include "Containers/RingQueue.h"
+#include "Platform/Platform.h"
+#include "Platform/Atomic.h"
+
+// Room for every task of every frame in flight. Must be a power of 2.
+#define MAIN_THREAD_QUEUE_CAPACITY (TASK_GRAPH_MAX_TASKS * TASK_GRAPH_MAX_FRAMES_IN_FLIGHT)
+// Times the main thread spins with nothing to do before yielding its time slice.
+#define WAIT_SPIN_COUNT 64
+
+struct task_graph_frame;
+
+// One task's run within one frame.
+typedef struct task_instance
+{
+    struct task_graph_frame* frame;
+    u32 taskIndex;
+} task_instance;
+
+typedef struct task_graph_frame
+{
+    task_frame info;
+    // Kicked off, and not yet waited on. Only touched by the main thread.
+    b8 inFlight;
+    // Tasks yet to finish. The frame is done at zero.
+    u32 remaining;
+    // The tasks which have finished.
+    u64 doneMask;
+    b8 failed;
+    f64 kickTime;
+    // How many of its dependencies each task is still waiting on.
+    u32 pending[TASK_GRAPH_MAX_TASKS];
+    task_instance instances[TASK_GRAPH_MAX_TASKS];
+    task_timing timings[TASK_GRAPH_MAX_TASKS];
+} task_graph_frame;
+
+typedef struct task_graph_state
+{
+    u32 taskCount;
+    task_desc tasks[TASK_GRAPH_MAX_TASKS];
+    // Per task, masks of other tasks:
+    // the earlier tasks it depends on within a frame,
+    u64 dependencies[TASK_GRAPH_MAX_TASKS];
+    // the later tasks which depend on it within a frame,
+    u64 dependents[TASK_GRAPH_MAX_TASKS];
+    // and the tasks which depend on it in the next frame. This is symmetric, so
+    // it is also the tasks of the previous frame it depends on.
+    u64 crossFrameDependents[TASK_GRAPH_MAX_TASKS];
+
+    u32 resourceCount;
+    const char* resourceNames[TASK_GRAPH_MAX_RESOURCES];
+
+    // Guards the dependency counts of the frames in flight.
+    platform_mutex mutex;
+    // Ready instances of main thread tasks.
+    ring_queue mainThreadQueue;
+    // The number the next frame kicked off will have.
+    u64 nextFrameNumber;
+    task_graph_frame frames[TASK_GRAPH_MAX_FRAMES_IN_FLIGHT];
+
+    // Copied from each frame as it is waited on.
+    u32 timingCount;
+    task_timing timings[TASK_GRAPH_MAX_TASKS];
+} task_graph_state;
+
+static task_graph_state* statePtr;
+
+static b8 TasksConflict(const task_desc* a, const task_desc* b)
+{
+    return (a->writes & (b->reads | b->writes)) || (b->writes & a->reads);
+}
+
+static void RunTask(task_instance* instance);
+
+static void TaskJob(void* params)
+{
+    RunTask(params);
+}
+
+static void Dispatch(task_instance** ready, u32 readyCount)
+{
+    for (u32 i = 0; i < readyCount; i++)
+    {
+        if (statePtr->tasks[ready[i]->taskIndex].mainThread)
+        {
+            RingQueuePush(&statePtr->mainThreadQueue, &ready[i]);
+        }
+        else
+        {
+            job_desc job = {TaskJob, ready[i], JOB_PRIORITY_HIGH};
+            JobSubmit(&job, 1, 0);
+        }
+    }
+}
+
+// Counts a task as finished, and dispatches whatever that leaves ready to run.
+static void CompleteTask(task_instance* instance, b8 succeeded)
+{
+    task_graph_frame* frame = instance->frame;
+    u32 taskIndex = instance->taskIndex;
+
+    // Ready tasks are dispatched only after unlocking, since they may run inline.
+    task_instance* ready[TASK_GRAPH_MAX_TASKS * 2];
+    u32 readyCount = 0;
+
+    PlatformMutexLock(&statePtr->mutex);
+    if (!succeeded) frame->failed = true;
+    frame->doneMask |= 1ULL << taskIndex;
+
+    u64 dependents = statePtr->dependents[taskIndex];
+    while (dependents)
+    {
+        u32 dependent = __builtin_ctzll(dependents);
+        dependents &= dependents - 1;
+        if (--frame->pending[dependent] == 0) ready[readyCount++] = &frame->instances[dependent];
+    }
+
+    // If the next frame has been kicked off, it counted this task as unfinished.
+    u64 nextFrameNumber = frame->info.frameNumber + 1;
+    if (nextFrameNumber < statePtr->nextFrameNumber)
+    {
+        task_graph_frame* next = &statePtr->frames[nextFrameNumber % TASK_GRAPH_MAX_FRAMES_IN_FLIGHT];
+        dependents = statePtr->crossFrameDependents[taskIndex];
+        while (dependents)
+        {
+            u32 dependent = __builtin_ctzll(dependents);
+            dependents &= dependents - 1;
+            if (--next->pending[dependent] == 0) ready[readyCount++] = &next->instances[dependent];
+        }
+    }
+
+    // Release, so the waiting thread sees the timings and results of the whole frame.
+    AtomicFetchSub32(&frame->remaining, 1, ATOMIC_RELEASE);
+    PlatformMutexUnlock(&statePtr->mutex);
+
+    Dispatch(ready, readyCount);
+}
+
+static void RunTask(task_instance* instance)
+{
+    task_graph_frame* frame = instance->frame;
+    const task_desc* task = &statePtr->tasks[instance->taskIndex];
+    task_timing* timing = &frame->timings[instance->taskIndex];
+
+    timing->name = task->name;
+    timing->workerIndex = JobSystemGetWorkerIndex();
+    f64 start = PlatformGetAbsoluteTime();
+    TPROFILE_BEGIN(zone, task->name);
+    b8 succeeded = task->run(task->userData, &frame->info);
+    TPROFILE_END(zone);
+    f64 end = PlatformGetAbsoluteTime();
+    timing->start = start - frame->kickTime;
+    timing->duration = end - start;
+
+    if (!succeeded)
+    {
+        TERROR("Task '%s' failed in frame %llu.", task->name, frame->info.frameNumber);
+    }
+    CompleteTask(instance, succeeded);
+}
+
+b8 TaskGraphInitialize(u64* memoryRequirement, void* state)
+{
+    u64 queueMemoryRequirement = RingQueueMemoryRequirement(sizeof(task_instance*), MAIN_THREAD_QUEUE_CAPACITY);
+    *memoryRequirement = sizeof(task_graph_state) + queueMemoryRequirement;
+    if (state == 0) return true;
+
+    statePtr = state;
+    TZeroMemory(statePtr, *memoryRequirement);
+    RingQueueCreate(sizeof(task_instance*), MAIN_THREAD_QUEUE_CAPACITY, (u8*)state + sizeof(task_graph_state), &statePtr->mainThreadQueue);
+
+    for (u32 f = 0; f < TASK_GRAPH_MAX_FRAMES_IN_FLIGHT; f++)
+    {
+        for (u32 i = 0; i < TASK_GRAPH_MAX_TASKS; i++)
+        {
+            statePtr->frames[f].instances[i].frame = &statePtr->frames[f];
+            statePtr->frames[f].instances[i].taskIndex = i;
+        }
+    }
+
+    if (!PlatformMutexCreate(&statePtr->mutex))
+    {
+        TERROR("Failed to create the task graph's mutex.");
+        statePtr = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void TaskGraphShutdown(void* state)
+{
+    if (!statePtr) return;
+
+    // Oldest first, since each frame may be waiting on the one before.
+    for (u32 i = 0; i < TASK_GRAPH_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        u64 frameNumber = statePtr->nextFrameNumber + i;
+        if (frameNumber < TASK_GRAPH_MAX_FRAMES_IN_FLIGHT) continue;
+        frameNumber -= TASK_GRAPH_MAX_FRAMES_IN_FLIGHT;
+        TaskGraphWaitFrame(frameNumber);
+    }
+
+    PlatformMutexDestroy(&statePtr->mutex);
+    RingQueueDestroy(&statePtr->mainThreadQueue);
+    statePtr = 0;
+}
+
+u64 TaskGraphResource(const char* name)
+{
+    if (!statePtr) return 0;
+
+    for (u32 i = 0; i < statePtr->resourceCount; i++)
+    {
+        if (StringsEqual(statePtr->resourceNames[i], name)) return 1ULL << i;
+    }
+
+    if (statePtr->resourceCount == TASK_GRAPH_MAX_RESOURCES)
+    {
+        TERROR("TaskGraphResource - cannot register '%s'; the limit of %u resources has been reached.", name, TASK_GRAPH_MAX_RESOURCES);
+        return 0;
+    }
+
+    statePtr->resourceNames[statePtr->resourceCount] = name;
+    return 1ULL << statePtr->resourceCount++;
+}
+
+b8 TaskGraphAddTask(const task_desc* desc)
+{
+    if (!statePtr) return false;
+
+    for (u32 i = 0; i < TASK_GRAPH_MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        if (statePtr->frames[i].inFlight)
+        {
+            TERROR("TaskGraphAddTask - cannot add '%s' while a frame is in flight.", desc->name);
+            return false;
+        }
+    }
+    if (statePtr->taskCount == TASK_GRAPH_MAX_TASKS)
+    {
+        TERROR("TaskGraphAddTask - cannot add '%s'; the limit of %u tasks has been reached.", desc->name, TASK_GRAPH_MAX_TASKS);
+        return false;
+    }
+
+    u32 index = statePtr->taskCount++;
+    statePtr->tasks[index] = *desc;
+    u64 bit = 1ULL << index;
+
+    // A task always waits for its own run in the previous frame.
+    statePtr->crossFrameDependents[index] = bit;
+    for (u32 i = 0; i < index; i++)
+    {
+        if (!TasksConflict(&statePtr->tasks[i], desc)) continue;
+
+        statePtr->dependencies[index] |= 1ULL << i;
+        statePtr->dependents[i] |= bit;
+        statePtr->crossFrameDependents[index] |= 1ULL << i;
+        statePtr->crossFrameDependents[i] |= bit;
+    }
+
+    return true;
+}
+
+u64 TaskGraphKickFrame(f64 dt)
+{
+    u64 frameNumber = statePtr->nextFrameNumber;
+    task_graph_frame* frame = &statePtr->frames[frameNumber % TASK_GRAPH_MAX_FRAMES_IN_FLIGHT];
+    if (frame->inFlight)
+    {
+        // The slot is still held by the oldest frame in flight.
+        if (!TaskGraphWaitFrame(frame->info.frameNumber))
+        {
+            TERROR("Frame %llu failed, and was only waited on to make room for frame %llu.", frame->info.frameNumber, frameNumber);
+        }
+    }
+
+    task_instance* ready[TASK_GRAPH_MAX_TASKS];
+    u32 readyCount = 0;
+
+    PlatformMutexLock(&statePtr->mutex);
+    frame->info.frameNumber = frameNumber;
+    frame->info.dt = dt;
+    frame->inFlight = true;
+    frame->failed = false;
+    frame->doneMask = 0;
+    frame->kickTime = PlatformGetAbsoluteTime();
+    AtomicStore32(&frame->remaining, statePtr->taskCount, ATOMIC_RELAXED);
+
+    // Whatever the previous frame has not finished yet must be waited for.
+    u64 previousDone = ~0ULL;
+    if (frameNumber > 0)
+    {
+        task_graph_frame* previous = &statePtr->frames[(frameNumber - 1) % TASK_GRAPH_MAX_FRAMES_IN_FLIGHT];
+        if (previous->inFlight) previousDone = previous->doneMask;
+    }
+
+    for (u32 i = 0; i < statePtr->taskCount; i++)
+    {
+        u64 previousPending = statePtr->crossFrameDependents[i] & ~previousDone;
+        frame->pending[i] = __builtin_popcountll(statePtr->dependencies[i]) + __builtin_popcountll(previousPending);
+        if (frame->pending[i] == 0) ready[readyCount++] = &frame->instances[i];
+    }
+    statePtr->nextFrameNumber = frameNumber + 1;
+    PlatformMutexUnlock(&statePtr->mutex);
+
+    Dispatch(ready, readyCount);
+    return frameNumber;
+}
+
+b8 TaskGraphWaitFrame(u64 frameNumber)
+{
+    task_graph_frame* frame = &statePtr->frames[frameNumber % TASK_GRAPH_MAX_FRAMES_IN_FLIGHT];
+    if (!frame->inFlight || frame->info.frameNumber != frameNumber)
+    {
+        // Already waited on.
+        return true;
+    }
+
+    u32 spins = 0;
+    while (AtomicLoad32(&frame->remaining, ATOMIC_ACQUIRE) != 0)
+    {
+        // Main thread tasks of the next frame may run here too, which is what lets them overlap.
+        task_instance* instance;
+        if (RingQueuePop(&statePtr->mainThreadQueue, &instance))
+        {
+            RunTask(instance);
+            spins = 0;
+        }
+        else if (JobHelp())
+        {
+            spins = 0;
+        }
+        else if (++spins < WAIT_SPIN_COUNT)
+        {
+            AtomicPause();
+        }
+        else
+        {
+            PlatformThreadYield();
+            spins = 0;
+        }
+    }
+
+    statePtr->timingCount = statePtr->taskCount;
+    TCopyMemory(statePtr->timings, frame->timings, sizeof(task_timing) * statePtr->taskCount);
+    frame->inFlight = false;
+    return !frame->failed;
+}
+
+const task_timing* TaskGraphGetTimings(u32* outCount)
+{
+    *outCount = statePtr ? statePtr->timingCount : 0;
+    return statePtr ? statePtr->timings : 0;
+}
\ No newline at end of file
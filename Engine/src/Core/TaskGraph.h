@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Declarative task graph for the main loop.
+
+Systems register tasks once, each naming the resources it reads and writes.
+A task depends on every earlier-registered task it conflicts with: it reads
+what the other writes, writes what the other reads, or both write the same
+thing. Every frame, each task runs once, as soon as everything it depends on
+has finished. Tasks run as jobs on the job system, unless they must stay on
+the main thread.
+
+Up to two frames are in flight at once. A task in frame N+1 also waits for
+the tasks of frame N it conflicts with, including its own previous run, but
+nothing else. So simulating frame N+1 can overlap with submitting frame N to
+the GPU, as long as the two touch different resources.
+*/
+
+// The most tasks and resources a graph can hold.
+#define TASK_GRAPH_MAX_TASKS 64
+#define TASK_GRAPH_MAX_RESOURCES 64
+
+// The most frames which can be in flight at once.
+#define TASK_GRAPH_MAX_FRAMES_IN_FLIGHT 2
+
+// Per-frame data handed to every task.
+typedef struct task_frame
+{
+    // Counts up from 0 with each frame kicked off.
+    u64 frameNumber;
+    // The time elapsed since the previous frame, in seconds.
+    f64 dt;
+} task_frame;
+
+/**
+ * @brief Runs a task for a frame.
+ *
+ * @param userData The user data given when the task was added.
+ * @param frame The frame being run.
+ * @return b8 True on success. False fails the frame, though its other tasks still run.
+ */
+typedef b8 (*PFN_task_run)(void* userData, const task_frame* frame);
+
+// Describes a task to be run every frame.
+typedef struct task_desc
+{
+    // Shown in timings. Must outlive the task graph.
+    const char* name;
+    PFN_task_run run;
+    void* userData;
+    // Resources read, as a mask built from TaskGraphResource.
+    u64 reads;
+    // Resources written, as a mask built from TaskGraphResource.
+    u64 writes;
+    // Whether the task must run on the main thread, such as anything talking to the window.
+    b8 mainThread;
+} task_desc;
+
+// How long a task took in a frame.
+typedef struct task_timing
+{
+    const char* name;
+    // When the task started, in seconds since its frame was kicked off.
+    f64 start;
+    // How long the task ran for, in seconds.
+    f64 duration;
+    // The worker which ran the task; 0 is the main thread.
+    s32 workerIndex;
+} task_timing;
+
+/**
+ * @brief Initializes the task graph. Call twice; once with state = 0 to get required memory size,
+ * then a second time passing allocated memory to state. Must be called on the main thread.
+ *
+ * @param memoryRequirement A pointer to hold the required memory size of internal state.
+ * @param state 0 if just requesting memory requirement, otherwise allocated block of memory.
+ * @return b8 True on success; otherwise false.
+ */
+b8 TaskGraphInitialize(u64* memoryRequirement, void* state);
+
+/**
+ * @brief Shuts down the task graph, first finishing any frame still in flight.
+ *
+ * @param state A pointer to the system's state.
+ */
+void TaskGraphShutdown(void* state);
+
+/**
+ * @brief Gets the mask for a named resource, registering it the first time the name is used.
+ *
+ * @param name The resource's name. Must outlive the task graph.
+ * @return u64 A mask with the resource's bit set, or 0 if there are already TASK_GRAPH_MAX_RESOURCES.
+ */
+TAPI u64 TaskGraphResource(const char* name);
+
+/**
+ * @brief Adds a task, to be run from the next frame kicked off onwards. Tasks can only be
+ * added while no frame is in flight. Must be called on the main thread.
+ *
+ * @param desc A description of the task.
+ * @return b8 True on success; false if the graph is full or a frame is in flight.
+ */
+TAPI b8 TaskGraphAddTask(const task_desc* desc);
+
+/**
+ * @brief Kicks off a frame, and returns without waiting for it. If two frames are already
+ * in flight, waits for the older one first. Must be called on the main thread.
+ *
+ * @param dt The time elapsed since the previous frame, in seconds.
+ * @return u64 The frame's number, to pass to TaskGraphWaitFrame.
+ */
+TAPI u64 TaskGraphKickFrame(f64 dt);
+
+/**
+ * @brief Waits for a frame to finish, running main thread tasks and other jobs in the meantime.
+ * Must be called on the main thread.
+ *
+ * @param frameNumber The frame to wait for, as returned by TaskGraphKickFrame.
+ * @return b8 True if every task in the frame succeeded; otherwise false.
+ */
+TAPI b8 TaskGraphWaitFrame(u64 frameNumber);
+
+/**
+ * @brief Gets the timing of each task in the most recently finished frame, in the order
+ * the tasks were added.
+ *
+ * @param outCount A pointer to hold the number of timings.
+ * @return const task_timing* The timings, valid until the next frame finishes.
+ */
+TAPI const task_timing* TaskGraphGetTimings(u32* outCount);
\ No newline at end of file
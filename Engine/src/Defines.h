@@ -107,5 +107,5 @@ STATIC_ASSERT(sizeof(f64) == 8, "Expected f64 to be 8 byte.");
 #define TNOINLINE __declspec(noinline)
 #else
 #define TINLINE static inline
-#define TNOINLINE
+#define TNOINLINE __attribute__((noinline))
 #endif
\ No newline at end of file
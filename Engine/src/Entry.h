@@ -13,7 +13,8 @@ extern b8 CreateGame(game* outGame);
 int main(void)
 {
     // Request the game instance from the application.
-    game gameInst;
+    // Zeroed, so any configuration the game leaves out is at its default.
+    game gameInst = {0};
     if (!CreateGame(&gameInst)) {
         TFATAL("Could not create game!");
         return -1;
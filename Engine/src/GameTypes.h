@@ -14,12 +14,20 @@ typedef struct game {
     b8 (*Initialize)(struct game* gameInst);
 
     // Function pointer to game's update function.
+    // With a fixed timestep, dt is always the timestep.
+    // Runs as a job on any thread, possibly a worker, never alongside render or another update.
+    // It may read input, log, submit and wait on jobs, and post events with EventPost, but must
+    // not fire, register or unregister events, or touch the window; those are main thread only.
     b8 (*Update)(struct game* gameInst, f32 dt);
 
     // Function pointer to game's render function.
-    b8 (*Render)(struct game* gameInst, f32 dt);
+    // With a fixed timestep, alpha is how far real time is between the last update and the next,
+    // from 0 to 1, for blending the two states. Otherwise it is always 1.
+    // Runs as a job on any thread after update, under the same rules, and may also hand the
+    // renderer its view and draws. It can overlap the previous frame being drawn.
+    b8 (*Render)(struct game* gameInst, f32 dt, f32 alpha);
 
-    // Function pointer to handle resizes, if applicable.
+    // Function pointer to handle resizes, if applicable. Called on the main thread.
     void (*OnResize)(struct game* gameInst, u32 width, u32 height);
 
     // Game-specific game state. Created and managed by the game.
@@ -62,4 +62,12 @@ void LinearAllocatorFreeAll(linear_allocator* allocator)
         allocator->allocated = 0;
         TZeroMemory(allocator->memory, allocator->totalSize);
     }
+}
+
+void LinearAllocatorReset(linear_allocator* allocator)
+{
+    if (allocator)
+    {
+        allocator->allocated = 0;
+    }
 }
\ No newline at end of file
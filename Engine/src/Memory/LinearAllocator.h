@@ -12,4 +12,7 @@ typedef struct linear_allocator
 TAPI void LinearAllocatorCreate(u64 totalSize, void* memory, linear_allocator* outAllocator);
 TAPI void LinearAllocatorDestroy(linear_allocator* allocator);
 TAPI void* LinearAllocatorAllocate(linear_allocator* allocator, u64 size);
-TAPI void LinearAllocatorFreeAll(linear_allocator* allocator);
\ No newline at end of file
+TAPI void LinearAllocatorFreeAll(linear_allocator* allocator);
+// Frees everything like LinearAllocatorFreeAll, but leaves the memory as it is. For allocators
+// reset often, such as once a frame, where clearing the memory each time would be wasted.
+TAPI void LinearAllocatorReset(linear_allocator* allocator);
\ No newline at end of file
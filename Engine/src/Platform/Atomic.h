@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Defines.h"
+
+/*
+Atomic operations on 8, 32 and 64-bit integers and pointers, with explicit
+memory ordering. These map directly onto the compiler's __atomic builtins,
+which both clang and GCC provide on every platform we target, so they are
+header-only and compile down to single instructions.
+
+Targets must be naturally aligned. Passing a memory order which is not a
+compile-time constant is legal, but will be treated as ATOMIC_SEQ_CST.
+*/
+
+typedef enum atomic_order {
+    // No ordering; only the operation itself is atomic.
+    ATOMIC_RELAXED = __ATOMIC_RELAXED,
+    // Later reads and writes cannot be moved before this load.
+    ATOMIC_ACQUIRE = __ATOMIC_ACQUIRE,
+    // Earlier reads and writes cannot be moved after this store.
+    ATOMIC_RELEASE = __ATOMIC_RELEASE,
+    // Both acquire and release, for read-modify-write operations.
+    ATOMIC_ACQ_REL = __ATOMIC_ACQ_REL,
+    // A single total order shared by all sequentially consistent operations.
+    ATOMIC_SEQ_CST = __ATOMIC_SEQ_CST
+} atomic_order;
+
+TINLINE u8 AtomicLoad8(const volatile u8* target, atomic_order order)
+{
+    return __atomic_load_n(target, order);
+}
+
+TINLINE void AtomicStore8(volatile u8* target, u8 value, atomic_order order)
+{
+    __atomic_store_n(target, value, order);
+}
+
+TINLINE u8 AtomicExchange8(volatile u8* target, u8 value, atomic_order order)
+{
+    return __atomic_exchange_n(target, value, order);
+}
+
+TINLINE u32 AtomicLoad32(const volatile u32* target, atomic_order order)
+{
+    return __atomic_load_n(target, order);
+}
+
+TINLINE void AtomicStore32(volatile u32* target, u32 value, atomic_order order)
+{
+    __atomic_store_n(target, value, order);
+}
+
+TINLINE u32 AtomicExchange32(volatile u32* target, u32 value, atomic_order order)
+{
+    return __atomic_exchange_n(target, value, order);
+}
+
+/**
+ * @brief Replaces the target's value with desired if it equals expected.
+ *
+ * @param target A pointer to the value to update.
+ * @param expected A pointer to the expected value. On failure, receives the value actually found.
+ * @param desired The value to store if the target matches expected.
+ * @param success The memory order used if the exchange happens.
+ * @param failure The memory order used if it does not. Cannot be a release order.
+ * @return b8 True if the value was replaced; otherwise false.
+ */
+TINLINE b8 AtomicCompareExchange32(volatile u32* target, u32* expected, u32 desired, atomic_order success, atomic_order failure)
+{
+    return __atomic_compare_exchange_n(target, expected, desired, false, success, failure);
+}
+
+// Adds to the target, returning the value it held beforehand.
+TINLINE u32 AtomicFetchAdd32(volatile u32* target, u32 value, atomic_order order)
+{
+    return __atomic_fetch_add(target, value, order);
+}
+
+// Subtracts from the target, returning the value it held beforehand.
+TINLINE u32 AtomicFetchSub32(volatile u32* target, u32 value, atomic_order order)
+{
+    return __atomic_fetch_sub(target, value, order);
+}
+
+TINLINE u64 AtomicLoad64(const volatile u64* target, atomic_order order)
+{
+    return __atomic_load_n(target, order);
+}
+
+TINLINE void AtomicStore64(volatile u64* target, u64 value, atomic_order order)
+{
+    __atomic_store_n(target, value, order);
+}
+
+TINLINE u64 AtomicExchange64(volatile u64* target, u64 value, atomic_order order)
+{
+    return __atomic_exchange_n(target, value, order);
+}
+
+// The 64-bit version of AtomicCompareExchange32.
+TINLINE b8 AtomicCompareExchange64(volatile u64* target, u64* expected, u64 desired, atomic_order success, atomic_order failure)
+{
+    return __atomic_compare_exchange_n(target, expected, desired, false, success, failure);
+}
+
+// Adds to the target, returning the value it held beforehand.
+TINLINE u64 AtomicFetchAdd64(volatile u64* target, u64 value, atomic_order order)
+{
+    return __atomic_fetch_add(target, value, order);
+}
+
+// Subtracts from the target, returning the value it held beforehand.
+TINLINE u64 AtomicFetchSub64(volatile u64* target, u64 value, atomic_order order)
+{
+    return __atomic_fetch_sub(target, value, order);
+}
+
+TINLINE void* AtomicLoadPtr(void* const volatile* target, atomic_order order)
+{
+    return __atomic_load_n(target, order);
+}
+
+TINLINE void AtomicStorePtr(void* volatile* target, void* value, atomic_order order)
+{
+    __atomic_store_n(target, value, order);
+}
+
+TINLINE void* AtomicExchangePtr(void* volatile* target, void* value, atomic_order order)
+{
+    return __atomic_exchange_n(target, value, order);
+}
+
+// The pointer version of AtomicCompareExchange32.
+TINLINE b8 AtomicCompareExchangePtr(void* volatile* target, void** expected, void* desired, atomic_order success, atomic_order failure)
+{
+    return __atomic_compare_exchange_n(target, expected, desired, false, success, failure);
+}
+
+// Orders memory accesses around this point without touching any particular variable.
+TINLINE void AtomicThreadFence(atomic_order order)
+{
+    __atomic_thread_fence(order);
+}
+
+// Hints to the CPU that the calling thread is spinning on a value, which saves
+// power and lets a sibling hyper-thread make progress.
+TINLINE void AtomicPause()
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
\ No newline at end of file
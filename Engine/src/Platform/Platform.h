@@ -23,10 +23,189 @@ void* PlatformSetMemory(void* dest, s32 value, u64 size);
 
 void PlatformConsoleWrite(const char* message, u8 colour);
 void PlatformConsoleWriteError(const char* message, u8 colour);
+// Console output may be buffered; this writes out anything still pending.
+// Errors are never buffered.
+void PlatformConsoleFlush();
 
 f64 PlatformGetAbsoluteTime();
 
+// Gets a monotonic timestamp in nanoseconds, from the highest resolution clock available.
+// Unaffected by clock adjustments, so suited to timing short spans of code.
+TAPI u64 PlatformGetTimestampNs();
+
 // Sleep on the thread for the provided ms. This blocks the main thread.
 // Should only be used for giving time back to the OS for unused update power.
 // Therefore it is not exported.
-void PlatformSleep(u64 ms);
\ No newline at end of file
+void PlatformSleep(u64 ms);
+
+// Sleeps the thread for about the provided number of nanoseconds, as finely as the OS allows.
+// The OS may still wake the thread late, so callers needing precision should spin out the end.
+TAPI void PlatformSleepNs(u64 ns);
+
+// Passed as a timeout to wait forever.
+#define PLATFORM_WAIT_INFINITE 0xFFFFFFFFFFFFFFFFULL
+
+// Entry point of a thread. The return value is the thread's exit code.
+typedef u32 (*PFN_thread_start)(void* params);
+
+typedef struct platform_thread
+{
+    // Opaque handle to the internal thread.
+    void* internalData;
+    u64 threadId;
+} platform_thread;
+
+typedef struct platform_mutex
+{
+    void* internalData;
+} platform_mutex;
+
+typedef struct platform_semaphore
+{
+    void* internalData;
+} platform_semaphore;
+
+typedef struct platform_condvar
+{
+    void* internalData;
+} platform_condvar;
+
+/**
+ * Creates and immediately starts a new thread.
+ * @param startFunction The function to be run on the new thread.
+ * @param params Passed as-is to startFunction. Can be 0/NULL.
+ * @param outThread A pointer to hold the created thread.
+ * @returns True on success; otherwise false.
+ */
+TAPI b8 PlatformThreadCreate(PFN_thread_start startFunction, void* params, platform_thread* outThread);
+
+/**
+ * Blocks until the given thread has exited, then releases its resources.
+ * @param thread A pointer to the thread to be joined.
+ */
+TAPI void PlatformThreadJoin(platform_thread* thread);
+
+// Gets the id of the calling thread.
+TAPI u64 PlatformThreadGetCurrentId();
+
+// Gives the rest of the calling thread's time slice to another thread.
+TAPI void PlatformThreadYield();
+
+// Gets the number of logical processors available to the process.
+TAPI u32 PlatformGetProcessorCount();
+
+// Gets the number of physical cores, counting hyper-threaded siblings once.
+// Falls back to the logical processor count if the topology is unavailable.
+TAPI u32 PlatformGetPhysicalCoreCount();
+
+/**
+ * Creates a mutex. Mutexes are not recursive.
+ * @param outMutex A pointer to hold the created mutex.
+ * @returns True on success; otherwise false.
+ */
+TAPI b8 PlatformMutexCreate(platform_mutex* outMutex);
+TAPI void PlatformMutexDestroy(platform_mutex* mutex);
+TAPI void PlatformMutexLock(platform_mutex* mutex);
+TAPI void PlatformMutexUnlock(platform_mutex* mutex);
+
+/**
+ * Creates a counting semaphore.
+ * @param initialCount The number of waits which succeed before one has to block.
+ * @param outSemaphore A pointer to hold the created semaphore.
+ * @returns True on success; otherwise false.
+ */
+TAPI b8 PlatformSemaphoreCreate(u32 initialCount, platform_semaphore* outSemaphore);
+TAPI void PlatformSemaphoreDestroy(platform_semaphore* semaphore);
+
+/**
+ * Increments the semaphore's count, waking up to count waiting threads.
+ * @param semaphore A pointer to the semaphore.
+ * @param count The amount to increment by.
+ */
+TAPI void PlatformSemaphoreSignal(platform_semaphore* semaphore, u32 count);
+
+/**
+ * Waits until the semaphore's count is above zero, then decrements it.
+ * @param semaphore A pointer to the semaphore.
+ * @param timeoutMs The longest time to wait, in ms, or PLATFORM_WAIT_INFINITE.
+ * @returns True if the count was decremented; false if the wait timed out.
+ */
+TAPI b8 PlatformSemaphoreWait(platform_semaphore* semaphore, u64 timeoutMs);
+
+/**
+ * Creates a condition variable.
+ * @param outCondvar A pointer to hold the created condition variable.
+ * @returns True on success; otherwise false.
+ */
+TAPI b8 PlatformCondvarCreate(platform_condvar* outCondvar);
+TAPI void PlatformCondvarDestroy(platform_condvar* condvar);
+
+/**
+ * Atomically unlocks the mutex and waits for the condition variable to be signalled,
+ * then locks the mutex again before returning. Wakeups can be spurious, so the
+ * condition being waited for must always be checked again.
+ * @param condvar A pointer to the condition variable.
+ * @param mutex A pointer to a mutex locked by the calling thread.
+ * @param timeoutMs The longest time to wait, in ms, or PLATFORM_WAIT_INFINITE.
+ * @returns False if the wait timed out; otherwise true.
+ */
+TAPI b8 PlatformCondvarWait(platform_condvar* condvar, platform_mutex* mutex, u64 timeoutMs);
+
+// Wakes one thread waiting on the condition variable.
+TAPI void PlatformCondvarSignal(platform_condvar* condvar);
+
+// Wakes every thread waiting on the condition variable.
+TAPI void PlatformCondvarBroadcast(platform_condvar* condvar);
+
+// Entry point of a fiber. It must never return; switch to another fiber instead.
+typedef void (*PFN_fiber_start)(void* params);
+
+typedef struct platform_fiber
+{
+    // The fiber's saved context while it is not running.
+    void* internalData;
+} platform_fiber;
+
+/**
+ * Turns the calling thread into a fiber, so it can switch to other fibers and be switched back to.
+ * @param outFiber A pointer to hold the fiber representing the thread.
+ * @returns True on success; otherwise false.
+ */
+TAPI b8 PlatformFiberConvertThread(platform_fiber* outFiber);
+
+// Turns a fiber made by PlatformFiberConvertThread back into a plain thread. Call on that thread.
+TAPI void PlatformFiberConvertBack(platform_fiber* fiber);
+
+/**
+ * Allocates memory to run a fiber on, with an inaccessible guard page below it, so a fiber which
+ * overflows its stack faults right away instead of silently corrupting other memory.
+ * @param size The usable size of the stack in bytes, rounded up to a whole number of pages.
+ * @returns The bottom of the usable stack, page aligned; or 0 on failure.
+ */
+TAPI void* PlatformFiberStackAllocate(u64 size);
+
+// Frees a stack from PlatformFiberStackAllocate, given the same size. No fiber may still run on it.
+TAPI void PlatformFiberStackFree(void* stack, u64 size);
+
+/**
+ * Creates a fiber which will call startFunction the first time it is switched to.
+ * @param stack The memory to run the fiber on. Must be 16-byte aligned, and outlive the fiber.
+ * On Windows the OS owns fiber stacks, so only the start of this is used, for bookkeeping.
+ * @param stackSize The size of stack in bytes.
+ * @param startFunction The function to run on the fiber.
+ * @param params Passed as-is to startFunction. Can be 0/NULL.
+ * @param outFiber A pointer to hold the created fiber.
+ * @returns True on success; otherwise false.
+ */
+TAPI b8 PlatformFiberCreate(void* stack, u64 stackSize, PFN_fiber_start startFunction, void* params, platform_fiber* outFiber);
+
+// Releases a fiber made by PlatformFiberCreate. It must not be running.
+TAPI void PlatformFiberDestroy(platform_fiber* fiber);
+
+/**
+ * Saves the calling fiber's context into from, then resumes to.
+ * Returns once something switches back to from, possibly on another thread.
+ * @param from The fiber currently running on this thread.
+ * @param to The fiber to run.
+ */
+TAPI void PlatformFiberSwitch(platform_fiber* from, platform_fiber* to);
\ No newline at end of file
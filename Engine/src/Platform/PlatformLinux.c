@@ -6,7 +6,9 @@
 #include "Core/Logger.h"
 #include "Core/Event.h"
 #include "Core/Input.h"
+#include "Core/Profiler.h"
 #include "Containers/DArray.h"
+#include "Platform/Atomic.h"
 
 #include <xcb/xcb.h>
 #include <X11/keysym.h>
@@ -14,11 +16,16 @@
 #include <X11/Xlib.h>
 #include <X11/Xlib-xcb.h>  // sudo apt-get install libxkbcommon-x11-dev
 #include <sys/time.h>
+#include <sys/uio.h>  // writev
+#include <sys/mman.h>  // mmap, mprotect
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>  // sched_yield
+#include <unistd.h>  // isatty
+#include <errno.h>
 
 #if _POSIX_C_SOURCE >= 199309L
 #include <time.h>  // nanosleep
-#else
-#include <unistd.h>  // usleep
 #endif
 
 #include <stdlib.h>
@@ -193,6 +200,8 @@ void PlatformSystemShutdown(void* state)
 
 b8 PlatformPumpMessages()
 {
+    TPROFILE_FUNCTION();
+
     if (statePtr)
     {
         xcb_generic_event_t* event;
@@ -270,12 +279,13 @@ b8 PlatformPumpMessages()
                     // The application layer can decide what to do with this.
                     xcb_configure_notify_event_t* configureEvent = (xcb_configure_notify_event_t *)event;
 
-                    // Fire the event. The application layer should pick this up, but not handle it
-                    // as it shouldn be visible to other parts of the application.
+                    // Queue the event. The application layer should pick this up, but not handle it
+                    // as it shouldn be visible to other parts of the application. Resizes are coalesced,
+                    // so dragging the window delivers only the final size each frame.
                     event_context context;
                     context.data.u16[0] = configureEvent->width;
                     context.data.u16[1] = configureEvent->height;
-                    EventFire(EVENT_CODE_RESIZED, 0, context);
+                    EventPost(EVENT_CODE_RESIZED, 0, context);
                 } break;
 
                 case XCB_CLIENT_MESSAGE:
@@ -323,18 +333,144 @@ void* PlatformSetMemory(void* dest, s32 value, u64 size)
     return memset(dest, value, size);
 }
 
+// Console output is gathered here and written with a single write(2) when flushed,
+// rather than making a syscall for every message. Kept outside of the platform
+// state since messages are logged before the platform layer starts up.
+#define CONSOLE_BUFFER_SIZE (32 * 1024)
+
+typedef struct console_buffer
+{
+    // Spinlock guarding everything below; messages can come from any thread.
+    u32 lock;
+    b8 isInitialized;
+    // Colour escapes are only written when the stream is a terminal.
+    b8 stdoutIsTerminal;
+    b8 stderrIsTerminal;
+    u32 length;
+    char data[CONSOLE_BUFFER_SIZE];
+} console_buffer;
+
+static console_buffer consoleBuffer;
+
+// FATAL,ERROR,WARN,INFO,DEBUG,TRACE
+static const char* colourStrings[] = {"\033[0;41m", "\033[1;31m", "\033[1;33m", "\033[1;32m", "\033[1;34m", "\033[1;30m"};
+static const char* colourReset = "\033[0m";
+
+static void ConsoleLock()
+{
+    while (AtomicExchange32(&consoleBuffer.lock, 1, ATOMIC_ACQUIRE))
+    {
+        while (AtomicLoad32(&consoleBuffer.lock, ATOMIC_RELAXED))
+        {
+            AtomicPause();
+        }
+    }
+
+    if (!consoleBuffer.isInitialized)
+    {
+        consoleBuffer.stdoutIsTerminal = isatty(STDOUT_FILENO);
+        consoleBuffer.stderrIsTerminal = isatty(STDERR_FILENO);
+        consoleBuffer.isInitialized = true;
+    }
+}
+
+static void ConsoleUnlock()
+{
+    AtomicStore32(&consoleBuffer.lock, 0, ATOMIC_RELEASE);
+}
+
+// Writes all of the given pieces to a file descriptor, retrying on partial writes.
+static void WriteAll(s32 fd, struct iovec* pieces, s32 count)
+{
+    while (count > 0)
+    {
+        ssize_t written = writev(fd, pieces, count);
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            return;
+        }
+
+        while (count > 0 && (size_t)written >= pieces->iov_len)
+        {
+            written -= pieces->iov_len;
+            pieces++;
+            count--;
+        }
+        if (count > 0)
+        {
+            pieces->iov_base = (char*)pieces->iov_base + written;
+            pieces->iov_len -= written;
+        }
+    }
+}
+
+// Must be called with the console lock held.
+static void ConsoleFlushLocked()
+{
+    if (consoleBuffer.length)
+    {
+        struct iovec piece = {consoleBuffer.data, consoleBuffer.length};
+        WriteAll(STDOUT_FILENO, &piece, 1);
+        consoleBuffer.length = 0;
+    }
+}
+
 void PlatformConsoleWrite(const char* message, u8 colour)
 {
-    // FATAL,ERROR,WARN,INFO,DEBUG,TRACE
-    const char* colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
-    printf("\033[%sm%s\033[0m", colour_strings[colour], message);
+    u64 messageLength = strlen(message);
+
+    ConsoleLock();
+    const char* prefix = consoleBuffer.stdoutIsTerminal ? colourStrings[colour] : "";
+    const char* suffix = consoleBuffer.stdoutIsTerminal ? colourReset : "";
+    u64 prefixLength = strlen(prefix);
+    u64 suffixLength = strlen(suffix);
+    u64 total = prefixLength + messageLength + suffixLength;
+
+    if (consoleBuffer.length + total > CONSOLE_BUFFER_SIZE)
+    {
+        ConsoleFlushLocked();
+    }
+
+    if (total > CONSOLE_BUFFER_SIZE)
+    {
+        // Too big to ever be buffered; send it straight out.
+        struct iovec pieces[3] = {{(void*)prefix, prefixLength}, {(void*)message, messageLength}, {(void*)suffix, suffixLength}};
+        WriteAll(STDOUT_FILENO, pieces, 3);
+    }
+    else
+    {
+        char* out = consoleBuffer.data + consoleBuffer.length;
+        memcpy(out, prefix, prefixLength);
+        memcpy(out + prefixLength, message, messageLength);
+        memcpy(out + prefixLength + messageLength, suffix, suffixLength);
+        consoleBuffer.length += total;
+    }
+    ConsoleUnlock();
 }
 
 void PlatformConsoleWriteError(const char* message, u8 colour)
 {
-    // FATAL,ERROR,WARN,INFO,DEBUG,TRACE
-    const char* colour_strings[] = {"0;41", "1;31", "1;33", "1;32", "1;34", "1;30"};
-    printf("\033[%sm%s\033[0m", colour_strings[colour], message);
+    ConsoleLock();
+    // Anything written to stdout before this has to appear first.
+    ConsoleFlushLocked();
+
+    // Errors are not buffered, so they are out before anything can go wrong.
+    const char* prefix = consoleBuffer.stderrIsTerminal ? colourStrings[colour] : "";
+    const char* suffix = consoleBuffer.stderrIsTerminal ? colourReset : "";
+    struct iovec pieces[3] = {{(void*)prefix, strlen(prefix)}, {(void*)message, strlen(message)}, {(void*)suffix, strlen(suffix)}};
+    WriteAll(STDERR_FILENO, pieces, 3);
+    ConsoleUnlock();
+}
+
+void PlatformConsoleFlush()
+{
+    // Cheap enough to call every frame when there is nothing to write.
+    if (AtomicLoad32(&consoleBuffer.length, ATOMIC_RELAXED) == 0) return;
+
+    ConsoleLock();
+    ConsoleFlushLocked();
+    ConsoleUnlock();
 }
 
 f64 PlatformGetAbsoluteTime()
@@ -344,6 +480,14 @@ f64 PlatformGetAbsoluteTime()
     return now.tv_sec + now.tv_nsec * 0.000000001;
 }
 
+u64 PlatformGetTimestampNs()
+{
+    // The raw clock is not slewed by NTP, so short spans are measured exactly.
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+    return (u64)now.tv_sec * 1000000000ULL + (u64)now.tv_nsec;
+}
+
 void PlatformSleep(u64 ms)
 {
 #if _POSIX_C_SOURCE >= 199309L
@@ -360,6 +504,515 @@ void PlatformSleep(u64 ms)
 #endif
 }
 
+void PlatformSleepNs(u64 ns)
+{
+    struct timespec ts;
+    ts.tv_sec = ns / 1000000000ULL;
+    ts.tv_nsec = ns % 1000000000ULL;
+    // Carry on with whatever is left if a signal interrupts the sleep.
+    while (clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, &ts) == EINTR)
+    {
+    }
+}
+
+// pthreads expects void* (*)(void*), so the start function and its params
+// are carried through a small heap block and unpacked on the new thread.
+typedef struct linux_thread_start
+{
+    PFN_thread_start function;
+    void* params;
+} linux_thread_start;
+
+static void* LinuxThreadStart(void* params)
+{
+    linux_thread_start start = *(linux_thread_start*)params;
+    PlatformFree(params, false);
+    return (void*)(u64)start.function(start.params);
+}
+
+b8 PlatformThreadCreate(PFN_thread_start startFunction, void* params, platform_thread* outThread)
+{
+    if (!startFunction) return false;
+
+    linux_thread_start* start = PlatformAllocate(sizeof(linux_thread_start), false);
+    start->function = startFunction;
+    start->params = params;
+
+    pthread_t handle;
+    s32 result = pthread_create(&handle, 0, LinuxThreadStart, start);
+    if (result != 0)
+    {
+        PlatformFree(start, false);
+        TERROR("PlatformThreadCreate - pthread_create failed with error %d.", result);
+        return false;
+    }
+
+    outThread->internalData = (void*)handle;
+    outThread->threadId = (u64)handle;
+    return true;
+}
+
+void PlatformThreadJoin(platform_thread* thread)
+{
+    if (thread && thread->internalData)
+    {
+        pthread_join((pthread_t)thread->internalData, 0);
+        thread->internalData = 0;
+        thread->threadId = 0;
+    }
+}
+
+u64 PlatformThreadGetCurrentId()
+{
+    return (u64)pthread_self();
+}
+
+void PlatformThreadYield()
+{
+    sched_yield();
+}
+
+u32 PlatformGetProcessorCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+// Reads a single integer from a sysfs file, or returns false if it cannot.
+static b8 ReadSysfsInt(const char* path, s32* outValue)
+{
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    b8 result = fscanf(file, "%d", outValue) == 1;
+    fclose(file);
+    return result;
+}
+
+u32 PlatformGetPhysicalCoreCount()
+{
+    u32 logicalCount = PlatformGetProcessorCount();
+
+    // A core is a unique (package, core) pair; hyper-threaded siblings share one.
+    struct
+    {
+        s32 package;
+        s32 core;
+    } cores[256];
+    u32 coreCount = 0;
+    char path[128];
+    for (u32 cpu = 0; cpu < logicalCount && coreCount < 256; cpu++)
+    {
+        s32 package, core;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/physical_package_id", cpu);
+        if (!ReadSysfsInt(path, &package)) return logicalCount;
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/core_id", cpu);
+        if (!ReadSysfsInt(path, &core)) return logicalCount;
+
+        b8 seen = false;
+        for (u32 i = 0; i < coreCount && !seen; i++)
+        {
+            seen = cores[i].package == package && cores[i].core == core;
+        }
+        if (!seen)
+        {
+            cores[coreCount].package = package;
+            cores[coreCount].core = core;
+            coreCount++;
+        }
+    }
+
+    return coreCount ? coreCount : logicalCount;
+}
+
+// Converts a relative timeout to the absolute time pthreads waits until.
+static void TimeoutToTimespec(clockid_t clock, u64 timeoutMs, struct timespec* outTime)
+{
+    clock_gettime(clock, outTime);
+    outTime->tv_sec += timeoutMs / 1000;
+    outTime->tv_nsec += (timeoutMs % 1000) * 1000 * 1000;
+    if (outTime->tv_nsec >= 1000 * 1000 * 1000)
+    {
+        outTime->tv_sec++;
+        outTime->tv_nsec -= 1000 * 1000 * 1000;
+    }
+}
+
+b8 PlatformMutexCreate(platform_mutex* outMutex)
+{
+    pthread_mutex_t* mutex = PlatformAllocate(sizeof(pthread_mutex_t), false);
+    s32 result = pthread_mutex_init(mutex, 0);
+    if (result != 0)
+    {
+        PlatformFree(mutex, false);
+        TERROR("PlatformMutexCreate - pthread_mutex_init failed with error %d.", result);
+        return false;
+    }
+
+    outMutex->internalData = mutex;
+    return true;
+}
+
+void PlatformMutexDestroy(platform_mutex* mutex)
+{
+    if (mutex && mutex->internalData)
+    {
+        pthread_mutex_destroy(mutex->internalData);
+        PlatformFree(mutex->internalData, false);
+        mutex->internalData = 0;
+    }
+}
+
+void PlatformMutexLock(platform_mutex* mutex)
+{
+    pthread_mutex_lock(mutex->internalData);
+}
+
+void PlatformMutexUnlock(platform_mutex* mutex)
+{
+    pthread_mutex_unlock(mutex->internalData);
+}
+
+b8 PlatformSemaphoreCreate(u32 initialCount, platform_semaphore* outSemaphore)
+{
+    sem_t* semaphore = PlatformAllocate(sizeof(sem_t), false);
+    if (sem_init(semaphore, 0, initialCount) != 0)
+    {
+        PlatformFree(semaphore, false);
+        TERROR("PlatformSemaphoreCreate - sem_init failed with error %d.", errno);
+        return false;
+    }
+
+    outSemaphore->internalData = semaphore;
+    return true;
+}
+
+void PlatformSemaphoreDestroy(platform_semaphore* semaphore)
+{
+    if (semaphore && semaphore->internalData)
+    {
+        sem_destroy(semaphore->internalData);
+        PlatformFree(semaphore->internalData, false);
+        semaphore->internalData = 0;
+    }
+}
+
+void PlatformSemaphoreSignal(platform_semaphore* semaphore, u32 count)
+{
+    for (u32 i = 0; i < count; i++)
+    {
+        sem_post(semaphore->internalData);
+    }
+}
+
+b8 PlatformSemaphoreWait(platform_semaphore* semaphore, u64 timeoutMs)
+{
+    s32 result;
+    if (timeoutMs == PLATFORM_WAIT_INFINITE)
+    {
+        while ((result = sem_wait(semaphore->internalData)) != 0 && errno == EINTR)
+        {
+        }
+    }
+    else if (timeoutMs == 0)
+    {
+        result = sem_trywait(semaphore->internalData);
+    }
+    else
+    {
+        // sem_timedwait only takes a CLOCK_REALTIME deadline.
+        struct timespec deadline;
+        TimeoutToTimespec(CLOCK_REALTIME, timeoutMs, &deadline);
+        while ((result = sem_timedwait(semaphore->internalData, &deadline)) != 0 && errno == EINTR)
+        {
+        }
+    }
+    return result == 0;
+}
+
+b8 PlatformCondvarCreate(platform_condvar* outCondvar)
+{
+    pthread_cond_t* condvar = PlatformAllocate(sizeof(pthread_cond_t), false);
+
+    // Wait on the monotonic clock so timeouts are unaffected by the wall clock changing.
+    pthread_condattr_t attributes;
+    pthread_condattr_init(&attributes);
+    pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+    s32 result = pthread_cond_init(condvar, &attributes);
+    pthread_condattr_destroy(&attributes);
+    if (result != 0)
+    {
+        PlatformFree(condvar, false);
+        TERROR("PlatformCondvarCreate - pthread_cond_init failed with error %d.", result);
+        return false;
+    }
+
+    outCondvar->internalData = condvar;
+    return true;
+}
+
+void PlatformCondvarDestroy(platform_condvar* condvar)
+{
+    if (condvar && condvar->internalData)
+    {
+        pthread_cond_destroy(condvar->internalData);
+        PlatformFree(condvar->internalData, false);
+        condvar->internalData = 0;
+    }
+}
+
+b8 PlatformCondvarWait(platform_condvar* condvar, platform_mutex* mutex, u64 timeoutMs)
+{
+    if (timeoutMs == PLATFORM_WAIT_INFINITE)
+    {
+        return pthread_cond_wait(condvar->internalData, mutex->internalData) == 0;
+    }
+
+    struct timespec deadline;
+    TimeoutToTimespec(CLOCK_MONOTONIC, timeoutMs, &deadline);
+    return pthread_cond_timedwait(condvar->internalData, mutex->internalData, &deadline) != ETIMEDOUT;
+}
+
+void PlatformCondvarSignal(platform_condvar* condvar)
+{
+    pthread_cond_signal(condvar->internalData);
+}
+
+void PlatformCondvarBroadcast(platform_condvar* condvar)
+{
+    pthread_cond_broadcast(condvar->internalData);
+}
+
+void* PlatformFiberStackAllocate(u64 size)
+{
+    u64 pageSize = (u64)sysconf(_SC_PAGESIZE);
+    size = (size + pageSize - 1) & ~(pageSize - 1);
+    u8* block = mmap(0, pageSize + size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (block == MAP_FAILED) return 0;
+
+    // Stacks grow down, so the guard page goes at the bottom.
+    if (mprotect(block, pageSize, PROT_NONE) != 0)
+    {
+        munmap(block, pageSize + size);
+        return 0;
+    }
+    return block + pageSize;
+}
+
+void PlatformFiberStackFree(void* stack, u64 size)
+{
+    if (!stack) return;
+    u64 pageSize = (u64)sysconf(_SC_PAGESIZE);
+    size = (size + pageSize - 1) & ~(pageSize - 1);
+    munmap((u8*)stack - pageSize, pageSize + size);
+}
+
+#if defined(__x86_64__) || defined(__aarch64__)
+/*
+Fibers switch with a few instructions of our own rather than swapcontext, which
+also saves and restores the signal mask with a system call every time. Only the
+registers the calling convention says a function must preserve are saved, on the
+fiber's own stack; internalData then holds the saved stack pointer.
+*/
+
+// Saves the callee-saved registers on the current stack, stores the stack pointer
+// in *fromStack, then restores the registers saved on toStack and returns there.
+void FiberSwitchContext(void** fromStack, void* toStack);
+// Where a new fiber's first switch returns to. Calls the start function, held in a saved register.
+void FiberStartTrampoline();
+
+#if defined(__x86_64__)
+// System V: rbx, rbp and r12-r15, plus the SSE and x87 control words.
+__asm__(
+    ".text\n"
+    ".globl FiberSwitchContext\n"
+    ".hidden FiberSwitchContext\n"
+    ".type FiberSwitchContext, @function\n"
+    "FiberSwitchContext:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size FiberSwitchContext, .-FiberSwitchContext\n"
+    ".globl FiberStartTrampoline\n"
+    ".hidden FiberStartTrampoline\n"
+    ".type FiberStartTrampoline, @function\n"
+    "FiberStartTrampoline:\n"
+    "    movq %r13, %rdi\n"
+    "    callq *%r12\n"
+    "    ud2\n"
+    ".size FiberStartTrampoline, .-FiberStartTrampoline\n");
+
+// Control words, r15, r14, r13 (params), r12 (start), rbx, rbp, return address.
+#define FIBER_FRAME_SLOTS 8
+#define FIBER_FRAME_START_SLOT 4
+#define FIBER_FRAME_PARAMS_SLOT 3
+#define FIBER_FRAME_RETURN_SLOT 7
+#else
+// AAPCS64: x19-x29, the link register and the low halves of v8-v15.
+__asm__(
+    ".text\n"
+    ".globl FiberSwitchContext\n"
+    ".hidden FiberSwitchContext\n"
+    ".type FiberSwitchContext, %function\n"
+    "FiberSwitchContext:\n"
+    "    sub sp, sp, #160\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mov x2, sp\n"
+    "    str x2, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #160\n"
+    "    ret\n"
+    ".size FiberSwitchContext, .-FiberSwitchContext\n"
+    ".globl FiberStartTrampoline\n"
+    ".hidden FiberStartTrampoline\n"
+    ".type FiberStartTrampoline, %function\n"
+    "FiberStartTrampoline:\n"
+    "    mov x0, x20\n"
+    "    blr x19\n"
+    "    brk #0\n"
+    ".size FiberStartTrampoline, .-FiberStartTrampoline\n");
+
+// x19 (start), x20 (params), x21-x28, x29, x30 (return address), d8-d15.
+#define FIBER_FRAME_SLOTS 20
+#define FIBER_FRAME_START_SLOT 0
+#define FIBER_FRAME_PARAMS_SLOT 1
+#define FIBER_FRAME_RETURN_SLOT 11
+#endif
+
+b8 PlatformFiberConvertThread(platform_fiber* outFiber)
+{
+    // The thread's context is saved on its own stack the first time it switches away.
+    outFiber->internalData = 0;
+    return true;
+}
+
+void PlatformFiberConvertBack(platform_fiber* fiber)
+{
+    fiber->internalData = 0;
+}
+
+b8 PlatformFiberCreate(void* stack, u64 stackSize, PFN_fiber_start startFunction, void* params, platform_fiber* outFiber)
+{
+    // Lay out a frame at the top of the stack as if the fiber had just switched away,
+    // so the first switch to it "returns" into the trampoline.
+    u64 top = ((u64)stack + stackSize) & ~(u64)15;
+    u64* frame = (u64*)(top - FIBER_FRAME_SLOTS * sizeof(u64));
+    PlatformZeroMemory(frame, FIBER_FRAME_SLOTS * sizeof(u64));
+#if defined(__x86_64__)
+    // Default MXCSR and x87 control word.
+    frame[0] = 0x1F80 | ((u64)0x037F << 32);
+#endif
+    frame[FIBER_FRAME_START_SLOT] = (u64)startFunction;
+    frame[FIBER_FRAME_PARAMS_SLOT] = (u64)params;
+    frame[FIBER_FRAME_RETURN_SLOT] = (u64)FiberStartTrampoline;
+    outFiber->internalData = frame;
+    return true;
+}
+
+void PlatformFiberDestroy(platform_fiber* fiber)
+{
+    // Nothing to release; the stack belongs to the caller.
+    fiber->internalData = 0;
+}
+
+void PlatformFiberSwitch(platform_fiber* from, platform_fiber* to)
+{
+    FiberSwitchContext(&from->internalData, to->internalData);
+}
+#else
+// Elsewhere, fall back to ucontext. Each fiber's context lives at the top of its stack.
+#include <ucontext.h>
+
+typedef struct linux_fiber_start
+{
+    PFN_fiber_start startFunction;
+    void* params;
+} linux_fiber_start;
+
+// makecontext only passes ints, so the start info arrives split in two.
+static void FiberStart(u32 high, u32 low)
+{
+    linux_fiber_start* start = (linux_fiber_start*)(((u64)high << 32) | low);
+    start->startFunction(start->params);
+    abort();
+}
+
+b8 PlatformFiberConvertThread(platform_fiber* outFiber)
+{
+    outFiber->internalData = malloc(sizeof(ucontext_t));
+    return outFiber->internalData != 0;
+}
+
+void PlatformFiberConvertBack(platform_fiber* fiber)
+{
+    free(fiber->internalData);
+    fiber->internalData = 0;
+}
+
+b8 PlatformFiberCreate(void* stack, u64 stackSize, PFN_fiber_start startFunction, void* params, platform_fiber* outFiber)
+{
+    u64 top = ((u64)stack + stackSize - sizeof(ucontext_t) - sizeof(linux_fiber_start)) & ~(u64)15;
+    ucontext_t* context = (ucontext_t*)top;
+    linux_fiber_start* start = (linux_fiber_start*)(top + sizeof(ucontext_t));
+    start->startFunction = startFunction;
+    start->params = params;
+
+    if (getcontext(context) != 0) return false;
+    context->uc_stack.ss_sp = stack;
+    context->uc_stack.ss_size = top - (u64)stack;
+    context->uc_link = 0;
+    makecontext(context, (void (*)())FiberStart, 2, (u32)((u64)start >> 32), (u32)(u64)start);
+    outFiber->internalData = context;
+    return true;
+}
+
+void PlatformFiberDestroy(platform_fiber* fiber)
+{
+    fiber->internalData = 0;
+}
+
+void PlatformFiberSwitch(platform_fiber* from, platform_fiber* to)
+{
+    swapcontext(from->internalData, to->internalData);
+}
+#endif
+
 void PlatformGetRequiredExtensionNames(const char*** namesDArray)
 {
     DArrayPush(*namesDArray, &"VK_KHR_xcb_surface");
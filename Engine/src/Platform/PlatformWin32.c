@@ -5,6 +5,7 @@
 
 #include "Core/Logger.h"
 #include "Core/Input.h"
+#include "Core/Profiler.h"
 #include "Core/Event.h"
 #include "Containers/DArray.h"
 
@@ -146,6 +147,8 @@ void PlatformSystemShutdown(void* state)
 
 b8 PlatformPumpMessages()
 {
+    TPROFILE_FUNCTION();
+
     if (statePtr)
     {
         MSG message;
@@ -208,6 +211,11 @@ void PlatformConsoleWriteError(const char* message, u8 colour)
     WriteConsoleA(GetStdHandle(STD_ERROR_HANDLE), message, (DWORD)length, number_written, 0);
 }
 
+void PlatformConsoleFlush()
+{
+    // Console writes are not buffered on Windows.
+}
+
 f64 PlatformGetAbsoluteTime()
 {
     if (!clockFrequency)
@@ -218,11 +226,299 @@ f64 PlatformGetAbsoluteTime()
     return (f64)nowTime.QuadPart * clockFrequency;
 }
 
+u64 PlatformGetTimestampNs()
+{
+    static LARGE_INTEGER frequency;
+    if (!frequency.QuadPart) QueryPerformanceFrequency(&frequency);
+
+    // Split the conversion so the multiply cannot overflow.
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    u64 seconds = (u64)now.QuadPart / (u64)frequency.QuadPart;
+    u64 remainder = (u64)now.QuadPart % (u64)frequency.QuadPart;
+    return seconds * 1000000000ULL + remainder * 1000000000ULL / (u64)frequency.QuadPart;
+}
+
 void PlatformSleep(u64 ms)
 {
     Sleep(ms);
 }
 
+// Missing from older SDK headers. Supported from Windows 10, version 1803.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// Each sleeping thread keeps its own timer, created on its first sleep, rather than paying
+// for a new one every time. Never closed; there are only ever a handful of threads.
+static _Thread_local HANDLE sleepTimer;
+// Set if the timer could not be created, so Sleep is used from then on.
+static _Thread_local b8 sleepTimerUnavailable;
+
+void PlatformSleepNs(u64 ns)
+{
+    // A high resolution timer wakes far closer to the requested time than Sleep,
+    // which rounds up to the system tick.
+    if (!sleepTimer && !sleepTimerUnavailable)
+    {
+        sleepTimer = CreateWaitableTimerExW(0, 0, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        sleepTimerUnavailable = sleepTimer == 0;
+    }
+
+    // Negative for a relative time, in 100ns units.
+    LARGE_INTEGER dueTime;
+    dueTime.QuadPart = -(LONGLONG)(ns / 100);
+    if (sleepTimer && SetWaitableTimer(sleepTimer, &dueTime, 0, 0, 0, FALSE))
+    {
+        WaitForSingleObject(sleepTimer, INFINITE);
+        return;
+    }
+    Sleep((DWORD)(ns / 1000000));
+}
+
+b8 PlatformThreadCreate(PFN_thread_start startFunction, void* params, platform_thread* outThread)
+{
+    if (!startFunction) return false;
+
+    DWORD threadId;
+    HANDLE handle = CreateThread(0, 0, (LPTHREAD_START_ROUTINE)startFunction, params, 0, &threadId);
+    if (!handle)
+    {
+        TERROR("PlatformThreadCreate - CreateThread failed with error %lu.", GetLastError());
+        return false;
+    }
+
+    outThread->internalData = handle;
+    outThread->threadId = threadId;
+    return true;
+}
+
+void PlatformThreadJoin(platform_thread* thread)
+{
+    if (thread && thread->internalData)
+    {
+        WaitForSingleObject((HANDLE)thread->internalData, INFINITE);
+        CloseHandle((HANDLE)thread->internalData);
+        thread->internalData = 0;
+        thread->threadId = 0;
+    }
+}
+
+u64 PlatformThreadGetCurrentId()
+{
+    return (u64)GetCurrentThreadId();
+}
+
+void PlatformThreadYield()
+{
+    SwitchToThread();
+}
+
+u32 PlatformGetProcessorCount()
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwNumberOfProcessors;
+}
+
+u32 PlatformGetPhysicalCoreCount()
+{
+    DWORD length = 0;
+    GetLogicalProcessorInformation(0, &length);
+    if (length == 0) return PlatformGetProcessorCount();
+
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION* info = malloc(length);
+    if (!info) return PlatformGetProcessorCount();
+
+    u32 coreCount = 0;
+    if (GetLogicalProcessorInformation(info, &length))
+    {
+        DWORD entryCount = length / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION);
+        for (DWORD i = 0; i < entryCount; i++)
+        {
+            if (info[i].Relationship == RelationProcessorCore) coreCount++;
+        }
+    }
+    free(info);
+
+    return coreCount ? coreCount : PlatformGetProcessorCount();
+}
+
+// Converts a timeout to what the Win32 wait functions take.
+static DWORD TimeoutToMs(u64 timeoutMs)
+{
+    if (timeoutMs == PLATFORM_WAIT_INFINITE) return INFINITE;
+    return timeoutMs >= INFINITE ? INFINITE - 1 : (DWORD)timeoutMs;
+}
+
+b8 PlatformMutexCreate(platform_mutex* outMutex)
+{
+    SRWLOCK* lock = PlatformAllocate(sizeof(SRWLOCK), false);
+    InitializeSRWLock(lock);
+    outMutex->internalData = lock;
+    return true;
+}
+
+void PlatformMutexDestroy(platform_mutex* mutex)
+{
+    if (mutex && mutex->internalData)
+    {
+        // SRW locks need no cleanup beyond freeing their memory.
+        PlatformFree(mutex->internalData, false);
+        mutex->internalData = 0;
+    }
+}
+
+void PlatformMutexLock(platform_mutex* mutex)
+{
+    AcquireSRWLockExclusive(mutex->internalData);
+}
+
+void PlatformMutexUnlock(platform_mutex* mutex)
+{
+    ReleaseSRWLockExclusive(mutex->internalData);
+}
+
+b8 PlatformSemaphoreCreate(u32 initialCount, platform_semaphore* outSemaphore)
+{
+    HANDLE handle = CreateSemaphoreA(0, initialCount, 0x7FFFFFFF, 0);
+    if (!handle)
+    {
+        TERROR("PlatformSemaphoreCreate - CreateSemaphore failed with error %lu.", GetLastError());
+        return false;
+    }
+
+    outSemaphore->internalData = handle;
+    return true;
+}
+
+void PlatformSemaphoreDestroy(platform_semaphore* semaphore)
+{
+    if (semaphore && semaphore->internalData)
+    {
+        CloseHandle(semaphore->internalData);
+        semaphore->internalData = 0;
+    }
+}
+
+void PlatformSemaphoreSignal(platform_semaphore* semaphore, u32 count)
+{
+    if (count) ReleaseSemaphore(semaphore->internalData, count, 0);
+}
+
+b8 PlatformSemaphoreWait(platform_semaphore* semaphore, u64 timeoutMs)
+{
+    return WaitForSingleObject(semaphore->internalData, TimeoutToMs(timeoutMs)) == WAIT_OBJECT_0;
+}
+
+b8 PlatformCondvarCreate(platform_condvar* outCondvar)
+{
+    CONDITION_VARIABLE* condvar = PlatformAllocate(sizeof(CONDITION_VARIABLE), false);
+    InitializeConditionVariable(condvar);
+    outCondvar->internalData = condvar;
+    return true;
+}
+
+void PlatformCondvarDestroy(platform_condvar* condvar)
+{
+    if (condvar && condvar->internalData)
+    {
+        PlatformFree(condvar->internalData, false);
+        condvar->internalData = 0;
+    }
+}
+
+b8 PlatformCondvarWait(platform_condvar* condvar, platform_mutex* mutex, u64 timeoutMs)
+{
+    return SleepConditionVariableSRW(condvar->internalData, mutex->internalData, TimeoutToMs(timeoutMs), 0) != 0;
+}
+
+void PlatformCondvarSignal(platform_condvar* condvar)
+{
+    WakeConditionVariable(condvar->internalData);
+}
+
+void PlatformCondvarBroadcast(platform_condvar* condvar)
+{
+    WakeAllConditionVariable(condvar->internalData);
+}
+
+void* PlatformFiberStackAllocate(u64 size)
+{
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    u64 pageSize = systemInfo.dwPageSize;
+    size = (size + pageSize - 1) & ~(pageSize - 1);
+    u8* block = VirtualAlloc(0, pageSize + size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    if (!block) return 0;
+
+    // Stacks grow down, so the guard page goes at the bottom. Unlike PAGE_GUARD, which is
+    // lifted by the first touch, PAGE_NOACCESS faults on every overflow.
+    DWORD oldProtect;
+    if (!VirtualProtect(block, pageSize, PAGE_NOACCESS, &oldProtect))
+    {
+        VirtualFree(block, 0, MEM_RELEASE);
+        return 0;
+    }
+    return block + pageSize;
+}
+
+void PlatformFiberStackFree(void* stack, u64 size)
+{
+    if (!stack) return;
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    VirtualFree((u8*)stack - systemInfo.dwPageSize, 0, MEM_RELEASE);
+}
+
+// Kept at the start of the caller's stack memory, since the OS provides the real stack.
+typedef struct win32_fiber_start
+{
+    PFN_fiber_start startFunction;
+    void* params;
+} win32_fiber_start;
+
+static VOID CALLBACK Win32FiberStart(LPVOID params)
+{
+    win32_fiber_start* start = params;
+    start->startFunction(start->params);
+}
+
+b8 PlatformFiberConvertThread(platform_fiber* outFiber)
+{
+    outFiber->internalData = ConvertThreadToFiber(0);
+    return outFiber->internalData != 0;
+}
+
+void PlatformFiberConvertBack(platform_fiber* fiber)
+{
+    ConvertFiberToThread();
+    fiber->internalData = 0;
+}
+
+b8 PlatformFiberCreate(void* stack, u64 stackSize, PFN_fiber_start startFunction, void* params, platform_fiber* outFiber)
+{
+    win32_fiber_start* start = stack;
+    start->startFunction = startFunction;
+    start->params = params;
+    outFiber->internalData = CreateFiberEx(stackSize, stackSize, 0, Win32FiberStart, start);
+    return outFiber->internalData != 0;
+}
+
+void PlatformFiberDestroy(platform_fiber* fiber)
+{
+    if (fiber->internalData)
+    {
+        DeleteFiber(fiber->internalData);
+        fiber->internalData = 0;
+    }
+}
+
+void PlatformFiberSwitch(platform_fiber* from, platform_fiber* to)
+{
+    SwitchToFiber(to->internalData);
+}
+
 void PlatformGetRequiredExtensionNames(const char*** namesDArray)
 {
     DArrayPush(*namesDArray, &"VK_KHR_win32_surface");
@@ -270,12 +566,13 @@ LRESULT CALLBACK Win32ProcMessage(HWND hwnd, u32 msg, WPARAM wParam, LPARAM lPar
             u32 width = r.right - r.left;
             u32 height = r.bottom - r.top;
 
-            // Fire the event. The application layer should pick this up, but not handle it
-            // as it shouldn be visible to other parts of the application.
+            // Queue the event. The application layer should pick this up, but not handle it
+            // as it shouldn be visible to other parts of the application. Resizes are coalesced,
+            // so dragging the window delivers only the final size each frame.
             event_context context;
             context.data.u16[0] = (u16)width;
             context.data.u16[1] = (u16)height;
-            EventFire(EVENT_CODE_RESIZED, 0, context);
+            EventPost(EVENT_CODE_RESIZED, 0, context);
         } break;
         case WM_KEYDOWN:
         case WM_SYSKEYDOWN:
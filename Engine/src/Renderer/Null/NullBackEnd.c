@@ -0,0 +1,138 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
+#include "NullBackEnd.h"
+#include "Core/Logger.h"
+#include "Core/TMemory.h"
+#include "Core/Application.h"
+
+typedef struct null_renderer_state
+{
+    null_renderer_stats stats;
+    u32 framebufferWidth;
+    u32 framebufferHeight;
+    // Objects and instanced draws so far in the frame being recorded.
+    u64 frameDrawCount;
+    u64 frameBatchCount;
+    b8 inFrame;
+} null_renderer_state;
+
+// Like the Vulkan backend's context, there is only ever one.
+static null_renderer_state state;
+
+b8 NullRendererBackendInitialize(renderer_backend* backend, const char* applicationName)
+{
+    TZeroMemory(&state, sizeof(null_renderer_state));
+    state.stats.initializeCalls = 1;
+
+    ApplicationGetFramebufferSize(&state.framebufferWidth, &state.framebufferHeight);
+    if (state.framebufferWidth == 0) state.framebufferWidth = 800;
+    if (state.framebufferHeight == 0) state.framebufferHeight = 600;
+
+    TINFO("Null renderer initialized. Nothing will be drawn.");
+    return true;
+}
+
+void NullRendererBackendShutdown(renderer_backend* backend)
+{
+    state.stats.shutdownCalls++;
+    if (state.stats.liveTextureCount)
+    {
+        TWARN("Null renderer shut down with %llu textures not destroyed.", state.stats.liveTextureCount);
+    }
+    TDEBUG("Null renderer drew %llu objects over %llu frames.", state.stats.drawCount, state.stats.frameCount);
+}
+
+void NullRendererBackendOnResize(renderer_backend* backend, u16 width, u16 height)
+{
+    state.stats.resizedCalls++;
+    state.framebufferWidth = width;
+    state.framebufferHeight = height;
+}
+
+b8 NullRendererBackendBeginFrame(renderer_backend* backend, f32 dt)
+{
+    state.stats.beginFrameCalls++;
+    state.frameDrawCount = 0;
+    state.frameBatchCount = 0;
+    state.inFrame = true;
+    return true;
+}
+
+void NullRendererUpdateGlobalState(mat4 projection, mat4 view, vec3 viewPosition, vec4 ambientColour, s32 mode)
+{
+    state.stats.updateGlobalStateCalls++;
+    state.stats.uniformBytesUploaded += sizeof(global_uniform_object);
+}
+
+b8 NullRendererBackendEndFrame(renderer_backend* backend, f32 dt)
+{
+    state.stats.endFrameCalls++;
+    if (!state.inFrame)
+    {
+        TERROR("NullRendererBackendEndFrame called without a frame begun.");
+        return false;
+    }
+
+    state.inFrame = false;
+    state.stats.frameCount++;
+    state.stats.lastFrameDrawCount = state.frameDrawCount;
+    state.stats.lastFrameBatchCount = state.frameBatchCount;
+    return true;
+}
+
+void NullRendererDrawList(renderer_backend* backend, const render_draw* draws, const u32* order, u32 drawCount)
+{
+    state.stats.drawListCalls++;
+    state.stats.uniformBytesUploaded += sizeof(mat4) * (u64)drawCount;
+    state.stats.drawCount += drawCount;
+    state.frameDrawCount += drawCount;
+
+    // Batched as the Vulkan backend would, to count the draw calls it would have made.
+    for (u32 i = 0; i < drawCount;)
+    {
+        i += RendererBackendBatchLength(draws, &order[i], drawCount - i);
+        state.stats.batchCount++;
+        state.frameBatchCount++;
+    }
+}
+
+void NullRendererCreateTexture(const char* name, b8 autoRelease, s32 width, s32 height, s32 channelCount, const u8* pixels, b8 hasTransparency, texture* outTexture)
+{
+    state.stats.createTextureCalls++;
+    state.stats.textureBytesUploaded += (u64)width * height * channelCount;
+    state.stats.liveTextureCount++;
+
+    outTexture->width = width;
+    outTexture->height = height;
+    outTexture->channelCount = channelCount;
+    outTexture->hasTransparency = hasTransparency;
+    outTexture->internalData = 0;
+    outTexture->generation = 1;
+}
+
+void NullRendererDestroyTexture(texture* texture)
+{
+    state.stats.destroyTextureCalls++;
+    if (state.stats.liveTextureCount) state.stats.liveTextureCount--;
+
+    TZeroMemory(texture, sizeof(struct texture));
+}
+
+b8 NullRendererBackendReadFrame(renderer_backend* backend, u32* outWidth, u32* outHeight, u8* outPixels)
+{
+    state.stats.readFrameCalls++;
+
+    // Nothing is ever drawn, so every frame is blank.
+    *outWidth = state.framebufferWidth;
+    *outHeight = state.framebufferHeight;
+    if (outPixels)
+    {
+        TZeroMemory(outPixels, (u64)state.framebufferWidth * state.framebufferHeight * 4);
+    }
+    return true;
+}
+
+void NullRendererGetStats(null_renderer_stats* outStats)
+{
+    *outStats = state.stats;
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+#include "Renderer/RendererBackEnd.h"
+#include "Resources/ResourceTypes.h"
+
+/*
+A renderer backend which touches no GPU. Every call is counted instead, along with what it
+would have uploaded and drawn, so the front end's costs can be measured on their own and the
+whole loop can run where there is no GPU at all.
+*/
+
+// What the null backend has been asked to do since it was initialized.
+typedef struct null_renderer_stats
+{
+    // Calls to each backend function.
+    u64 initializeCalls;
+    u64 shutdownCalls;
+    u64 resizedCalls;
+    u64 beginFrameCalls;
+    u64 updateGlobalStateCalls;
+    u64 endFrameCalls;
+    u64 drawListCalls;
+    u64 createTextureCalls;
+    u64 destroyTextureCalls;
+    u64 readFrameCalls;
+
+    // Frames begun and ended.
+    u64 frameCount;
+    // Objects drawn over every frame.
+    u64 drawCount;
+    // Objects drawn in the latest frame ended.
+    u64 lastFrameDrawCount;
+    // Instanced draws the objects would have been drawn in, over every frame.
+    u64 batchCount;
+    // Instanced draws in the latest frame ended.
+    u64 lastFrameBatchCount;
+    // Bytes which would have been sent to the GPU, in uniforms and per-object data.
+    u64 uniformBytesUploaded;
+    // Bytes of pixels which would have been sent to the GPU in textures.
+    u64 textureBytesUploaded;
+    // Textures created and not yet destroyed.
+    u64 liveTextureCount;
+} null_renderer_stats;
+
+b8 NullRendererBackendInitialize(renderer_backend* backend, const char* applicationName);
+void NullRendererBackendShutdown(renderer_backend* backend);
+void NullRendererBackendOnResize(renderer_backend* backend, u16 width, u16 height);
+b8 NullRendererBackendBeginFrame(renderer_backend* backend, f32 dt);
+void NullRendererUpdateGlobalState(mat4 projection, mat4 view, vec3 viewPosition, vec4 ambientColour, s32 mode);
+b8 NullRendererBackendEndFrame(renderer_backend* backend, f32 dt);
+void NullRendererDrawList(renderer_backend* backend, const render_draw* draws, const u32* order, u32 drawCount);
+void NullRendererCreateTexture(const char* name, b8 autoRelease, s32 width, s32 height, s32 channelCount, const u8* pixels, b8 hasTransparency, texture* outTexture);
+void NullRendererDestroyTexture(texture* texture);
+b8 NullRendererBackendReadFrame(renderer_backend* backend, u32* outWidth, u32* outHeight, u8* outPixels);
+
+/**
+ * Gets what the null backend has been asked to do since it was initialized.
+ *
+ * @param outStats A pointer to hold the stats.
+ */
+TAPI void NullRendererGetStats(null_renderer_stats* outStats);
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "RendererBackEnd.h"
 #include "Vulkan/VulkanBackEnd.h"
+#include "Null/NullBackEnd.h"
 
 b8 RendererBackendCreate(renderer_backend_type type, renderer_backend* outRendererBackend)
 {
@@ -11,9 +12,25 @@ b8 RendererBackendCreate(renderer_backend_type type, renderer_backend* outRender
         outRendererBackend->update_global_state = VulkanRendererUpdateGlobalState;
         outRendererBackend->end_frame = VulkanRendererBackendEndFrame;
         outRendererBackend->resized = VulkanRendererBackendOnResize;
-        outRendererBackend->update_object = VulkanBackendUpdateObject;
+        outRendererBackend->draw_list = VulkanRendererDrawList;
         outRendererBackend->create_texture = VulkanRendererCreateTexture;
         outRendererBackend->destroy_texture = VulkanRendererDestroyTexture;
+        outRendererBackend->read_frame = VulkanRendererBackendReadFrame;
+
+        return true;
+    }
+    else if (type == RENDERER_BACKEND_TYPE_NULL)
+    {
+        outRendererBackend->initialize = NullRendererBackendInitialize;
+        outRendererBackend->shutdown = NullRendererBackendShutdown;
+        outRendererBackend->begin_frame = NullRendererBackendBeginFrame;
+        outRendererBackend->update_global_state = NullRendererUpdateGlobalState;
+        outRendererBackend->end_frame = NullRendererBackendEndFrame;
+        outRendererBackend->resized = NullRendererBackendOnResize;
+        outRendererBackend->draw_list = NullRendererDrawList;
+        outRendererBackend->create_texture = NullRendererCreateTexture;
+        outRendererBackend->destroy_texture = NullRendererDestroyTexture;
+        outRendererBackend->read_frame = NullRendererBackendReadFrame;
 
         return true;
     }
@@ -29,7 +46,24 @@ void RendererBackendDestroy(renderer_backend* rendererBackend)
     rendererBackend->update_global_state = 0;
     rendererBackend->end_frame = 0;
     rendererBackend->resized = 0;
-    rendererBackend->update_object = 0;
+    rendererBackend->draw_list = 0;
     rendererBackend->create_texture = 0;
     rendererBackend->destroy_texture = 0;
+    rendererBackend->read_frame = 0;
+}
+
+u32 RendererBackendBatchLength(const render_draw* draws, const u32* order, u32 drawCount)
+{
+    const render_draw* first = &draws[order[0]];
+    u32 length = 1;
+    while (length < drawCount)
+    {
+        const render_draw* draw = &draws[order[length]];
+        if (draw->geometry != first->geometry || draw->material != first->material || draw->pipeline != first->pipeline)
+        {
+            break;
+        }
+        length++;
+    }
+    return length;
 }
\ No newline at end of file
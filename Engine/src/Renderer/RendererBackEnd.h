@@ -4,4 +4,15 @@
 struct platform_state;
 
 b8 RendererBackendCreate(renderer_backend_type type, renderer_backend* outRendererBackend);
-void RendererBackendDestroy(renderer_backend* rendererBackend);
\ No newline at end of file
+void RendererBackendDestroy(renderer_backend* rendererBackend);
+
+/**
+ * Counts the draws at the start of a list which can be drawn as instances of one draw: those which
+ * follow on from the first with the same pipeline, material and geometry. Sorting groups such
+ * draws together, except where transparent draws have to stay in depth order.
+ * @param draws The draws.
+ * @param order The order sorting the draws by key, from the first draw of the batch.
+ * @param drawCount The number of draws left in the order. Must be at least 1.
+ * @return The number of draws in the batch, at least 1.
+ */
+u32 RendererBackendBatchLength(const render_draw* draws, const u32* order, u32 drawCount);
\ No newline at end of file
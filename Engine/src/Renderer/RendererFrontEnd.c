@@ -1,8 +1,18 @@
+#define LOG_CHANNEL LOG_CHANNEL_RENDERER
+
 #include "RendererFrontEnd.h"
 #include "RendererBackEnd.h"
 #include "Core/Logger.h"
 #include "Core/TMemory.h"
+#include "Core/Profiler.h"
 #include "Math/TMath.h"
+#include "Core/TSort.h"
+#include "Memory/LinearAllocator.h"
+
+// The size of the memory holding everything built up for a frame, reset once it is drawn.
+#define RENDERER_FRAME_MEMORY_SIZE (64 * 1024 * 1024)
+// The number of draws room is made for at the start of each frame, doubled as needed.
+#define RENDERER_INITIAL_DRAW_CAPACITY 1024
 
 typedef struct renderer_system_state {
     renderer_backend backend;
@@ -10,20 +20,62 @@ typedef struct renderer_system_state {
     mat4 view;
     f32 nearClip;
     f32 farClip;
+
+    linear_allocator frameMemory;
+    // The draws submitted for the next frame, in frame memory.
+    render_draw* draws;
+    u32 drawCount;
+    u32 drawCapacity;
 } renderer_system_state;
 
+/*
+Draw sort keys, from the highest bit down:
+    Opaque:      0 | unused:8  | pipeline:7 | material:16 | geometry:16 | depth:16
+    Transparent: 1 | unused:47 | farness:16
+Opaque draws are grouped by state, so the backend only binds what changes, and drawn
+front-to-back within a state so the depth test rejects as much as it can. Transparent
+draws come last, back-to-front so they blend correctly, which has to come before state.
+Their farness shares the opaque depth bits, so only the bits a frame's draws use vary,
+which is all the sort has to look at.
+*/
+#define SORT_KEY_DEPTH_BITS 16
+#define SORT_KEY_GEOMETRY_BITS 16
+#define SORT_KEY_MATERIAL_BITS 16
+#define SORT_KEY_PIPELINE_BITS 7
+#define SORT_KEY_DEPTH_MAX ((1u << SORT_KEY_DEPTH_BITS) - 1)
+#define SORT_KEY_TRANSPARENT (1ULL << 63)
+
 static renderer_system_state* statePtr;
 
-b8 RendererSystemInitialize(u64* memoryRequirement, void* state, const char* applicationName)
+// Allocates from frame memory, keeping every allocation 16-byte aligned for the math types.
+static void* FrameAllocate(u64 size)
+{
+    return LinearAllocatorAllocate(&statePtr->frameMemory, (size + 15) & ~15ULL);
+}
+
+static void ResetFrameMemory()
+{
+    LinearAllocatorReset(&statePtr->frameMemory);
+    statePtr->draws = 0;
+    statePtr->drawCount = 0;
+    statePtr->drawCapacity = 0;
+}
+
+b8 RendererSystemInitialize(u64* memoryRequirement, void* state, const char* applicationName, renderer_backend_type backendType, b8 offscreen)
 {
     *memoryRequirement = sizeof(renderer_system_state);
     if (state == 0) return true;
 
     statePtr = state;
 
-    // TODO: make this configurable.
-    RendererBackendCreate(RENDERER_BACKEND_TYPE_VULKAN, &statePtr->backend);
+    if (!RendererBackendCreate(backendType, &statePtr->backend))
+    {
+        TFATAL("Renderer backend type %d is not supported. Shutting down.", backendType);
+        statePtr = 0;
+        return false;
+    }
     statePtr->backend.frameNumber = 0;
+    statePtr->backend.offscreen = offscreen;
 
     if (!statePtr->backend.initialize(&statePtr->backend, applicationName))
     {
@@ -38,6 +90,9 @@ b8 RendererSystemInitialize(u64* memoryRequirement, void* state, const char* app
     statePtr->view = mat4_translation((vec3){0, 0, 30.0f});
     statePtr->view = mat4_inverse(statePtr->view);
 
+    LinearAllocatorCreate(RENDERER_FRAME_MEMORY_SIZE, 0, &statePtr->frameMemory);
+    ResetFrameMemory();
+
     return true;
 }
 
@@ -46,6 +101,7 @@ void RendererSystemShutdown(void* state)
     if (statePtr)
     {
         statePtr->backend.shutdown(&statePtr->backend);
+        LinearAllocatorDestroy(&statePtr->frameMemory);
     }
 
     statePtr = 0;
@@ -79,34 +135,152 @@ void RendererOnResized(u16 width, u16 height) {
     }
 }
 
+b8 RendererSubmitDraw(u32 geometry, u32 material, b8 transparent, mat4 model)
+{
+    if (!statePtr) return false;
+
+    if (statePtr->drawCount == statePtr->drawCapacity)
+    {
+        // Frame memory is only ever freed all at once, so the old draws are left behind until the frame is drawn.
+        u32 newCapacity = statePtr->drawCapacity ? statePtr->drawCapacity * 2 : RENDERER_INITIAL_DRAW_CAPACITY;
+        render_draw* newDraws = FrameAllocate(sizeof(render_draw) * (u64)newCapacity);
+        if (!newDraws)
+        {
+            TERROR("RendererSubmitDraw - Out of frame memory, with %u draws submitted.", statePtr->drawCount);
+            return false;
+        }
+
+        if (statePtr->drawCount)
+        {
+            TCopyMemory(newDraws, statePtr->draws, sizeof(render_draw) * (u64)statePtr->drawCount);
+        }
+        statePtr->draws = newDraws;
+        statePtr->drawCapacity = newCapacity;
+    }
+
+    render_draw* draw = &statePtr->draws[statePtr->drawCount++];
+    draw->model = model;
+    draw->geometry = geometry;
+    draw->material = material;
+    draw->pipeline = RENDERER_PIPELINE_OBJECT;
+    draw->transparent = transparent;
+    // Keyed once the packet is built, when the frame's view is known.
+    draw->sortKey = 0;
+    return true;
+}
+
+static u64 MakeSortKey(const render_draw* draw, const mat4* view)
+{
+    // The distance in front of the camera, which looks down -z in view space.
+    const f32* v = view->data;
+    const f32* m = draw->model.data;
+    f32 distance = -(m[12] * v[2] + m[13] * v[6] + m[14] * v[10] + v[14]);
+    f32 range = statePtr->farClip - statePtr->nearClip;
+    f32 normalized = TCLAMP((distance - statePtr->nearClip) / range, 0.0f, 1.0f);
+    u64 depth = (u64)(normalized * SORT_KEY_DEPTH_MAX);
+
+    if (draw->transparent)
+    {
+        // Transparent draws at the same distance keep the order they were submitted in.
+        u64 farness = SORT_KEY_DEPTH_MAX - depth;
+        return SORT_KEY_TRANSPARENT | farness;
+    }
+
+    u64 state = (u64)(draw->pipeline & ((1u << SORT_KEY_PIPELINE_BITS) - 1));
+    state = (state << SORT_KEY_MATERIAL_BITS) | (draw->material & ((1u << SORT_KEY_MATERIAL_BITS) - 1));
+    state = (state << SORT_KEY_GEOMETRY_BITS) | (draw->geometry & ((1u << SORT_KEY_GEOMETRY_BITS) - 1));
+    return (state << SORT_KEY_DEPTH_BITS) | depth;
+}
+
+void RendererBuildPacket(f32 dt, render_packet* outPacket)
+{
+    TPROFILE_FUNCTION();
+
+    outPacket->dt = dt;
+    outPacket->draws = 0;
+    outPacket->drawOrder = 0;
+    outPacket->drawCount = 0;
+    if (!statePtr || !statePtr->drawCount) return;
+
+    u32 count = statePtr->drawCount;
+    u32* order = FrameAllocate(sizeof(u32) * (u64)count);
+    u64* keys = FrameAllocate(sizeof(u64) * (u64)count);
+    void* scratch = FrameAllocate(RadixSort64ScratchSize(count));
+    if (!order)
+    {
+        TWARN("RendererBuildPacket - Out of frame memory to order %u draws.", count);
+        return;
+    }
+
+    if (keys && scratch)
+    {
+        for (u32 i = 0; i < count; i++)
+        {
+            statePtr->draws[i].sortKey = MakeSortKey(&statePtr->draws[i], &statePtr->view);
+            keys[i] = statePtr->draws[i].sortKey;
+        }
+
+        // Sort the keys rather than the draws, which are much bigger, and leave the draws where they are.
+        RadixSort64(keys, count, scratch, order);
+    }
+    else
+    {
+        // Better to draw out of order than not at all.
+        TWARN("RendererBuildPacket - Out of frame memory to sort %u draws.", count);
+        for (u32 i = 0; i < count; i++) order[i] = i;
+    }
+
+    outPacket->draws = statePtr->draws;
+    outPacket->drawOrder = order;
+    outPacket->drawCount = count;
+}
+
 b8 RendererDrawFrame(render_packet* packet)
 {
+    TPROFILE_FUNCTION();
+
+    b8 result = true;
+
     // If the begin frame returned successfully, mid-frame operations may continue.
     if (RendererBeginFrame(packet->dt))
     {
         statePtr->backend.update_global_state(statePtr->projection, statePtr->view, vec3_zero(), vec4_one(), 0);
 
-        static f32 angle = 0.01f;
-        angle += 0.1f;
-        quat rotation = quat_from_axis_angle(vec3_forward(), angle, false);
-        mat4 model = quat_to_rotation_matrix(rotation, vec3_zero());
-        statePtr->backend.update_object(model);
+        if (packet->drawCount)
+        {
+            statePtr->backend.draw_list(&statePtr->backend, packet->draws, packet->drawOrder, packet->drawCount);
+        }
 
         // End the frame. If this fails, it is likely unrecoverable.
-        b8 result = RendererEndFrame(packet->dt);
+        result = RendererEndFrame(packet->dt);
 
         if (!result)
         {
             TERROR("RendererEndFrame() failed. Application shutting down...");
-            return false;
         }
     }
 
-    return true;
+    // The frame's draws are done with, even if it was skipped, so the next frame starts afresh.
+    if (statePtr)
+    {
+        ResetFrameMemory();
+    }
+
+    return result;
+}
+
+b8 RendererReadFrame(u32* outWidth, u32* outHeight, u8* outPixels)
+{
+    if (!statePtr) return false;
+
+    return statePtr->backend.read_frame(&statePtr->backend, outWidth, outHeight, outPixels);
 }
 
 void RendererSetView(mat4 view)
 {
+    // Without a renderer, such as when running headless, there is nothing to hand the view to.
+    if (!statePtr) return;
+
     statePtr->view = view;
 }
 
@@ -4,9 +4,30 @@
 struct static_mesh_data;
 struct platform_state;
 
-b8 RendererSystemInitialize(u64* memoryRequirement, void* state, const char* applicationName);
+// With offscreen set, frames are drawn into images owned by the renderer rather than to a window.
+b8 RendererSystemInitialize(u64* memoryRequirement, void* state, const char* applicationName, renderer_backend_type backendType, b8 offscreen);
 void RendererSystemShutdown(void* state);
 void RendererOnResized(u16 width, u16 height);
+
+/**
+ * Submits an object to be drawn in the next frame. Not thread safe; submit from one task at a time.
+ * @param geometry The geometry to draw, such as RENDERER_GEOMETRY_TEST_QUAD.
+ * @param material The material to draw with.
+ * @param transparent Whether the object blends with what is behind it.
+ * @param model The object's model matrix.
+ * @return True on success; false if frame memory has run out.
+ */
+TAPI b8 RendererSubmitDraw(u32 geometry, u32 material, b8 transparent, mat4 model);
+
+/**
+ * Fills in a packet with everything submitted for the next frame, sorted to be drawn. Opaque draws
+ * come first, grouped by state then front-to-back; transparent draws follow, back-to-front.
+ * @param dt The time elapsed since the previous frame, in seconds.
+ * @param outPacket A pointer to the packet to fill in. Valid until the frame is drawn.
+ */
+void RendererBuildPacket(f32 dt, render_packet* outPacket);
+
+// Draws the packet's frame, then frees everything submitted for it.
 b8 RendererDrawFrame(render_packet* packet);
 void RendererCreateTexture(
     const char* name,
@@ -19,5 +40,15 @@ void RendererCreateTexture(
     struct texture* outTexture);
 void RendererDestroyTexture(struct texture* texture);
 
+/**
+ * Copies the latest frame drawn into pixels, as tightly packed 8-bit BGRA rows. Waits for the GPU,
+ * so is meant for checking frames rather than for every frame. Only works when rendering offscreen.
+ * @param outWidth A pointer to hold the frame's width.
+ * @param outHeight A pointer to hold the frame's height.
+ * @param outPixels Width * height * 4 bytes to hold the frame, or 0 to just get its size.
+ * @return True on success; otherwise false.
+ */
+TAPI b8 RendererReadFrame(u32* outWidth, u32* outHeight, u8* outPixels);
+
 // HACK: this should not be exposed outside the engine.
 TAPI void RendererSetView(mat4 view);
\ No newline at end of file
@@ -9,9 +9,13 @@ typedef enum renderer_backend_type
     RENDERER_BACKEND_TYPE_VULKAN,
     RENDERER_BACKEND_TYPE_OPENGL,
     RENDERER_BACKEND_TYPE_DIRECTX,
-    RENDERER_BACKEND_TYPE_METAL
+    RENDERER_BACKEND_TYPE_METAL,
+    // Draws nothing and touches no GPU, only counting what it is asked to do.
+    RENDERER_BACKEND_TYPE_NULL
 } renderer_backend_type;
 
+struct render_draw;
+
 typedef struct global_uniform_object {
     mat4 projection;   // 64 bytes
     mat4 view;         // 64 bytes
@@ -22,13 +26,17 @@ typedef struct global_uniform_object {
 typedef struct renderer_backend
 {
     u64 frameNumber;
+    // Set before initializing. Renders into images owned by the backend rather than to a window,
+    // and presents nothing.
+    b8 offscreen;
     b8 (*initialize)(struct renderer_backend* backend, const char* applicationName);
     void (*shutdown)(struct renderer_backend* backend);
     void (*resized)(struct renderer_backend* backend, u16 width, u16 height);
     b8 (*begin_frame)(struct renderer_backend* backend, f32 dt);
     void (*update_global_state)(mat4 projection, mat4 view, vec3 viewPosition, vec4 ambientColor, s32 mode);
     b8 (*end_frame)(struct renderer_backend* backend, f32 dt);   
-    void (*update_object)(mat4 model);
+    // Draws every draw in the list in one go, in the order given: draws[order[0]] first.
+    void (*draw_list)(struct renderer_backend* backend, const struct render_draw* draws, const u32* order, u32 drawCount);
     void (*create_texture)(
         const char* name, 
         b8 auto_release, 
@@ -39,9 +47,39 @@ typedef struct renderer_backend
         b8 hasTransparency, 
         struct texture* outTexture);
     void (*destroy_texture)(struct texture* texture);
+    // Copies the latest frame drawn offscreen into outPixels as tightly packed 8-bit BGRA rows.
+    // Pass 0 for outPixels to just get the size. Fails when not rendering offscreen.
+    b8 (*read_frame)(struct renderer_backend* backend, u32* outWidth, u32* outHeight, u8* outPixels);
 } renderer_backend;
 
+// The geometry built into the renderer: a quad, until geometry can be loaded.
+#define RENDERER_GEOMETRY_TEST_QUAD 0
+
+// The pipeline objects are drawn with. The only one, for now.
+#define RENDERER_PIPELINE_OBJECT 0
+
+// An object to draw in a frame.
+typedef struct render_draw
+{
+    mat4 model;
+    // Orders the frame's draws. Draws with lower keys are drawn first.
+    u64 sortKey;
+    // The geometry to draw.
+    u32 geometry;
+    // The material to draw with.
+    u32 material;
+    // The pipeline to draw with.
+    u8 pipeline;
+    // Whether the draw blends with what is behind it, so has to be drawn after it.
+    b8 transparent;
+} render_draw;
+
 typedef struct render_packet
 {
     f32 dt;
+    // Everything to draw in the frame, in the order submitted, and the order sorting them by key
+    // gives. Both are in the renderer's frame memory, valid until the frame is drawn.
+    const render_draw* draws;
+    const u32* drawOrder;
+    u32 drawCount;
 } render_packet;
\ No newline at end of file
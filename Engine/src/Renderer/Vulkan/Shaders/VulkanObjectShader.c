@@ -8,6 +8,69 @@
 
 #define BUILTIN_SHADER_NAME_OBJECT "Builtin.ObjectShader"
 
+/*
+Creates the instance and indirect buffers with room for capacity objects in
+each frame's region, and points each frame's instance set at its region.
+*/
+static b8 CreateInstanceBuffers(vulkan_context* context, vulkan_object_shader* shader, u32 capacity)
+{
+    // Written by the CPU every frame, so kept where it can be mapped.
+    if (!VulkanBufferCreate(
+            context,
+            sizeof(mat4) * (u64)capacity * 3,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            true,
+            &shader->instanceBuffer))
+    {
+        return false;
+    }
+
+    // Likewise written every frame.
+    if (context->device.supportsMultiDrawIndirect &&
+        !VulkanBufferCreate(
+            context,
+            sizeof(VkDrawIndexedIndirectCommand) * (u64)capacity * 3,
+            VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            true,
+            &shader->indirectBuffer))
+    {
+        VulkanBufferDestroy(context, &shader->instanceBuffer);
+        return false;
+    }
+
+    for (u32 i = 0; i < context->swapchain.imageCount; i++)
+    {
+        VkDescriptorBufferInfo instanceInfo;
+        instanceInfo.buffer = shader->instanceBuffer.handle;
+        instanceInfo.offset = sizeof(mat4) * (u64)capacity * i;
+        instanceInfo.range = sizeof(mat4) * (u64)capacity;
+
+        VkWriteDescriptorSet instanceWrite = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        instanceWrite.dstSet = shader->instanceDescSets[i];
+        instanceWrite.dstBinding = 0;
+        instanceWrite.dstArrayElement = 0;
+        instanceWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        instanceWrite.descriptorCount = 1;
+        instanceWrite.pBufferInfo = &instanceInfo;
+        vkUpdateDescriptorSets(context->device.logicalDevice, 1, &instanceWrite, 0, 0);
+    }
+
+    shader->instanceCapacity = capacity;
+    return true;
+}
+
+static void DestroyInstanceBuffers(vulkan_context* context, vulkan_object_shader* shader)
+{
+    VulkanBufferDestroy(context, &shader->instanceBuffer);
+    if (context->device.supportsMultiDrawIndirect)
+    {
+        VulkanBufferDestroy(context, &shader->indirectBuffer);
+    }
+    shader->instanceCapacity = 0;
+}
+
 b8 VulkanObjectShaderCreate(vulkan_context* context, vulkan_object_shader* outShader)
 {
     // Shader module init per stage.
@@ -36,15 +99,30 @@ b8 VulkanObjectShaderCreate(vulkan_context* context, vulkan_object_shader* outSh
     globalLayoutInfo.pBindings = &globalUBOLayoutBinding;
     VK_CHECK(vkCreateDescriptorSetLayout(context->device.logicalDevice, &globalLayoutInfo, context->allocator, &outShader->globalDescSetLayout));
 
-    // Global descriptor pool: Used for global items such as view/projection matrix.
-    VkDescriptorPoolSize globalPoolSize;
-    globalPoolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    globalPoolSize.descriptorCount = context->swapchain.imageCount;
+    // Instance Descriptors: the frame's model matrices.
+    VkDescriptorSetLayoutBinding instanceLayoutBinding;
+    instanceLayoutBinding.binding = 0;
+    instanceLayoutBinding.descriptorCount = 1;
+    instanceLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    instanceLayoutBinding.pImmutableSamplers = 0;
+    instanceLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo instanceLayoutInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    instanceLayoutInfo.bindingCount = 1;
+    instanceLayoutInfo.pBindings = &instanceLayoutBinding;
+    VK_CHECK(vkCreateDescriptorSetLayout(context->device.logicalDevice, &instanceLayoutInfo, context->allocator, &outShader->instanceDescSetLayout));
+
+    // Global descriptor pool: Used for global items such as view/projection matrix, and instances.
+    VkDescriptorPoolSize globalPoolSizes[2];
+    globalPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    globalPoolSizes[0].descriptorCount = context->swapchain.imageCount;
+    globalPoolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    globalPoolSizes[1].descriptorCount = context->swapchain.imageCount;
 
     VkDescriptorPoolCreateInfo globalPoolInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
-    globalPoolInfo.poolSizeCount = 1;
-    globalPoolInfo.pPoolSizes = &globalPoolSize;
-    globalPoolInfo.maxSets = context->swapchain.imageCount;
+    globalPoolInfo.poolSizeCount = 2;
+    globalPoolInfo.pPoolSizes = globalPoolSizes;
+    globalPoolInfo.maxSets = context->swapchain.imageCount * 2;
     VK_CHECK(vkCreateDescriptorPool(context->device.logicalDevice, &globalPoolInfo, context->allocator, &outShader->globalDescPool));
 
     // Pipeline creation
@@ -87,10 +165,11 @@ b8 VulkanObjectShaderCreate(vulkan_context* context, vulkan_object_shader* outSh
     }
 
     // Desciptor set layouts.
-    const s32 descSetLayoutCount = 1;
-    VkDescriptorSetLayout layouts[1] =
+    const s32 descSetLayoutCount = 2;
+    VkDescriptorSetLayout layouts[2] =
     {
-        outShader->globalDescSetLayout
+        outShader->globalDescSetLayout,
+        outShader->instanceDescSetLayout
     };
 
     // Stages
@@ -151,6 +230,26 @@ b8 VulkanObjectShaderCreate(vulkan_context* context, vulkan_object_shader* outSh
     allocInfo.pSetLayouts = globalLayouts;
     VK_CHECK(vkAllocateDescriptorSets(context->device.logicalDevice, &allocInfo, outShader->globalDescSets));
 
+    // Allocate instance descriptor sets, pointed at the buffers once they are created.
+    VkDescriptorSetLayout instanceLayouts[3] =
+    {
+        outShader->instanceDescSetLayout,
+        outShader->instanceDescSetLayout,
+        outShader->instanceDescSetLayout
+    };
+
+    VkDescriptorSetAllocateInfo instanceAllocInfo = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    instanceAllocInfo.descriptorPool = outShader->globalDescPool;
+    instanceAllocInfo.descriptorSetCount = context->swapchain.imageCount;
+    instanceAllocInfo.pSetLayouts = instanceLayouts;
+    VK_CHECK(vkAllocateDescriptorSets(context->device.logicalDevice, &instanceAllocInfo, outShader->instanceDescSets));
+
+    if (!CreateInstanceBuffers(context, outShader, OBJECT_SHADER_INITIAL_INSTANCE_CAPACITY))
+    {
+        TERROR("Vulkan instance buffer creation failed for object shader.");
+        return false;
+    }
+
     return true;
 }
 
@@ -158,8 +257,9 @@ void VulkanObjectShaderDestroy(vulkan_context* context, struct vulkan_object_sha
 {
     VkDevice logicalDevice = context->device.logicalDevice;
 
-    // Destroy uniform buffer.
+    // Destroy uniform, instance and indirect buffers.
     VulkanBufferDestroy(context, &shader->globalUniformBuffer);
+    DestroyInstanceBuffers(context, shader);
 
     // Destroy pipeline.
     VulkanPipelineDestroy(context, &shader->pipeline);
@@ -169,6 +269,7 @@ void VulkanObjectShaderDestroy(vulkan_context* context, struct vulkan_object_sha
 
     // Destroy descriptor set layouts.
     vkDestroyDescriptorSetLayout(logicalDevice, shader->globalDescSetLayout, context->allocator);
+    vkDestroyDescriptorSetLayout(logicalDevice, shader->instanceDescSetLayout, context->allocator);
     
     // Destroy shader modules.
     for (u32 i = 0; i < OBJECT_SHADER_STAGE_COUNT; i++)
@@ -217,10 +318,41 @@ void VulkanObjectShaderUpdateGlobalState(vulkan_context* context, struct vulkan_
     vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shader->pipeline.pipelineLayout, 0, 1, &globalDesc, 0, 0);
 }
 
-void VulkanObjectShaderUpdateObject(vulkan_context* context, struct vulkan_object_shader* shader, mat4 model)
+b8 VulkanObjectShaderUpdateInstances(vulkan_context* context, struct vulkan_object_shader* shader, const render_draw* draws, const u32* order, u32 drawCount)
 {
+    if (drawCount > shader->instanceCapacity)
+    {
+        u32 oldCapacity = shader->instanceCapacity;
+        u32 newCapacity = oldCapacity;
+        while (newCapacity < drawCount) newCapacity *= 2;
+        TDEBUG("Growing object instance buffers from %u to %u objects a frame.", oldCapacity, newCapacity);
+
+        // Earlier frames may still be reading the buffers, and their sets are about to be rewritten.
+        vkDeviceWaitIdle(context->device.logicalDevice);
+        DestroyInstanceBuffers(context, shader);
+        if (!CreateInstanceBuffers(context, shader, newCapacity))
+        {
+            TERROR("Failed to grow object instance buffers to %u objects a frame.", newCapacity);
+            if (!CreateInstanceBuffers(context, shader, oldCapacity))
+            {
+                TFATAL("Failed to recreate object instance buffers.");
+            }
+            return false;
+        }
+    }
+
+    // The previous use of this image's region finished before the image was acquired again.
     u32 imageIndex = context->imageIndex;
-    VkCommandBuffer cmdBuffer = context->graphicsCommandBuffers[imageIndex].handle;
+    u64 offset = sizeof(mat4) * (u64)shader->instanceCapacity * imageIndex;
+    mat4* models = VulkanBufferLockMemory(context, &shader->instanceBuffer, offset, sizeof(mat4) * drawCount, 0);
+    for (u32 i = 0; i < drawCount; i++)
+    {
+        models[i] = draws[order[i]].model;
+    }
+    VulkanBufferUnlockMemory(context, &shader->instanceBuffer);
 
-    vkCmdPushConstants(cmdBuffer, shader->pipeline.pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(mat4), &model);
+    // Bound only now the buffers are big enough, as a set can't be rewritten once bound for the frame.
+    VkCommandBuffer cmdBuffer = context->graphicsCommandBuffers[imageIndex].handle;
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, shader->pipeline.pipelineLayout, 1, 1, &shader->instanceDescSets[imageIndex], 0, 0);
+    return true;
 }
\ No newline at end of file
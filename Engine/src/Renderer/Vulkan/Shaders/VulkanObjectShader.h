@@ -6,4 +6,10 @@ b8 VulkanObjectShaderCreate(vulkan_context* context, vulkan_object_shader* outSh
 void VulkanObjectShaderDestroy(vulkan_context* context, struct vulkan_object_shader* shader);
 void VulkanObjectShaderUse(vulkan_context* context, struct vulkan_object_shader* shader);
 void VulkanObjectShaderUpdateGlobalState(vulkan_context* context, struct vulkan_object_shader* shader);
-void VulkanObjectShaderUpdateObject(vulkan_context* context, struct vulkan_object_shader* shader, mat4 model);
\ No newline at end of file
+
+/**
+ * Writes the model matrix of each draw into the frame's instances, where instance i is draws[order[i]],
+ * and binds them. The instance and indirect buffers are grown first if they have too little room.
+ * @return True on success; false if the buffers could not grow to fit every draw.
+ */
+b8 VulkanObjectShaderUpdateInstances(vulkan_context* context, struct vulkan_object_shader* shader, const render_draw* draws, const u32* order, u32 drawCount);
\ No newline at end of file
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_VULKAN
+
 #include "VulkanBackEnd.h"
 #include "VulkanTypes.inl"
 #include "VulkanPlatform.h"
@@ -13,6 +15,7 @@
 #include "Shaders/VulkanObjectShader.h"
 #include "Core/Logger.h"
 #include "Core/TMemory.h"
+#include "Core/Profiler.h"
 #include "Core/TString.h"
 #include "Core/Application.h"
 #include "Containers/DArray.h"
@@ -58,6 +61,7 @@ b8 VulkanRendererBackendInitialize(renderer_backend* backend, const char* applic
 {
     // Function pointers
     context.FindMemoryIndex = FindMemoryIndex;
+    context.offscreen = backend->offscreen;
     
     // TODO: custom allocator.
     context.allocator = 0;
@@ -81,15 +85,18 @@ b8 VulkanRendererBackendInitialize(renderer_backend* backend, const char* applic
 
     // Obtain a list of required extensions
     const char** requiredExtensions = DArrayCreate(const char*);
-    DArrayPush(requiredExtensions, &VK_KHR_SURFACE_EXTENSION_NAME);  // Generic surface extension
-    PlatformGetRequiredExtensionNames(&requiredExtensions); // Platform-specific extension(s)
+    if (!context.offscreen)
+    {
+        DArrayPush(requiredExtensions, &VK_KHR_SURFACE_EXTENSION_NAME);  // Generic surface extension
+        PlatformGetRequiredExtensionNames(&requiredExtensions); // Platform-specific extension(s)
+    }
 #if defined(_DEBUG)
     DArrayPush(requiredExtensions, &VK_EXT_DEBUG_UTILS_EXTENSION_NAME);  // debug utilities
 
     TDEBUG("Required extensions:");
     u32 length = DArrayLength(requiredExtensions);
     for (u32 i = 0; i < length; i++)
-        TDEBUG(requiredExtensions[i]);
+        TDEBUG("%s", requiredExtensions[i]);
 #endif // _DEBUG
 
     createInfo.enabledExtensionCount = DArrayLength(requiredExtensions);
@@ -148,10 +155,14 @@ b8 VulkanRendererBackendInitialize(renderer_backend* backend, const char* applic
     // Debugger
 #if defined(_DEBUG)
     TDEBUG("Creating Vulkan debugger...");
+    // Only what the Vulkan log channel would show is requested, since the layers spend time
+    // building every message. VKDebugCallback logs info as debug and verbose as trace, so
+    // raise the channel's level before the renderer starts to see them.
     u32 logSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT |
-                       VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT; //|
-                       //VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;  //|
-                                                                      //    VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
+                      VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+    log_level vulkanLevel = LogGetChannelLevel(LOG_CHANNEL_VULKAN);
+    if (vulkanLevel >= LOG_LEVEL_DEBUG) logSeverity |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+    if (vulkanLevel >= LOG_LEVEL_TRACE) logSeverity |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
 
     VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo = {VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT};
     debugCreateInfo.messageSeverity = logSeverity;
@@ -165,14 +176,21 @@ b8 VulkanRendererBackendInitialize(renderer_backend* backend, const char* applic
     TDEBUG("Vulkan debugger created.");
 #endif // _DEBUG
 
-    // Surface
-    TDEBUG("Creating Vulkan surface...");
-    if (!PlatformCreateVulkanSurface(&context))
+    // Surface, unless rendering offscreen, where there is no window to present to.
+    if (context.offscreen)
     {
-        TERROR("Failed to create platform surface!");
-        return false;
+        TINFO("Rendering offscreen, so no surface is created.");
+    }
+    else
+    {
+        TDEBUG("Creating Vulkan surface...");
+        if (!PlatformCreateVulkanSurface(&context))
+        {
+            TERROR("Failed to create platform surface!");
+            return false;
+        }
+        TDEBUG("Vulkan surface created.");
     }
-    TDEBUG("Vulkan surface created.");
 
     // Device creation
     if (!VulkanDeviceCreate(&context))
@@ -262,6 +280,8 @@ b8 VulkanRendererBackendInitialize(renderer_backend* backend, const char* applic
 
     UploadDataRange(&context, context.device.graphicsCommandPool, 0, context.device.graphicsQueue, &context.objectVertexBuffer, 0, sizeof(vertex_3d) * vertCount, verts);
     UploadDataRange(&context, context.device.graphicsCommandPool, 0, context.device.graphicsQueue, &context.objectIndexBuffer, 0, sizeof(u32) * indexCount, indices);
+    context.geometries[RENDERER_GEOMETRY_TEST_QUAD] = (vulkan_geometry){0, indexCount, 0};
+    context.geometryCount = 1;
     // TODO: end temp code
     
     TINFO("Vulkan renderer initialized successfully.");
@@ -375,6 +395,8 @@ void VulkanRendererBackendOnResize(renderer_backend* backend, u16 width, u16 hei
 
 b8 VulkanRendererBackendBeginFrame(renderer_backend* backend, f32 dt)
 {
+    TPROFILE_FUNCTION();
+
     vulkan_device* device = &context.device;
 
     // Check if recreating swap chain and boot out.
@@ -485,6 +507,8 @@ void VulkanRendererUpdateGlobalState(mat4 projection, mat4 view, vec3 view_posit
 
 b8 VulkanRendererBackendEndFrame(renderer_backend* backend, f32 dt)
 {
+    TPROFILE_FUNCTION();
+
     vulkan_command_buffer* cmdBuffer = &context.graphicsCommandBuffers[context.imageIndex];
 
     // End renderpass
@@ -523,6 +547,14 @@ b8 VulkanRendererBackendEndFrame(renderer_backend* backend, f32 dt)
     submitInfo.waitSemaphoreCount = 1;
     submitInfo.pWaitSemaphores = &context.imageAvailableSemaphores[context.currentFrame];
 
+    // Offscreen images are always available and never presented, so nothing would signal
+    // or wait on the semaphores. The in-flight fences alone keep frames apart.
+    if (context.offscreen)
+    {
+        submitInfo.signalSemaphoreCount = 0;
+        submitInfo.waitSemaphoreCount = 0;
+    }
+
     // Each semaphore waits on the corresponding pipeline stage to complete. 1:1 ratio.
     // VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT prevents subsequent colour attachment
     // writes from executing until the semaphore signals (i.e. one frame is presented at a time)
@@ -555,15 +587,118 @@ b8 VulkanRendererBackendEndFrame(renderer_backend* backend, f32 dt)
     return true;
 }
 
-void VulkanBackendUpdateObject(mat4 model)
+// Marks state as not yet bound while drawing a list; no pipeline or material has this id.
+#define NOTHING_BOUND 0xFFFFFFFFU
+
+// Draws each batch with its own call. Returns the number of draws skipped.
+static u32 DrawBatchesDirect(vulkan_command_buffer* cmdBuffer, const render_draw* draws, const u32* order, u32 drawCount)
 {
-    vulkan_command_buffer* cmdBuffer = &context.graphicsCommandBuffers[context.imageIndex];
-    
-    VulkanObjectShaderUpdateObject(&context, &context.objectShader, model);
+    // The draws are sorted by state, so state is only bound when it differs from the draw before.
+    // Materials have no GPU state yet, as the object shader draws them all alike, so only the
+    // pipeline is bound. Batches still end where the material changes.
+    u32 boundPipeline = NOTHING_BOUND;
+    u32 skipped = 0;
+    for (u32 i = 0; i < drawCount;)
+    {
+        // Runs of draws of the same thing are drawn as instances of one draw.
+        const render_draw* draw = &draws[order[i]];
+        u32 instanceCount = RendererBackendBatchLength(draws, &order[i], drawCount - i);
+        u32 firstInstance = i;
+        i += instanceCount;
 
-    // TODO: temporary test code
-    VulkanObjectShaderUse(&context, &context.objectShader);
+        if (draw->geometry >= context.geometryCount)
+        {
+            skipped += instanceCount;
+            continue;
+        }
+
+        if (draw->pipeline != boundPipeline)
+        {
+            // Every pipeline is the object shader's, for now.
+            VulkanObjectShaderUse(&context, &context.objectShader);
+            boundPipeline = draw->pipeline;
+        }
+
+        const vulkan_geometry* geometry = &context.geometries[draw->geometry];
+        vkCmdDrawIndexed(cmdBuffer->handle, geometry->indexCount, instanceCount, geometry->firstIndex, geometry->vertexOffset, firstInstance);
+    }
+
+    return skipped;
+}
+
+// Writes each batch's draw into the frame's indirect buffer, then draws every batch of a pipeline and material
+// with one indirect draw. Returns the number of draws skipped.
+static u32 DrawBatchesIndirect(vulkan_command_buffer* cmdBuffer, const render_draw* draws, const u32* order, u32 drawCount)
+{
+    vulkan_buffer* indirectBuffer = &context.objectShader.indirectBuffer;
+    const u32 stride = sizeof(VkDrawIndexedIndirectCommand);
+    // As with instances, the previous use of this image's region finished before the image was acquired again.
+    u64 regionOffset = (u64)stride * context.objectShader.instanceCapacity * context.imageIndex;
+    VkDrawIndexedIndirectCommand* commands = VulkanBufferLockMemory(&context, indirectBuffer, regionOffset, (u64)stride * drawCount, 0);
+    u32 maxRunLength = context.device.properties.limits.maxDrawIndirectCount;
+
+    u32 commandCount = 0;
+    u32 runStart = 0;
+    u32 runPipeline = NOTHING_BOUND;
+    u32 runMaterial = NOTHING_BOUND;
+    u32 skipped = 0;
+    for (u32 i = 0; i < drawCount;)
+    {
+        const render_draw* draw = &draws[order[i]];
+        u32 instanceCount = RendererBackendBatchLength(draws, &order[i], drawCount - i);
+        u32 firstInstance = i;
+        i += instanceCount;
+
+        if (draw->geometry >= context.geometryCount)
+        {
+            skipped += instanceCount;
+            continue;
+        }
+
+        // A run ends where the pipeline or material changes, so one indirect draw never spans
+        // state, or at the most draws one indirect draw can make.
+        if (draw->pipeline != runPipeline || draw->material != runMaterial || commandCount - runStart == maxRunLength)
+        {
+            if (commandCount > runStart)
+            {
+                vkCmdDrawIndexedIndirect(cmdBuffer->handle, indirectBuffer->handle, regionOffset + (u64)stride * runStart, commandCount - runStart, stride);
+            }
+            if (draw->pipeline != runPipeline)
+            {
+                // Every pipeline is the object shader's, for now.
+                VulkanObjectShaderUse(&context, &context.objectShader);
+                runPipeline = draw->pipeline;
+            }
+            runMaterial = draw->material;
+            runStart = commandCount;
+        }
+
+        const vulkan_geometry* geometry = &context.geometries[draw->geometry];
+        VkDrawIndexedIndirectCommand* command = &commands[commandCount++];
+        command->indexCount = geometry->indexCount;
+        command->instanceCount = instanceCount;
+        command->firstIndex = geometry->firstIndex;
+        command->vertexOffset = geometry->vertexOffset;
+        command->firstInstance = firstInstance;
+    }
+
+    if (commandCount > runStart)
+    {
+        vkCmdDrawIndexedIndirect(cmdBuffer->handle, indirectBuffer->handle, regionOffset + (u64)stride * runStart, commandCount - runStart, stride);
+    }
 
+    // The commands are only read once the command buffer is run, after this.
+    VulkanBufferUnlockMemory(&context, indirectBuffer);
+    return skipped;
+}
+
+void VulkanRendererDrawList(renderer_backend* backend, const render_draw* draws, const u32* order, u32 drawCount)
+{
+    TPROFILE_FUNCTION();
+
+    vulkan_command_buffer* cmdBuffer = &context.graphicsCommandBuffers[context.imageIndex];
+
+    // Every draw shares the geometry buffers, so they are bound once for the list.
     // Bind vertex buffer at offset.
     VkDeviceSize offsets[1] = {0};
     vkCmdBindVertexBuffers(cmdBuffer->handle, 0, 1, &context.objectVertexBuffer.handle, (VkDeviceSize*)offsets);
@@ -571,9 +706,27 @@ void VulkanBackendUpdateObject(mat4 model)
     // Bind index buffer at offset.
     vkCmdBindIndexBuffer(cmdBuffer->handle, context.objectIndexBuffer.handle, 0, VK_INDEX_TYPE_UINT32);
 
-    // Issue the draw.
-    vkCmdDrawIndexed(cmdBuffer->handle, 6, 1, 0, 0, 0);
-    // TODO: end temporary test code
+    // Every model goes up at once, draws[order[i]]'s as instance i.
+    if (!VulkanObjectShaderUpdateInstances(&context, &context.objectShader, draws, order, drawCount))
+    {
+        TERROR("Could not make room for %u objects; none were drawn this frame.", drawCount);
+        return;
+    }
+
+    u32 skipped = 0;
+    if (context.device.supportsMultiDrawIndirect)
+    {
+        skipped = DrawBatchesIndirect(cmdBuffer, draws, order, drawCount);
+    }
+    else
+    {
+        skipped = DrawBatchesDirect(cmdBuffer, draws, order, drawCount);
+    }
+
+    if (skipped)
+    {
+        TWARN("Skipped %u draws of geometry which does not exist.", skipped);
+    }
 }
 
 VKAPI_ATTR VkBool32 VKAPI_CALL VKDebugCallback(
@@ -584,16 +737,16 @@ VKAPI_ATTR VkBool32 VKAPI_CALL VKDebugCallback(
     switch (messageSeverity) {
         default:
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-            TERROR(callbackData->pMessage);
+            TERROR("%s", callbackData->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-            TWARN(callbackData->pMessage);
+            TWARN("%s", callbackData->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-            TINFO(callbackData->pMessage);
+            TDEBUG("%s", callbackData->pMessage);
             break;
         case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-            TTRACE(callbackData->pMessage);
+            TTRACE("%s", callbackData->pMessage);
             break;
     }
     return VK_FALSE;
@@ -696,10 +849,13 @@ b8 RecreateSwapchain(renderer_backend* backend) {
     }
 
     // Requery support
-    VulkanDeviceQuerySwapchainSupport(
-        context.device.physicalDevice,
-        context.surface,
-        &context.device.swapchainSupport);
+    if (!context.offscreen)
+    {
+        VulkanDeviceQuerySwapchainSupport(
+            context.device.physicalDevice,
+            context.surface,
+            &context.device.swapchainSupport);
+    }
     VulkanDeviceDetectDepthFormat(&context.device);
 
     VulkanSwapchainRecreate(
@@ -889,4 +1045,77 @@ void VulkanRendererDestroyTexture(texture* texture)
 
     TFree(texture->internalData, sizeof(vulkan_texture_data), MEMORY_TAG_TEXTURE);
     TZeroMemory(texture, sizeof(struct texture));
+}
+
+b8 VulkanRendererBackendReadFrame(renderer_backend* backend, u32* outWidth, u32* outHeight, u8* outPixels)
+{
+    if (!context.offscreen)
+    {
+        TWARN("Frames can only be read back when rendering offscreen.");
+        return false;
+    }
+
+    s32 imageIndex = context.swapchain.lastOffscreenImage;
+    if (imageIndex < 0)
+    {
+        TWARN("No frame has been drawn to read back yet.");
+        return false;
+    }
+
+    vulkan_image* image = &context.swapchain.offscreenImages[imageIndex];
+    *outWidth = image->width;
+    *outHeight = image->height;
+    if (!outPixels) return true;
+
+    // Copied through a host-visible buffer. This waits on the GPU, so is for checking frames,
+    // not for doing every frame.
+    u64 size = (u64)image->width * image->height * 4;
+    vulkan_buffer staging;
+    VkMemoryPropertyFlags memPropFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    if (!VulkanBufferCreate(&context, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, memPropFlags, true, &staging))
+    {
+        TERROR("Error creating buffer to read frame back into.");
+        return false;
+    }
+
+    vulkan_command_buffer tempBuffer;
+    VkCommandPool pool = context.device.graphicsCommandPool;
+    VkQueue queue = context.device.graphicsQueue;
+    VulkanCommandBufferAllocateAndBeginSingleUse(&context, pool, &tempBuffer);
+
+    // The render pass leaves the image ready to copy from, but its writes must finish first.
+    VkImageMemoryBarrier barrier = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image->handle;
+    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    barrier.subresourceRange.levelCount = 1;
+    barrier.subresourceRange.layerCount = 1;
+    barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vkCmdPipelineBarrier(
+        tempBuffer.handle,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, 0, 0, 0, 1, &barrier);
+
+    VkBufferImageCopy region;
+    TZeroMemory(&region, sizeof(VkBufferImageCopy));
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.layerCount = 1;
+    region.imageExtent.width = image->width;
+    region.imageExtent.height = image->height;
+    region.imageExtent.depth = 1;
+    vkCmdCopyImageToBuffer(tempBuffer.handle, image->handle, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging.handle, 1, &region);
+
+    VulkanCommandBufferEndSingleUse(&context, pool, &tempBuffer, queue);
+
+    void* data = VulkanBufferLockMemory(&context, &staging, 0, size, 0);
+    TCopyMemory(outPixels, data, size);
+    VulkanBufferUnlockMemory(&context, &staging);
+    VulkanBufferDestroy(&context, &staging);
+
+    return true;
 }
\ No newline at end of file
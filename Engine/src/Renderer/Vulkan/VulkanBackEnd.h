@@ -8,6 +8,7 @@ void VulkanRendererBackendOnResize(renderer_backend* backend, u16 width, u16 hei
 b8 VulkanRendererBackendBeginFrame(renderer_backend* backend, f32 dt);
 void VulkanRendererUpdateGlobalState(mat4 projection, mat4 view, vec3 view_position, vec4 ambient_colour, s32 mode);
 b8 VulkanRendererBackendEndFrame(renderer_backend* backend, f32 dt);
-void VulkanBackendUpdateObject(mat4 model);
+void VulkanRendererDrawList(renderer_backend* backend, const render_draw* draws, const u32* order, u32 drawCount);
 void VulkanRendererCreateTexture(const char* name, b8 auto_release, s32 width, s32 height, s32 channelCount, const u8* pixels, b8 hasTransparency, texture* outTexture);
-void VulkanRendererDestroyTexture(texture* texture);
\ No newline at end of file
+void VulkanRendererDestroyTexture(texture* texture);
+b8 VulkanRendererBackendReadFrame(renderer_backend* backend, u32* outWidth, u32* outHeight, u8* outPixels);
\ No newline at end of file
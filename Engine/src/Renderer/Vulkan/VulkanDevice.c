@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_VULKAN
+
 #include "VulkanDevice.h"
 #include "Core/Logger.h"
 #include "Core/TString.h"
@@ -93,11 +95,24 @@ b8 VulkanDeviceCreate(vulkan_context* context)
     VkPhysicalDeviceFeatures deviceFeatures = {};
     deviceFeatures.samplerAnisotropy = VK_TRUE;  // Request anistrophy
 
+    // Drawing many batches per indirect draw needs both, as each batch starts at its own instance.
+    context->device.supportsMultiDrawIndirect = context->device.features.multiDrawIndirect && context->device.features.drawIndirectFirstInstance;
+    if (context->device.supportsMultiDrawIndirect)
+    {
+        deviceFeatures.multiDrawIndirect = VK_TRUE;
+        deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+    }
+    else
+    {
+        TINFO("Multi-draw indirect is not supported. Batches will be drawn one call at a time.");
+    }
+
     VkDeviceCreateInfo deviceCreateInfo = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
     deviceCreateInfo.queueCreateInfoCount = indexCount;
     deviceCreateInfo.pQueueCreateInfos = queueCreateInfos;
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.enabledExtensionCount = 1;
+    // Nothing is presented when rendering offscreen, so there is no need for swapchains.
+    deviceCreateInfo.enabledExtensionCount = context->offscreen ? 0 : 1;
     const char* extensionNames = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
     deviceCreateInfo.ppEnabledExtensionNames = &extensionNames;
 
@@ -321,14 +336,18 @@ b8 SelectPhysicalDevice(vulkan_context* context)
         // configuration.
         vulkan_physical_device_requirements requirements = {};
         requirements.graphics = true;
-        requirements.present = true;
+        requirements.present = !context->offscreen;
         requirements.transfer = true;
         // NOTE: Enable this if compute will be required.
         // requirements.compute = true;
         requirements.samplerAnisotropy = true;
-        requirements.discreteGPU = true;
+        // Offscreen rendering is for machines without a display, which may only have a software driver.
+        requirements.discreteGPU = !context->offscreen;
         requirements.deviceExtensionNames = DArrayCreate(const char*);
-        DArrayPush(requirements.deviceExtensionNames, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        if (!context->offscreen)
+        {
+            DArrayPush(requirements.deviceExtensionNames, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        }
 
         vulkan_physical_device_queue_family_info queueInfo = {};
         b8 result = PhysicalDeviceMeetsRequirements(
@@ -390,7 +409,8 @@ b8 SelectPhysicalDevice(vulkan_context* context)
 
             context->device.physicalDevice = physicalDevices[i];
             context->device.graphicsQueueIndex = queueInfo.graphicsFamilyIndex;
-            context->device.presentQueueIndex = queueInfo.presentFamilyIndex;
+            // With nothing presented offscreen, the graphics queue stands in for the present queue.
+            context->device.presentQueueIndex = context->offscreen ? queueInfo.graphicsFamilyIndex : queueInfo.presentFamilyIndex;
             context->device.transferQueueIndex = queueInfo.transferFamilyIndex;
             // NOTE: set compute index here if needed.
 
@@ -477,12 +497,15 @@ b8 PhysicalDeviceMeetsRequirements(
             }
         }
 
-        // Present queue?
-        VkBool32 supportsPresent = VK_FALSE;
-        VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &supportsPresent));
-        if (supportsPresent)
+        // Present queue? Only asked when there is a surface to present to.
+        if (surface)
         {
-            outQueueInfo->presentFamilyIndex = i;
+            VkBool32 supportsPresent = VK_FALSE;
+            VK_CHECK(vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &supportsPresent));
+            if (supportsPresent)
+            {
+                outQueueInfo->presentFamilyIndex = i;
+            }
         }
     }
 
@@ -505,13 +528,16 @@ b8 PhysicalDeviceMeetsRequirements(
         TTRACE("Transfer Family Index: %i", outQueueInfo->transferFamilyIndex);
         TTRACE("Compute Family Index:  %i", outQueueInfo->computeFamilyIndex);
 
-        // Query swapchain support.
-        VulkanDeviceQuerySwapchainSupport(
-            device,
-            surface,
-            outSwapChainSupport);
+        // Query swapchain support, if anything is to be presented.
+        if (requirements->present)
+        {
+            VulkanDeviceQuerySwapchainSupport(
+                device,
+                surface,
+                outSwapChainSupport);
+        }
 
-        if (outSwapChainSupport->formatCount < 1 || outSwapChainSupport->presentModeCount < 1)
+        if (requirements->present && (outSwapChainSupport->formatCount < 1 || outSwapChainSupport->presentModeCount < 1))
         {
             if (outSwapChainSupport->formats)
             {
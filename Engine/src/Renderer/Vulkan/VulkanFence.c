@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_VULKAN
+
 #include "VulkanFence.h"
 #include "Core/Logger.h"
 
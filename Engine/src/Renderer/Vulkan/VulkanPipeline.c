@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_VULKAN
+
 #include "VulkanPipeline.h"
 #include "VulkanUtils.h"
 #include "Core/TMemory.h"
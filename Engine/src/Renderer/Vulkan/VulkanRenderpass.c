@@ -40,6 +40,11 @@ void VulkanRenderpassCreate(
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;      // Do not expect any particular layout before render pass starts.
     colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;  // Transitioned to after the render pass
+    if (context->offscreen)
+    {
+        // Nothing is presented, but frames may be copied out to be read back.
+        colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    }
     colorAttachment.flags = 0;
 
     attachmentDescriptions[0] = colorAttachment;
@@ -1,11 +1,18 @@
+#define LOG_CHANNEL LOG_CHANNEL_VULKAN
+
 #include "VulkanSwapchain.h"
 #include "Core/Logger.h"
 #include "Core/TMemory.h"
 #include "VulkanDevice.h"
 #include "VulkanImage.h"
 
+// The number of images rendered into when offscreen, one more than the frames in flight.
+#define OFFSCREEN_IMAGE_COUNT 3
+
 void Create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* swapchain);
 void Destroy(vulkan_context* context, vulkan_swapchain* swapchain);
+void CreateOffscreen(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* swapchain);
+void DestroyOffscreen(vulkan_context* context, vulkan_swapchain* swapchain);
 
 void VulkanSwapchainCreate(
     vulkan_context* context,
@@ -34,6 +41,14 @@ void VulkanSwapchainDestroy(
 {
     vkDeviceWaitIdle(context->device.logicalDevice);
     Destroy(context, swapchain);
+
+    if (swapchain->offscreenImages)
+    {
+        TFree(swapchain->offscreenImages, sizeof(vulkan_image) * swapchain->imageCount, MEMORY_TAG_RENDERER);
+        TFree(swapchain->views, sizeof(VkImageView) * swapchain->imageCount, MEMORY_TAG_RENDERER);
+        swapchain->offscreenImages = 0;
+        swapchain->views = 0;
+    }
 }
 
 b8 VulkanSwapchainAcquireNextImageIndex(
@@ -44,6 +59,13 @@ b8 VulkanSwapchainAcquireNextImageIndex(
     VkFence fence,
     u32* outImageIndex)
 {
+    if (context->offscreen)
+    {
+        // Images are simply taken in turn. The in-flight fences keep one from being reused too soon.
+        *outImageIndex = (u32)(swapchain->lastOffscreenImage + 1) % swapchain->imageCount;
+        return true;
+    }
+
     VkResult result = vkAcquireNextImageKHR(
         context->device.logicalDevice,
         swapchain->handle,
@@ -75,6 +97,14 @@ void VulkanSwapchainPresent(
     VkSemaphore renderCompleteSemaphore,
     u32 presentImageIndex)
 {
+    if (context->offscreen)
+    {
+        // Nothing to present to. Just note where the frame went, so it can be read back.
+        swapchain->lastOffscreenImage = (s32)presentImageIndex;
+        context->currentFrame = (context->currentFrame + 1) % swapchain->maxFramesInFlight;
+        return;
+    }
+
     // Return the image to the swapchain for presentation.
     VkPresentInfoKHR present_info = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
     present_info.waitSemaphoreCount = 1;
@@ -101,6 +131,12 @@ void VulkanSwapchainPresent(
 
 void Create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* swapchain)
 {
+    if (context->offscreen)
+    {
+        CreateOffscreen(context, width, height, swapchain);
+        return;
+    }
+
     VkExtent2D swapchain_extent = {width, height};
 
     // Choose a swap surface format.
@@ -254,6 +290,12 @@ void Create(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* sw
 
 void Destroy(vulkan_context* context, vulkan_swapchain* swapchain)
 {
+    if (context->offscreen)
+    {
+        DestroyOffscreen(context, swapchain);
+        return;
+    }
+
     VulkanImageDestroy(context, &swapchain->depthAttachment);
 
     // Only destroy the views, not the images, since those are owned by the swapchain and are thus
@@ -264,4 +306,77 @@ void Destroy(vulkan_context* context, vulkan_swapchain* swapchain)
     }
 
     vkDestroySwapchainKHR(context->device.logicalDevice, swapchain->handle, context->allocator);
+}
+
+void CreateOffscreen(vulkan_context* context, u32 width, u32 height, vulkan_swapchain* swapchain)
+{
+    // The same format a swapchain would prefer, so frames match whether presented or not.
+    swapchain->imageFormat.format = VK_FORMAT_B8G8R8A8_UNORM;
+    swapchain->imageFormat.colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    swapchain->imageCount = OFFSCREEN_IMAGE_COUNT;
+    swapchain->maxFramesInFlight = OFFSCREEN_IMAGE_COUNT - 1;
+    swapchain->lastOffscreenImage = -1;
+    context->currentFrame = 0;
+
+    if (!swapchain->offscreenImages)
+    {
+        swapchain->offscreenImages = (vulkan_image*)TAllocate(sizeof(vulkan_image) * swapchain->imageCount, MEMORY_TAG_RENDERER);
+    }
+    if (!swapchain->views)
+    {
+        swapchain->views = (VkImageView*)TAllocate(sizeof(VkImageView) * swapchain->imageCount, MEMORY_TAG_RENDERER);
+    }
+
+    // Colour images, which can also be copied from, for reading frames back.
+    for (u32 i = 0; i < swapchain->imageCount; i++)
+    {
+        VulkanImageCreate(
+            context,
+            VK_IMAGE_TYPE_2D,
+            width,
+            height,
+            swapchain->imageFormat.format,
+            VK_IMAGE_TILING_OPTIMAL,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            true,
+            VK_IMAGE_ASPECT_COLOR_BIT,
+            &swapchain->offscreenImages[i]);
+        swapchain->views[i] = swapchain->offscreenImages[i].view;
+    }
+
+    // Depth resources
+    if (!VulkanDeviceDetectDepthFormat(&context->device))
+    {
+        context->device.depthFormat = VK_FORMAT_UNDEFINED;
+        TFATAL("Failed to find a supported format!");
+    }
+
+    VulkanImageCreate(
+        context,
+        VK_IMAGE_TYPE_2D,
+        width,
+        height,
+        context->device.depthFormat,
+        VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        true,
+        VK_IMAGE_ASPECT_DEPTH_BIT,
+        &swapchain->depthAttachment);
+
+    TINFO("Offscreen render targets created: %u images of %ux%u.", swapchain->imageCount, width, height);
+}
+
+void DestroyOffscreen(vulkan_context* context, vulkan_swapchain* swapchain)
+{
+    VulkanImageDestroy(context, &swapchain->depthAttachment);
+
+    // Unlike a swapchain's, these images are owned here, so are destroyed along with their views.
+    for (u32 i = 0; i < swapchain->imageCount; i++)
+    {
+        VulkanImageDestroy(context, &swapchain->offscreenImages[i]);
+        swapchain->views[i] = 0;
+    }
+    swapchain->lastOffscreenImage = -1;
 }
\ No newline at end of file
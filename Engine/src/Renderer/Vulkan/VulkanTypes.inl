@@ -48,6 +48,8 @@ typedef struct vulkan_device
     VkPhysicalDeviceMemoryProperties memory;
     VkFormat depthFormat;
     b8 supportsDeviceLocalHostVisible;
+    // Whether many draws, each with its own first instance, can be made with one indirect draw.
+    b8 supportsMultiDrawIndirect;
 } vulkan_device;
 
 typedef struct vulkan_image
@@ -97,6 +99,10 @@ typedef struct vulkan_swapchain
     VkImageView* views;
     vulkan_image depthAttachment;
     vulkan_framebuffer* framebuffers; // framebuffers used for on-screen rendering.
+    // When rendering offscreen, the colour images owned in place of the swapchain's. views points into these.
+    vulkan_image* offscreenImages;
+    // When rendering offscreen, the image the latest frame was drawn to, or -1 before the first frame.
+    s32 lastOffscreenImage;
 } vulkan_swapchain;
 
 typedef enum vulkan_command_buffer_state
@@ -135,6 +141,8 @@ typedef struct vulkan_pipeline
 } vulkan_pipeline;
 
 #define OBJECT_SHADER_STAGE_COUNT 2
+// The objects room is made for in each frame to start with, doubled as needed.
+#define OBJECT_SHADER_INITIAL_INSTANCE_CAPACITY 65536
 typedef struct vulkan_object_shader
 {
     vulkan_shader_stage stages[OBJECT_SHADER_STAGE_COUNT]; // vertex, fragment
@@ -143,9 +151,30 @@ typedef struct vulkan_object_shader
     VkDescriptorSet globalDescSets[3]; // One descriptor set per frame - max 3 for triple-buffering.
     global_uniform_object globalUBO; // Global uniform object.
     vulkan_buffer globalUniformBuffer; // Global uniform buffer.
+    // Points the shader at a frame's region of the instance buffer. A set of its own, so it can be
+    // rewritten when the buffer grows without touching the global set, which is already bound by then.
+    VkDescriptorSetLayout instanceDescSetLayout;
+    VkDescriptorSet instanceDescSets[3];
+    // The model matrix of each object drawn, in a region for each frame.
+    vulkan_buffer instanceBuffer;
+    // The indirect draw of each batch drawn, in a region for each frame. At most one per instance.
+    vulkan_buffer indirectBuffer;
+    // The number of objects each frame's regions have room for.
+    u32 instanceCapacity;
     vulkan_pipeline pipeline;
 } vulkan_object_shader;
 
+// Where a piece of geometry lives in the shared vertex and index buffers.
+typedef struct vulkan_geometry
+{
+    u32 firstIndex;
+    u32 indexCount;
+    s32 vertexOffset;
+} vulkan_geometry;
+
+// The most pieces of geometry which can be uploaded.
+#define VULKAN_MAX_GEOMETRY_COUNT 256
+
 typedef struct vulkan_context
 {
     u32 framebufferWidth; // The framebuffer's current width.
@@ -159,6 +188,9 @@ typedef struct vulkan_context
     VkInstance instance;
     VkAllocationCallbacks* allocator;
     VkSurfaceKHR surface;
+    // Renders into images owned by the renderer instead of a window's swapchain, and presents nothing.
+    // There is then no surface, and the device needs no present queue or swapchain support.
+    b8 offscreen;
     vulkan_device device;
     vulkan_swapchain swapchain;
     vulkan_renderpass mainRenderpass;
@@ -176,6 +208,9 @@ typedef struct vulkan_context
     vulkan_object_shader objectShader;
     u64 geometryVertexOffset;
     u64 geometryIndexOffset;
+    // Uploaded geometry, indexed by the geometry of a render_draw.
+    vulkan_geometry geometries[VULKAN_MAX_GEOMETRY_COUNT];
+    u32 geometryCount;
     s32 (*FindMemoryIndex)(u32 typeFilter, u32 propertyFlags);
 
 #if defined(_DEBUG)
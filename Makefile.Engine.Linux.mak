@@ -6,7 +6,7 @@ FOLDER := Engine
 EXTENSION := .so
 COMPILER_FLAGS := -g -MD -Werror=vla -fdeclspec -fPIC
 INCLUDE_FLAGS := -IEngine/src
-LINKER_FLAGS := -g -shared -lvulkan -lxcb -lX11 -lX11-xcb -lxkbcommon -L/usr/X11R6/lib
+LINKER_FLAGS := -g -shared -lvulkan -lxcb -lX11 -lX11-xcb -lxkbcommon -lpthread -L/usr/X11R6/lib
 DEFINES := -D_DEBUG -DKEXPORT
 
 # Make does not offer a recursive wildcard function, so here's one:
@@ -1,3 +1,5 @@
+#define LOG_CHANNEL LOG_CHANNEL_GAME
+
 #include "Game.h"
 
 #include <Core/Logger.h>
@@ -138,14 +140,24 @@ b8 GameUpdate(game* gameInst, f32 dt)
 
     RecalculateViewMatrix(state);
 
-    // HACK: This should not be available outside the engine.
-    RendererSetView(state->view);
-    
+    state->quadAngle += 6.0f * dt;
+
     return true;
 }
 
-b8 GameRender(game* gameInst, f32 dt)
+b8 GameRender(game* gameInst, f32 dt, f32 alpha)
 {
+    game_state* state = (game_state*)gameInst->state;
+
+    // Handed over here rather than in update, which may run while the renderer
+    // is still drawing the previous frame.
+    // HACK: This should not be available outside the engine.
+    RendererSetView(state->view);
+
+    quat rotation = quat_from_axis_angle(vec3_forward(), state->quadAngle, false);
+    mat4 model = quat_to_rotation_matrix(rotation, vec3_zero());
+    RendererSubmitDraw(RENDERER_GEOMETRY_TEST_QUAD, 0, false, model);
+
     return true;
 }
 
@@ -10,12 +10,14 @@ typedef struct game_state {
     vec3 cameraPosition;
     vec3 cameraEuler;
     b8 cameraViewDirty;
+    // The test quad's spin, in radians.
+    f32 quadAngle;
 } game_state;
 
 b8 GameInitialize(game* gameInst);
 
 b8 GameUpdate(game* gameInst, f32 dt);
 
-b8 GameRender(game* gameInst, f32 dt);
+b8 GameRender(game* gameInst, f32 dt, f32 alpha);
 
 void GameOnResize(game* gameInst, u32 width, u32 height);
\ No newline at end of file
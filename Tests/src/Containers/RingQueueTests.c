@@ -0,0 +1,160 @@
+#include "RingQueueTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include <Containers/RingQueue.h>
+#include <Platform/Platform.h>
+#include <Defines.h>
+
+#define PRODUCER_COUNT 4
+#define ITEMS_PER_PRODUCER 100000
+
+u8 RingQueueShouldCreateAndDestroy()
+{
+    ring_queue queue;
+    ExpectToBeTrue(RingQueueCreate(sizeof(u64), 8, 0, &queue));
+    ExpectShouldNotBe(0, queue.memory);
+    ExpectShouldBe(8, queue.capacity);
+    ExpectShouldBe(0, RingQueueLength(&queue));
+
+    RingQueueDestroy(&queue);
+    ExpectShouldBe(0, queue.memory);
+    return true;
+}
+
+u8 RingQueueShouldRejectNonPowerOf2Capacity()
+{
+    ring_queue queue;
+    TDEBUG("The following error is intentionally caused by this test.");
+    ExpectToBeFalse(RingQueueCreate(sizeof(u64), 6, 0, &queue));
+    return true;
+}
+
+u8 RingQueueShouldPreserveOrderAndReportFullAndEmpty()
+{
+    ring_queue queue;
+    RingQueueCreate(sizeof(u64), 4, 0, &queue);
+
+    u64 value = 0;
+    ExpectToBeFalse(RingQueuePop(&queue, &value));
+
+    // Wrap around the ring a few times.
+    for (u64 lap = 0; lap < 3; lap++)
+    {
+        for (u64 i = 0; i < 4; i++)
+        {
+            u64 pushed = lap * 10 + i;
+            ExpectToBeTrue(RingQueuePush(&queue, &pushed));
+        }
+        u64 extra = 99;
+        ExpectToBeFalse(RingQueuePush(&queue, &extra));
+        ExpectShouldBe(4, RingQueueLength(&queue));
+
+        for (u64 i = 0; i < 4; i++)
+        {
+            ExpectToBeTrue(RingQueuePop(&queue, &value));
+            ExpectShouldBe(lap * 10 + i, value);
+        }
+        ExpectToBeFalse(RingQueuePop(&queue, &value));
+    }
+
+    RingQueueDestroy(&queue);
+    return true;
+}
+
+u8 RingQueueShouldWriteInPlace()
+{
+    u8 memory[256];
+    ring_queue queue;
+    u64 requirement = RingQueueMemoryRequirement(sizeof(u32) * 3, 4);
+    ExpectToBeTrue(requirement <= sizeof(memory));
+    RingQueueCreate(sizeof(u32) * 3, 4, memory, &queue);
+
+    u32* slot = RingQueueBeginPush(&queue);
+    ExpectShouldNotBe(0, slot);
+    slot[0] = 1;
+    slot[1] = 2;
+    slot[2] = 3;
+    // Not visible until the push is completed.
+    ExpectShouldBe(0, RingQueueBeginPop(&queue));
+    RingQueueEndPush(&queue, slot);
+
+    u32* read = RingQueueBeginPop(&queue);
+    ExpectShouldNotBe(0, read);
+    ExpectShouldBe(1, read[0]);
+    ExpectShouldBe(2, read[1]);
+    ExpectShouldBe(3, read[2]);
+    RingQueueEndPop(&queue, read);
+
+    RingQueueDestroy(&queue);
+    return true;
+}
+
+typedef struct producer_params
+{
+    ring_queue* queue;
+    u64 producerIndex;
+} producer_params;
+
+static u32 ProduceValues(void* params)
+{
+    producer_params* producer = params;
+    for (u64 i = 0; i < ITEMS_PER_PRODUCER; i++)
+    {
+        // Producer index in the top bits, sequence in the bottom.
+        u64 value = (producer->producerIndex << 32) | i;
+        while (!RingQueuePush(producer->queue, &value))
+        {
+        }
+    }
+    return 0;
+}
+
+u8 RingQueueShouldNotLoseOrReorderAcrossThreads()
+{
+    ring_queue queue;
+    RingQueueCreate(sizeof(u64), 1024, 0, &queue);
+
+    platform_thread threads[PRODUCER_COUNT];
+    producer_params params[PRODUCER_COUNT];
+    for (u64 i = 0; i < PRODUCER_COUNT; i++)
+    {
+        params[i].queue = &queue;
+        params[i].producerIndex = i;
+        ExpectToBeTrue(PlatformThreadCreate(ProduceValues, &params[i], &threads[i]));
+    }
+
+    // Each producer's values must arrive exactly once, in the order it pushed them.
+    u64 nextExpected[PRODUCER_COUNT] = {0};
+    u64 received = 0;
+    while (received < PRODUCER_COUNT * ITEMS_PER_PRODUCER)
+    {
+        u64 value;
+        if (RingQueuePop(&queue, &value))
+        {
+            u64 producer = value >> 32;
+            u64 sequence = value & 0xFFFFFFFF;
+            ExpectToBeTrue(producer < PRODUCER_COUNT);
+            ExpectShouldBe(nextExpected[producer], sequence);
+            nextExpected[producer]++;
+            received++;
+        }
+    }
+
+    for (u64 i = 0; i < PRODUCER_COUNT; i++)
+    {
+        PlatformThreadJoin(&threads[i]);
+    }
+    ExpectShouldBe(0, RingQueueLength(&queue));
+
+    RingQueueDestroy(&queue);
+    return true;
+}
+
+void RingQueueRegisterTests()
+{
+    TestManagerRegisterTest(RingQueueShouldCreateAndDestroy, "Ring queue should create and destroy");
+    TestManagerRegisterTest(RingQueueShouldRejectNonPowerOf2Capacity, "Ring queue should reject a capacity which is not a power of 2");
+    TestManagerRegisterTest(RingQueueShouldPreserveOrderAndReportFullAndEmpty, "Ring queue should preserve order and report full/empty");
+    TestManagerRegisterTest(RingQueueShouldWriteInPlace, "Ring queue should support in-place push and pop");
+    TestManagerRegisterTest(RingQueueShouldNotLoseOrReorderAcrossThreads, "Ring queue should not lose or reorder elements across threads");
+}
\ No newline at end of file
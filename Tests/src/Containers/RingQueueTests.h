@@ -0,0 +1,3 @@
+#pragma once
+
+void RingQueueRegisterTests();
\ No newline at end of file
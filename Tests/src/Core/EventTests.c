@@ -0,0 +1,559 @@
+#include "EventTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include "../TestSystems.h"
+#include <Core/Event.h>
+#include <Core/TMemory.h>
+#include <Platform/Platform.h>
+#include <Defines.h>
+
+#define TEST_EVENT_CODE 0x200
+#define TEST_COALESCED_CODE 0x201
+#define POSTING_THREAD_COUNT 4
+#define POSTS_PER_THREAD 500
+
+typedef struct event_record
+{
+    u32 count;
+    // The last value seen from each posting thread, to check each one's events arrive in order.
+    s32 lastValue[POSTING_THREAD_COUNT];
+    u32 misorderCount;
+} event_record;
+
+static b8 RecordEvent(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    event_record* record = listenerInst;
+    u32 thread = data.data.u32[0];
+    s32 value = (s32)data.data.u32[1];
+    if (value <= record->lastValue[thread]) record->misorderCount++;
+    record->lastValue[thread] = value;
+    record->count++;
+    return false;
+}
+
+static u32 PostEvents(void* params)
+{
+    u32 thread = (u32)(u64)params;
+    for (u32 i = 0; i < POSTS_PER_THREAD; i++)
+    {
+        event_context context;
+        context.data.u32[0] = thread;
+        context.data.u32[1] = i;
+        while (!EventPost(TEST_EVENT_CODE, 0, context))
+        {
+            PlatformThreadYield();
+        }
+    }
+    return 0;
+}
+
+u8 EventShouldDispatchPostsFromManyThreads()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    event_record record = {0};
+    for (u32 i = 0; i < POSTING_THREAD_COUNT; i++)
+    {
+        record.lastValue[i] = -1;
+    }
+    ExpectToBeTrue(EventRegister(TEST_EVENT_CODE, &record, RecordEvent));
+
+    platform_thread threads[POSTING_THREAD_COUNT];
+    for (u32 i = 0; i < POSTING_THREAD_COUNT; i++)
+    {
+        ExpectToBeTrue(PlatformThreadCreate(PostEvents, (void*)(u64)i, &threads[i]));
+    }
+    for (u32 i = 0; i < POSTING_THREAD_COUNT; i++)
+    {
+        PlatformThreadJoin(&threads[i]);
+    }
+
+    // Nothing is fired until dispatched.
+    ExpectShouldBe(0, record.count);
+    u32 firedCount = EventDispatchQueued();
+    u32 expectedCount = POSTING_THREAD_COUNT * POSTS_PER_THREAD;
+    ExpectShouldBe(expectedCount, firedCount);
+    ExpectShouldBe(expectedCount, record.count);
+    ExpectShouldBe(0, record.misorderCount);
+    ExpectShouldBe(0, EventDispatchQueued());
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+static b8 RecordLatest(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    event_record* record = listenerInst;
+    record->lastValue[0] = (s32)data.data.u32[0];
+    record->count++;
+    return false;
+}
+
+u8 EventShouldCoalescePosts()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    event_record coalesced = {0};
+    event_record plain = {0};
+    ExpectToBeTrue(EventRegister(TEST_COALESCED_CODE, &coalesced, RecordLatest));
+    ExpectToBeTrue(EventRegister(TEST_EVENT_CODE, &plain, RecordLatest));
+    EventSetCoalescing(TEST_COALESCED_CODE, true);
+
+    // Enough that the dispatch takes them off the queue in several windows.
+    event_context context = {0};
+    for (u32 i = 0; i < 100; i++)
+    {
+        context.data.u32[0] = i;
+        ExpectToBeTrue(EventPost(TEST_COALESCED_CODE, 0, context));
+        ExpectToBeTrue(EventPost(TEST_EVENT_CODE, 0, context));
+    }
+
+    // All 100 plain events, but only the latest coalesced one.
+    ExpectShouldBe(101, EventDispatchQueued());
+    ExpectShouldBe(1, coalesced.count);
+    ExpectShouldBe(99, coalesced.lastValue[0]);
+    ExpectShouldBe(100, plain.count);
+    ExpectShouldBe(99, plain.lastValue[0]);
+
+    // Turned back off, every event is delivered again.
+    EventSetCoalescing(TEST_COALESCED_CODE, false);
+    ExpectToBeTrue(EventPost(TEST_COALESCED_CODE, 0, context));
+    ExpectToBeTrue(EventPost(TEST_COALESCED_CODE, 0, context));
+    ExpectShouldBe(2, EventDispatchQueued());
+    ExpectShouldBe(3, coalesced.count);
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+static b8 RepostEvent(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    u32* count = listenerInst;
+    (*count)++;
+    EventPost(code, sender, data);
+    return true;
+}
+
+u8 EventShouldDeferPostsMadeWhileDispatching()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    u32 count = 0;
+    ExpectToBeTrue(EventRegister(TEST_EVENT_CODE, &count, RepostEvent));
+
+    event_context context = {0};
+    ExpectToBeTrue(EventPost(TEST_EVENT_CODE, 0, context));
+
+    // Each dispatch fires only the event its handler posted last time, instead of looping forever.
+    for (u32 i = 1; i <= 3; i++)
+    {
+        ExpectShouldBe(1, EventDispatchQueued());
+        ExpectShouldBe(i, count);
+    }
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+static b8 CountEvent(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    u32* counts = listenerInst;
+    // Each code's listener gets its own counter, so a mix-up between codes shows.
+    counts[data.data.u16[0]]++;
+    return data.data.u16[0] == code % 64;
+}
+
+// Reposts the event's context with the coalesced code, as a listener reacting to one event with another would.
+static b8 RepostCoalesced(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    EventPost(TEST_COALESCED_CODE, 0, data);
+    return false;
+}
+
+u8 EventShouldNotSupersedeWithPostsMadeWhileDispatching()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    event_record coalesced = {0};
+    ExpectToBeTrue(EventRegister(TEST_COALESCED_CODE, &coalesced, RecordLatest));
+    ExpectToBeTrue(EventRegister(TEST_EVENT_CODE, 0, RepostCoalesced));
+    EventSetCoalescing(TEST_COALESCED_CODE, true);
+
+    // The plain event's listener posts the coalesced code before the one already queued is reached.
+    event_context context = {0};
+    context.data.u32[0] = 1;
+    ExpectToBeTrue(EventPost(TEST_EVENT_CODE, 0, context));
+    context.data.u32[0] = 2;
+    ExpectToBeTrue(EventPost(TEST_COALESCED_CODE, 0, context));
+
+    // The queued one still fires, as the listener's post waits for the next dispatch.
+    ExpectShouldBe(2, EventDispatchQueued());
+    ExpectShouldBe(1, coalesced.count);
+    ExpectShouldBe(2, coalesced.lastValue[0]);
+
+    ExpectShouldBe(1, EventDispatchQueued());
+    ExpectShouldBe(2, coalesced.count);
+    ExpectShouldBe(1, coalesced.lastValue[0]);
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+u8 EventShouldHandleEveryCode()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    // Spread codes over the whole u16 range, including the very last one.
+    u32 counts[64] = {0};
+    for (u32 i = 0; i < 64; i++)
+    {
+        u16 code = (u16)(0xFFFF - i * 1021);
+        ExpectToBeTrue(EventRegister(code, counts, CountEvent));
+    }
+
+    event_context context = {0};
+    for (u32 i = 0; i < 64; i++)
+    {
+        u16 code = (u16)(0xFFFF - i * 1021);
+        context.data.u16[0] = code % 64;
+        b8 handled = EventFire(code, 0, context);
+        ExpectToBeTrue(handled);
+    }
+    for (u32 i = 0; i < 64; i++)
+    {
+        u16 code = (u16)(0xFFFF - i * 1021);
+        ExpectShouldBe(1, counts[code % 64]);
+    }
+
+    // Codes never registered, or left without listeners, are not handled.
+    b8 handled = EventFire(0xFFFE, 0, context);
+    ExpectToBeFalse(handled);
+    ExpectToBeTrue(EventUnregister(0xFFFF, counts, CountEvent));
+    ExpectToBeFalse(EventUnregister(0xFFFF, counts, CountEvent));
+    handled = EventFire(0xFFFF, 0, context);
+    ExpectToBeFalse(handled);
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+typedef struct call_log
+{
+    u32 count;
+    // The listener instance of each call, in order.
+    void* calls[16];
+    // Handles for the reentrancy test to unregister and register with.
+    event_handle victim;
+    u32 lateListener;
+    u32 lateCount;
+} call_log;
+
+static b8 LogCall(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    call_log* log = sender;
+    log->calls[log->count++] = listenerInst;
+    return listenerInst == (void*)(u64)data.data.u64[0];
+}
+
+u8 EventShouldCallListenersByPriority()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    // Register out of order; equal priorities keep their registration order.
+    s32 priorities[6] = {0, 10, -5, 10, 0, 100};
+    for (u64 i = 0; i < 6; i++)
+    {
+        event_handle handle = EventRegisterPriority(TEST_EVENT_CODE, (void*)(i + 1), LogCall, priorities[i]);
+        ExpectShouldNotBe(INVALID_EVENT_HANDLE, handle);
+    }
+
+    call_log log = {0};
+    event_context context = {0};
+    b8 handled = EventFire(TEST_EVENT_CODE, &log, context);
+    ExpectToBeFalse(handled);
+    u64 expected[6] = {6, 2, 4, 1, 5, 3};
+    ExpectShouldBe(6, log.count);
+    for (u32 i = 0; i < 6; i++)
+    {
+        u64 listener = (u64)log.calls[i];
+        ExpectShouldBe(expected[i], listener);
+    }
+
+    // A higher priority listener can consume the event before the rest see it.
+    log.count = 0;
+    context.data.u64[0] = 2;
+    handled = EventFire(TEST_EVENT_CODE, &log, context);
+    ExpectToBeTrue(handled);
+    ExpectShouldBe(2, log.count);
+
+    // The same listener may register again with another callback, but not the same one.
+    TDEBUG("The following warning is intentionally caused by this test.");
+    ExpectToBeFalse(EventRegister(TEST_EVENT_CODE, (void*)1, LogCall));
+    ExpectToBeTrue(EventRegister(TEST_EVENT_CODE, (void*)1, CountEvent));
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+static b8 RegisterLate(u16 code, void* sender, void* listenerInst, event_context data);
+
+static b8 CountLate(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    call_log* log = sender;
+    log->lateCount++;
+    return false;
+}
+
+// Unregisters a listener yet to be called, and registers a new one, in the middle of a fire.
+static b8 RegisterLate(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    call_log* log = sender;
+    log->calls[log->count++] = listenerInst;
+    if (log->victim != INVALID_EVENT_HANDLE)
+    {
+        EventUnregisterHandle(log->victim);
+        log->victim = INVALID_EVENT_HANDLE;
+        EventRegisterPriority(code, &log->lateListener, CountLate, 1000);
+    }
+    return false;
+}
+
+u8 EventShouldUnregisterByHandle()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    event_handle first = EventRegisterPriority(TEST_EVENT_CODE, (void*)1, RegisterLate, 1);
+    event_handle second = EventRegisterPriority(TEST_EVENT_CODE, (void*)2, LogCall, 0);
+    ExpectShouldNotBe(INVALID_EVENT_HANDLE, first);
+    ExpectShouldNotBe(INVALID_EVENT_HANDLE, second);
+
+    // The second listener is unregistered by the first before its turn, so is skipped, and the
+    // listener registered meanwhile only joins in on the next fire, despite its high priority.
+    call_log log = {0};
+    log.victim = second;
+    event_context context = {0};
+    EventFire(TEST_EVENT_CODE, &log, context);
+    ExpectShouldBe(1, log.count);
+    ExpectShouldBe(0, log.lateCount);
+    EventFire(TEST_EVENT_CODE, &log, context);
+    ExpectShouldBe(2, log.count);
+    ExpectShouldBe(1, log.lateCount);
+
+    // Handles only work once, even after their slot is reused.
+    ExpectToBeFalse(EventUnregisterHandle(second));
+    ExpectToBeTrue(EventUnregisterHandle(first));
+    event_handle reused = EventRegisterPriority(TEST_EVENT_CODE, (void*)3, LogCall, 0);
+    ExpectShouldNotBe(INVALID_EVENT_HANDLE, reused);
+    ExpectToBeFalse(EventUnregisterHandle(first));
+    ExpectToBeFalse(EventUnregisterHandle(INVALID_EVENT_HANDLE));
+    ExpectToBeTrue(EventUnregister(TEST_EVENT_CODE, (void*)3, LogCall));
+    ExpectToBeFalse(EventUnregisterHandle(reused));
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+#define TRANSIENT_LISTENER_COUNT 20000
+
+u8 EventShouldRegisterManyTransientListeners()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    u64 handleSize = sizeof(event_handle) * TRANSIENT_LISTENER_COUNT;
+    event_handle* handles = TAllocate(handleSize, MEMORY_TAG_ARRAY);
+    u32 count = 0;
+    for (u32 round = 0; round < 3; round++)
+    {
+        for (u64 i = 0; i < TRANSIENT_LISTENER_COUNT; i++)
+        {
+            handles[i] = EventRegisterPriority(TEST_EVENT_CODE, (void*)(i + 1), CountLate, (s32)(i % 7));
+            ExpectShouldNotBe(INVALID_EVENT_HANDLE, handles[i]);
+        }
+
+        // Drop every other one, then check the rest are all still called.
+        for (u32 i = 0; i < TRANSIENT_LISTENER_COUNT; i += 2)
+        {
+            ExpectToBeTrue(EventUnregisterHandle(handles[i]));
+        }
+        call_log log = {0};
+        event_context context = {0};
+        EventFire(TEST_EVENT_CODE, &log, context);
+        ExpectShouldBe(TRANSIENT_LISTENER_COUNT / 2, log.lateCount);
+
+        for (u64 i = 1; i < TRANSIENT_LISTENER_COUNT; i += 2)
+        {
+            ExpectToBeTrue(EventUnregister(TEST_EVENT_CODE, (void*)(i + 1), CountLate));
+            count++;
+        }
+    }
+    ExpectShouldBe(3 * TRANSIENT_LISTENER_COUNT / 2, count);
+
+    call_log log = {0};
+    event_context context = {0};
+    EventFire(TEST_EVENT_CODE, &log, context);
+    ExpectShouldBe(0, log.lateCount);
+
+    TFree(handles, handleSize, MEMORY_TAG_ARRAY);
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+typedef struct priority_check
+{
+    // The priority each listener was registered with, indexed by listener - 1.
+    const s32* priorities;
+    u32 count;
+    u64 lastListener;
+    u32 misorderCount;
+} priority_check;
+
+// Counts calls out of priority order, or out of registration order between equal priorities.
+static b8 CheckPriorityOrder(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    priority_check* check = sender;
+    u64 listener = (u64)listenerInst;
+    if (check->count)
+    {
+        s32 previous = check->priorities[check->lastListener - 1];
+        s32 current = check->priorities[listener - 1];
+        if (previous < current || (previous == current && check->lastListener > listener)) check->misorderCount++;
+    }
+    check->lastListener = listener;
+    check->count++;
+    return false;
+}
+
+#define ORDERED_LISTENER_COUNT 40000
+
+u8 EventShouldSortListenersRegisteredInAnyOrder()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    u64 prioritiesSize = sizeof(s32) * ORDERED_LISTENER_COUNT;
+    s32* priorities = TAllocate(prioritiesSize, MEMORY_TAG_ARRAY);
+    priority_check check = {0};
+    check.priorities = priorities;
+    event_context context = {0};
+
+    // Ascending priorities, so every listener has to move to the front. Each priority is given
+    // to two listeners, which must keep the order they were registered in.
+    const u32 firstCount = ORDERED_LISTENER_COUNT / 2;
+    for (u64 i = 0; i < firstCount; i++)
+    {
+        priorities[i] = (s32)(i / 2);
+        event_handle handle = EventRegisterPriority(TEST_EVENT_CODE, (void*)(i + 1), CheckPriorityOrder, priorities[i]);
+        ExpectShouldNotBe(INVALID_EVENT_HANDLE, handle);
+    }
+    EventFire(TEST_EVENT_CODE, &check, context);
+    ExpectShouldBe(firstCount, check.count);
+    ExpectShouldBe(0, check.misorderCount);
+
+    // Then as many again, scattered across the same priorities, to be merged in with the first.
+    for (u64 i = firstCount; i < ORDERED_LISTENER_COUNT; i++)
+    {
+        priorities[i] = (s32)(((i * 7919) % firstCount) / 2);
+        event_handle handle = EventRegisterPriority(TEST_EVENT_CODE, (void*)(i + 1), CheckPriorityOrder, priorities[i]);
+        ExpectShouldNotBe(INVALID_EVENT_HANDLE, handle);
+    }
+    check.count = 0;
+    EventFire(TEST_EVENT_CODE, &check, context);
+    ExpectShouldBe(ORDERED_LISTENER_COUNT, check.count);
+    ExpectShouldBe(0, check.misorderCount);
+
+    TFree(priorities, prioritiesSize, MEMORY_TAG_ARRAY);
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+static b8 SlowListener(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    f64 deadline = PlatformGetAbsoluteTime() + 0.002;
+    while (PlatformGetAbsoluteTime() < deadline)
+    {
+    }
+    return false;
+}
+
+static b8 StopTracing(u16 code, void* sender, void* listenerInst, event_context data)
+{
+    EventSetTracing(false);
+    return false;
+}
+
+u8 EventShouldTraceListenerTime()
+{
+    test_system eventSystem = {0};
+    TestSystemsStartVoid(&eventSystem, EventSystemInitialize, MEMORY_TAG_APPLICATION);
+
+    u32 counts[64] = {0};
+    u32 slowInstance = 0;
+    ExpectToBeTrue(EventRegister(TEST_EVENT_CODE, counts, CountEvent));
+    ExpectToBeTrue(EventRegister(TEST_COALESCED_CODE, counts, CountEvent));
+    ExpectToBeTrue(EventRegister(TEST_COALESCED_CODE, &slowInstance, SlowListener));
+
+    // Nothing is recorded until tracing is turned on.
+    u32 count = 0;
+    ExpectToBeTrue(EventTraceGetFrameStats(&count) == 0);
+    ExpectShouldBe(0, count);
+
+    EventSetTracing(true);
+    event_context context = {0};
+    for (u32 i = 0; i < 3; i++)
+    {
+        EventFire(TEST_EVENT_CODE, 0, context);
+    }
+    EventFire(TEST_COALESCED_CODE, 0, context);
+    EventTraceEndFrame();
+
+    // The code with the slow listener comes first, despite being fired less.
+    const event_trace_stats* stats = EventTraceGetFrameStats(&count);
+    ExpectShouldBe(2, count);
+    ExpectShouldBe(TEST_COALESCED_CODE, stats[0].code);
+    ExpectShouldBe(1, stats[0].fireCount);
+    ExpectToBeTrue(stats[0].listenerTime >= 0.002);
+    ExpectToBeTrue(stats[0].slowestListenerTime >= 0.002);
+    ExpectToBeTrue(stats[0].slowestCallback == SlowListener);
+    ExpectToBeTrue(stats[0].slowestListener == &slowInstance);
+    ExpectShouldBe(TEST_EVENT_CODE, stats[1].code);
+    ExpectShouldBe(3, stats[1].fireCount);
+
+    // Each frame starts afresh.
+    EventFire(TEST_EVENT_CODE, 0, context);
+    EventTraceEndFrame();
+    stats = EventTraceGetFrameStats(&count);
+    ExpectShouldBe(1, count);
+    ExpectShouldBe(1, stats[0].fireCount);
+
+    // Turning tracing off from inside a listener is safe, and stops recording.
+    ExpectToBeTrue(EventRegister(TEST_EVENT_CODE, 0, StopTracing));
+    EventFire(TEST_EVENT_CODE, 0, context);
+    EventTraceEndFrame();
+    stats = EventTraceGetFrameStats(&count);
+    ExpectShouldBe(1, count);
+
+    TestSystemsStop(&eventSystem, EventSystemShutdown);
+    return true;
+}
+
+void EventRegisterTests()
+{
+    TestManagerRegisterTest(EventShouldDispatchPostsFromManyThreads, "Event posts from many threads should all be dispatched in order.");
+    TestManagerRegisterTest(EventShouldCoalescePosts, "Event posts with a coalesced code should only fire the latest.");
+    TestManagerRegisterTest(EventShouldNotSupersedeWithPostsMadeWhileDispatching, "Coalesced events should not be superseded by posts made while dispatching.");
+    TestManagerRegisterTest(EventShouldHandleEveryCode, "Event registry should handle codes across the whole u16 range.");
+    TestManagerRegisterTest(EventShouldCallListenersByPriority, "Event listeners should be called from the highest priority down.");
+    TestManagerRegisterTest(EventShouldUnregisterByHandle, "Event handles should unregister their listener once, even mid-fire.");
+    TestManagerRegisterTest(EventShouldRegisterManyTransientListeners, "Event registry should cope with many transient listeners.");
+    TestManagerRegisterTest(EventShouldSortListenersRegisteredInAnyOrder, "Event listeners registered in any order of priority should be called in order.");
+    TestManagerRegisterTest(EventShouldTraceListenerTime, "Event tracing should record fires and listener time per code.");
+    TestManagerRegisterTest(EventShouldDeferPostsMadeWhileDispatching, "Events posted while dispatching should wait for the next dispatch.");
+}
\ No newline at end of file
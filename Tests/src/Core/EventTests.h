@@ -0,0 +1,3 @@
+#pragma once
+
+void EventRegisterTests();
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "FrameStatsTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include "../TestSystems.h"
+#include <Core/FrameStats.h>
+#include <Core/TMemory.h>
+#include <Defines.h>
+
+static void RecordFrame(f64 frame)
+{
+    // The other stages take fixed fractions of the frame, to tell them apart.
+    f64 times[FRAME_STAT_MAX];
+    times[FRAME_STAT_FRAME] = frame;
+    times[FRAME_STAT_UPDATE] = frame * 0.5;
+    times[FRAME_STAT_RENDER] = frame * 0.25;
+    times[FRAME_STAT_PRESENT] = frame * 0.125;
+    times[FRAME_STAT_PACING_ERROR] = 0;
+    FrameStatsRecord(times);
+}
+
+u8 FrameStatsShouldComputePercentiles()
+{
+    test_system frameStats = {0};
+    TestSystemsStartVoid(&frameStats, FrameStatsInitialize, MEMORY_TAG_APPLICATION);
+
+    frame_stat_summary summary;
+    FrameStatsGetSummary(FRAME_STAT_FRAME, &summary);
+    ExpectShouldBe(0, summary.sampleCount);
+
+    // 1ms to 100ms, out of order.
+    for (u32 i = 0; i < 100; i++)
+    {
+        u32 ms = (i * 37) % 100 + 1;
+        RecordFrame(ms / 1000.0);
+    }
+
+    // Compared in ms, as the float tolerance is too loose for seconds.
+    FrameStatsGetSummary(FRAME_STAT_FRAME, &summary);
+    ExpectShouldBe(100, summary.sampleCount);
+    f64 averageMs = summary.average * 1000.0;
+    f64 p50Ms = summary.p50 * 1000.0;
+    f64 p95Ms = summary.p95 * 1000.0;
+    f64 p99Ms = summary.p99 * 1000.0;
+    f64 maxMs = summary.max * 1000.0;
+    ExpectFloatToBe(50.5, averageMs);
+    ExpectFloatToBe(50.0, p50Ms);
+    ExpectFloatToBe(95.0, p95Ms);
+    ExpectFloatToBe(99.0, p99Ms);
+    ExpectFloatToBe(100.0, maxMs);
+
+    FrameStatsGetSummary(FRAME_STAT_UPDATE, &summary);
+    maxMs = summary.max * 1000.0;
+    ExpectFloatToBe(50.0, maxMs);
+    FrameStatsGetSummary(FRAME_STAT_PRESENT, &summary);
+    maxMs = summary.max * 1000.0;
+    ExpectFloatToBe(12.5, maxMs);
+
+    TestSystemsStop(&frameStats, FrameStatsShutdown);
+    return true;
+}
+
+u8 FrameStatsShouldKeepARollingWindow()
+{
+    test_system frameStats = {0};
+    TestSystemsStartVoid(&frameStats, FrameStatsInitialize, MEMORY_TAG_APPLICATION);
+
+    // A hitch, then enough quick frames to push it out of the window.
+    RecordFrame(0.25);
+    for (u32 i = 0; i < FRAME_STATS_WINDOW; i++)
+    {
+        RecordFrame(0.001);
+    }
+
+    frame_stat_summary summary;
+    FrameStatsGetSummary(FRAME_STAT_FRAME, &summary);
+    ExpectShouldBe(FRAME_STATS_WINDOW, summary.sampleCount);
+    f64 maxMs = summary.max * 1000.0;
+    ExpectFloatToBe(1.0, maxMs);
+
+    // The histogram still remembers it, in the last bucket, as it is beyond the others.
+    const u64* histogram = FrameStatsGetHistogram(FRAME_STAT_FRAME);
+    u64 lastBucket = histogram[FRAME_STATS_HISTOGRAM_BUCKETS - 1];
+    u64 oneMsBucket = histogram[2];
+    ExpectShouldBe(1, lastBucket);
+    ExpectShouldBe(FRAME_STATS_WINDOW, oneMsBucket);
+
+    // Counted past where a small counter would wrap.
+    u64 frameCount = FrameStatsGetFrameCount();
+    ExpectShouldBe(FRAME_STATS_WINDOW + 1, frameCount);
+
+    TestSystemsStop(&frameStats, FrameStatsShutdown);
+    return true;
+}
+
+void FrameStatsRegisterTests()
+{
+    TestManagerRegisterTest(FrameStatsShouldComputePercentiles, "Frame stats should compute percentiles of each stage.");
+    TestManagerRegisterTest(FrameStatsShouldKeepARollingWindow, "Frame stats should keep a rolling window and a full histogram.");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void FrameStatsRegisterTests();
\ No newline at end of file
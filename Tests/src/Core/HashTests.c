@@ -0,0 +1,147 @@
+#include "HashTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include <Core/THash.h>
+#include <Core/TMemory.h>
+#include <Core/TString.h>
+#include <Platform/Platform.h>
+#include <Defines.h>
+
+// Size of the generated buffer used by the reference xxHash sanity tests.
+#define SANITY_BUFFER_SIZE 101
+#define SANITY_PRIME 2654435761U
+
+static void FillSanityBuffer(u8* buffer)
+{
+    u32 byteGen = SANITY_PRIME;
+    for (u32 i = 0; i < SANITY_BUFFER_SIZE; i++)
+    {
+        buffer[i] = (u8)(byteGen >> 24);
+        byteGen *= byteGen;
+    }
+}
+
+u8 HashShouldMatchKnownVectors32()
+{
+    const char* abc = "abc";
+    const char* nobody = "Nobody inspects the spammish repetition";
+
+    ExpectShouldBe(0x02CC5D05U, Hash32(0, 0, 0));
+    ExpectShouldBe(0x36B78AE7U, Hash32(0, 0, SANITY_PRIME));
+    ExpectShouldBe(0x32D153FFU, Hash32(abc, StringLength(abc), 0));
+    ExpectShouldBe(0xE2293B2FU, Hash32(nobody, StringLength(nobody), 0));
+
+    u8 sanity[SANITY_BUFFER_SIZE];
+    FillSanityBuffer(sanity);
+    ExpectShouldBe(0xB85CBEE5U, Hash32(sanity, 1, 0));
+    ExpectShouldBe(0xD5845D64U, Hash32(sanity, 1, SANITY_PRIME));
+    ExpectShouldBe(0xE5AA0AB4U, Hash32(sanity, 14, 0));
+    ExpectShouldBe(0x4481951DU, Hash32(sanity, 14, SANITY_PRIME));
+    ExpectShouldBe(0x1F1AA412U, Hash32(sanity, SANITY_BUFFER_SIZE, 0));
+    ExpectShouldBe(0x498EC8E2U, Hash32(sanity, SANITY_BUFFER_SIZE, SANITY_PRIME));
+
+    return true;
+}
+
+u8 HashShouldMatchKnownVectors64()
+{
+    const char* abc = "abc";
+    const char* nobody = "Nobody inspects the spammish repetition";
+
+    ExpectShouldBe(0xEF46DB3751D8E999ULL, Hash64(0, 0, 0));
+    ExpectShouldBe(0xAC75FDA2929B17EFULL, Hash64(0, 0, SANITY_PRIME));
+    ExpectShouldBe(0x44BC2CF5AD770999ULL, Hash64(abc, StringLength(abc), 0));
+    ExpectShouldBe(0xFBCEA83C8A378BF1ULL, Hash64(nobody, StringLength(nobody), 0));
+
+    u8 sanity[SANITY_BUFFER_SIZE];
+    FillSanityBuffer(sanity);
+    ExpectShouldBe(0x4FCE394CC88952D8ULL, Hash64(sanity, 1, 0));
+    ExpectShouldBe(0x739840CB819FA723ULL, Hash64(sanity, 1, SANITY_PRIME));
+    ExpectShouldBe(0xCFFA8DB881BC3A3DULL, Hash64(sanity, 14, 0));
+    ExpectShouldBe(0x5B9611585EFCC9CBULL, Hash64(sanity, 14, SANITY_PRIME));
+    ExpectShouldBe(0x0EAB543384F878ADULL, Hash64(sanity, SANITY_BUFFER_SIZE, 0));
+    ExpectShouldBe(0xCAA65939306F1E21ULL, Hash64(sanity, SANITY_BUFFER_SIZE, SANITY_PRIME));
+
+    return true;
+}
+
+u8 HashStreamingShouldMatchOneShot()
+{
+    u8 sanity[SANITY_BUFFER_SIZE];
+    FillSanityBuffer(sanity);
+
+    // Feed the buffer in every chunk size to hit all of the partial-stripe paths.
+    for (u32 chunk = 1; chunk <= SANITY_BUFFER_SIZE; chunk++)
+    {
+        hash32_state state32;
+        hash64_state state64;
+        Hash32Reset(&state32, SANITY_PRIME);
+        Hash64Reset(&state64, SANITY_PRIME);
+
+        for (u32 offset = 0; offset < SANITY_BUFFER_SIZE; offset += chunk)
+        {
+            u32 size = (offset + chunk > SANITY_BUFFER_SIZE) ? SANITY_BUFFER_SIZE - offset : chunk;
+            Hash32Update(&state32, sanity + offset, size);
+            Hash64Update(&state64, sanity + offset, size);
+        }
+
+        ExpectShouldBe(Hash32(sanity, SANITY_BUFFER_SIZE, SANITY_PRIME), Hash32Digest(&state32));
+        ExpectShouldBe(Hash64(sanity, SANITY_BUFFER_SIZE, SANITY_PRIME), Hash64Digest(&state64));
+    }
+
+    return true;
+}
+
+static u64 HashFNV1a64(const void* data, u64 length)
+{
+    const u8* p = (const u8*)data;
+    u64 h = 0xCBF29CE484222325ULL;
+    for (u64 i = 0; i < length; i++)
+    {
+        h ^= p[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
+
+u8 HashBenchmarkAgainstFNV1a()
+{
+    const u64 size = 64 * 1024 * 1024;
+    const u32 iterations = 4;
+    u8* buffer = TAllocate(size, MEMORY_TAG_ARRAY);
+    for (u64 i = 0; i < size; i++)
+    {
+        buffer[i] = (u8)(i * 31);
+    }
+
+    // Accumulate the results so the calls cannot be optimized away.
+    u64 sink = 0;
+    f64 gib = (f64)size * iterations / (1024.0 * 1024.0 * 1024.0);
+
+    f64 start = PlatformGetAbsoluteTime();
+    for (u32 i = 0; i < iterations; i++) sink += Hash64(buffer, size, i);
+    f64 hash64Time = PlatformGetAbsoluteTime() - start;
+
+    start = PlatformGetAbsoluteTime();
+    for (u32 i = 0; i < iterations; i++) sink += Hash32(buffer, size, i);
+    f64 hash32Time = PlatformGetAbsoluteTime() - start;
+
+    start = PlatformGetAbsoluteTime();
+    for (u32 i = 0; i < iterations; i++) sink += HashFNV1a64(buffer, size);
+    f64 fnvTime = PlatformGetAbsoluteTime() - start;
+
+    TINFO("Hash64: %.2f GiB/s, Hash32: %.2f GiB/s, FNV-1a: %.2f GiB/s (sink %llu)",
+          gib / hash64Time, gib / hash32Time, gib / fnvTime, sink);
+
+    TFree(buffer, size, MEMORY_TAG_ARRAY);
+
+    return true;
+}
+
+void HashRegisterTests()
+{
+    TestManagerRegisterTest(HashShouldMatchKnownVectors32, "Hash32 should match published test vectors");
+    TestManagerRegisterTest(HashShouldMatchKnownVectors64, "Hash64 should match published test vectors");
+    TestManagerRegisterTest(HashStreamingShouldMatchOneShot, "Streaming hash should match one-shot hash");
+    TestManagerRegisterTest(HashBenchmarkAgainstFNV1a, "Hash throughput benchmark against FNV-1a");
+}
\ No newline at end of file
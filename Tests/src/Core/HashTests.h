@@ -0,0 +1,3 @@
+#pragma once
+
+void HashRegisterTests();
\ No newline at end of file
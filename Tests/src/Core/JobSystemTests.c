@@ -0,0 +1,255 @@
+#include "JobSystemTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include "../TestSystems.h"
+#include <Core/JobSystem.h>
+#include <Core/TMemory.h>
+#include <Platform/Platform.h>
+#include <Platform/Atomic.h>
+#include <Defines.h>
+
+#define JOB_COUNT 10000
+#define PARENT_COUNT 64
+#define CHILDREN_PER_PARENT 32
+#define TREE_DEPTH 5
+#define TREE_FAN_OUT 4
+
+static void IncrementJob(void* params)
+{
+    AtomicFetchAdd32(params, 1, ATOMIC_RELAXED);
+}
+
+u8 JobSystemShouldRunEveryJob()
+{
+    test_system jobSystem = {0};
+    b8 started = TestSystemsStartJobSystem(&jobSystem, 4);
+    ExpectToBeTrue(started);
+    ExpectShouldBe(4, JobSystemGetWorkerCount());
+    ExpectShouldBe(0, JobSystemGetWorkerIndex());
+
+    static job_desc jobs[JOB_COUNT];
+    u32 total = 0;
+    for (u32 i = 0; i < JOB_COUNT; i++)
+    {
+        jobs[i].entry = IncrementJob;
+        jobs[i].params = &total;
+        jobs[i].priority = (job_priority)(i % JOB_PRIORITY_MAX);
+    }
+
+    job_counter counter = {0};
+    JobSubmit(jobs, JOB_COUNT, &counter);
+    JobWait(&counter);
+    ExpectToBeTrue(JobIsDone(&counter));
+    ExpectShouldBe(JOB_COUNT, total);
+
+    TestSystemsStopJobSystem(&jobSystem);
+    ExpectShouldBe(1, JobSystemGetWorkerCount());
+    ExpectShouldBe(-1, JobSystemGetWorkerIndex());
+    return true;
+}
+
+typedef struct parent_job
+{
+    u32* total;
+    u32 childTotal;
+} parent_job;
+
+static void ParentJob(void* params)
+{
+    parent_job* parent = params;
+    job_desc children[CHILDREN_PER_PARENT];
+    for (u32 i = 0; i < CHILDREN_PER_PARENT; i++)
+    {
+        children[i].entry = IncrementJob;
+        children[i].params = &parent->childTotal;
+        children[i].priority = JOB_PRIORITY_HIGH;
+    }
+
+    // Waiting inside a job runs other jobs rather than blocking the worker.
+    job_counter counter = {0};
+    JobSubmit(children, CHILDREN_PER_PARENT, &counter);
+    JobWait(&counter);
+
+    AtomicFetchAdd32(parent->total, AtomicLoad32(&parent->childTotal, ATOMIC_RELAXED), ATOMIC_RELAXED);
+}
+
+u8 JobSystemShouldWaitOnNestedJobs()
+{
+    test_system jobSystem = {0};
+    b8 started = TestSystemsStartJobSystem(&jobSystem, 4);
+    ExpectToBeTrue(started);
+
+    u32 total = 0;
+    parent_job parents[PARENT_COUNT];
+    job_desc jobs[PARENT_COUNT];
+    for (u32 i = 0; i < PARENT_COUNT; i++)
+    {
+        parents[i].total = &total;
+        parents[i].childTotal = 0;
+        jobs[i].entry = ParentJob;
+        jobs[i].params = &parents[i];
+        jobs[i].priority = JOB_PRIORITY_NORMAL;
+    }
+
+    job_counter counter = {0};
+    JobSubmit(jobs, PARENT_COUNT, &counter);
+    JobWait(&counter);
+    u32 expected = PARENT_COUNT * CHILDREN_PER_PARENT;
+    ExpectShouldBe(expected, total);
+
+    TestSystemsStopJobSystem(&jobSystem);
+    return true;
+}
+
+typedef struct order_test
+{
+    u32 order[6];
+    u32 count;
+} order_test;
+
+typedef struct order_job
+{
+    order_test* test;
+    u32 id;
+} order_job;
+
+static void RecordOrderJob(void* params)
+{
+    order_job* j = params;
+    j->test->order[j->test->count++] = j->id;
+}
+
+u8 JobSystemShouldRunHigherPriorityFirst()
+{
+    // With a single worker, everything runs on this thread while it waits, so the order is deterministic.
+    test_system jobSystem = {0};
+    b8 started = TestSystemsStartJobSystem(&jobSystem, 1);
+    ExpectToBeTrue(started);
+
+    order_test test = {0};
+    order_job params[6];
+    job_desc jobs[6];
+    job_priority priorities[6] = {JOB_PRIORITY_LOW, JOB_PRIORITY_LOW, JOB_PRIORITY_NORMAL, JOB_PRIORITY_NORMAL, JOB_PRIORITY_HIGH, JOB_PRIORITY_HIGH};
+    for (u32 i = 0; i < 6; i++)
+    {
+        params[i].test = &test;
+        params[i].id = i;
+        jobs[i].entry = RecordOrderJob;
+        jobs[i].params = &params[i];
+        jobs[i].priority = priorities[i];
+    }
+
+    job_counter counter = {0};
+    JobSubmit(jobs, 6, &counter);
+    JobWait(&counter);
+    ExpectShouldBe(6, test.count);
+
+    // Highest priority first; within a priority, a worker's own jobs run newest first.
+    u32 expected[6] = {5, 4, 3, 2, 1, 0};
+    for (u32 i = 0; i < 6; i++)
+    {
+        ExpectShouldBe(expected[i], test.order[i]);
+    }
+
+    TestSystemsStopJobSystem(&jobSystem);
+    return true;
+}
+
+u8 JobSystemShouldRunInlineWhenNotStarted()
+{
+    u32 total = 0;
+    job_desc jobs[3] = {
+        {IncrementJob, &total, JOB_PRIORITY_HIGH},
+        {IncrementJob, &total, JOB_PRIORITY_NORMAL},
+        {IncrementJob, &total, JOB_PRIORITY_LOW}};
+
+    job_counter counter = {0};
+    JobSubmit(jobs, 3, &counter);
+    ExpectShouldBe(3, total);
+    ExpectToBeTrue(JobIsDone(&counter));
+    JobWait(&counter);
+    return true;
+}
+
+typedef struct tree_test
+{
+    u32 leafCount;
+    // Waits which came back somewhere other than a worker thread.
+    u32 misplacedCount;
+} tree_test;
+
+typedef struct tree_node
+{
+    tree_test* test;
+    u32 depth;
+} tree_node;
+
+static void TreeNodeJob(void* params)
+{
+    tree_node* node = params;
+    if (node->depth == TREE_DEPTH)
+    {
+        AtomicFetchAdd32(&node->test->leafCount, 1, ATOMIC_RELAXED);
+        return;
+    }
+
+    tree_node children[TREE_FAN_OUT];
+    job_desc jobs[TREE_FAN_OUT];
+    for (u32 i = 0; i < TREE_FAN_OUT; i++)
+    {
+        children[i].test = node->test;
+        children[i].depth = node->depth + 1;
+        jobs[i].entry = TreeNodeJob;
+        jobs[i].params = &children[i];
+        jobs[i].priority = JOB_PRIORITY_NORMAL;
+    }
+
+    // Straight-line code: submit, wait, carry on. The wait parks this job, which may then
+    // resume on any worker thread.
+    job_counter counter = {0};
+    JobSubmit(jobs, TREE_FAN_OUT, &counter);
+    JobWait(&counter);
+    if (JobSystemGetWorkerIndex() < 1)
+    {
+        AtomicFetchAdd32(&node->test->misplacedCount, 1, ATOMIC_RELAXED);
+    }
+}
+
+u8 JobSystemShouldResumeParkedJobs()
+{
+    test_system jobSystem = {0};
+    b8 started = TestSystemsStartJobSystem(&jobSystem, 3);
+    ExpectToBeTrue(started);
+
+    tree_test test = {0};
+    tree_node root = {&test, 0};
+    job_desc rootJob = {TreeNodeJob, &root, JOB_PRIORITY_NORMAL};
+    job_counter counter = {0};
+    JobSubmit(&rootJob, 1, &counter);
+
+    // Poll rather than JobWait, so only the worker threads run the tree.
+    while (!JobIsDone(&counter))
+    {
+        PlatformThreadYield();
+    }
+
+    u32 expectedLeaves = 1;
+    for (u32 i = 0; i < TREE_DEPTH; i++)
+    {
+        expectedLeaves *= TREE_FAN_OUT;
+    }
+    ExpectShouldBe(expectedLeaves, test.leafCount);
+    ExpectShouldBe(0, test.misplacedCount);
+
+    TestSystemsStopJobSystem(&jobSystem);
+    return true;
+}
+
+void JobSystemRegisterTests()
+{
+    TestManagerRegisterTest(JobSystemShouldRunEveryJob, "Job system should run every submitted job");
+    TestManagerRegisterTest(JobSystemShouldWaitOnNestedJobs, "Job system should let jobs wait on child jobs");
+    TestManagerRegisterTest(JobSystemShouldRunHigherPriorityFirst, "Job system should run higher priority jobs first");
+    TestManagerRegisterTest(JobSystemShouldResumeParkedJobs, "Job system should resume jobs parked on a counter");
+    TestManagerRegisterTest(JobSystemShouldRunInlineWhenNotStarted, "Job system should run jobs inline when not started");
+}
\ No newline at end of file
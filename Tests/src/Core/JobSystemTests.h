@@ -0,0 +1,3 @@
+#pragma once
+
+void JobSystemRegisterTests();
\ No newline at end of file
@@ -0,0 +1,180 @@
+#include "LoggerTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include <Core/Logger.h>
+#include <Core/TString.h>
+#include <Platform/Platform.h>
+#include <Defines.h>
+
+#define BENCHMARK_ITERATIONS 1000000
+
+// Encodes the arguments as a call site would, decodes the record and compares
+// the result against formatting the same call directly.
+#define ExpectRoundTrip(format, ...)                                                            \
+    {                                                                                           \
+        static u32 formatId = 0;                                                                \
+        u32 id = LogRegisterFormat(&formatId, format);                                          \
+        ExpectShouldNotBe(0, id);                                                               \
+        u8 record[1024];                                                                        \
+        u64 recordSize = LogBinaryEncode(record, sizeof(record), id, LOG_ARG_TYPES(__VA_ARGS__), ##__VA_ARGS__); \
+        char decoded[512];                                                                      \
+        char expected[512];                                                                     \
+        LogBinaryDecode(record, recordSize, decoded, sizeof(decoded));                          \
+        StringFormatN(expected, sizeof(expected), format, ##__VA_ARGS__);                       \
+        if (!StringsEqual(expected, decoded))                                                   \
+        {                                                                                       \
+            TERROR("--> Expected '%s', but got: '%s'. File: %s:%d.", expected, decoded, __FILE__, __LINE__); \
+            return false;                                                                       \
+        }                                                                                       \
+    }
+
+u8 LoggerArgTypesShouldBeCapturedAtCompileTime()
+{
+    u8 small = 1;
+    s64 big = -1;
+    const char* text = "text";
+    f32 real = 1.0f;
+    void* pointer = &big;
+
+    u64 types = LOG_ARG_TYPES();
+    ExpectShouldBe(0, types);
+    types = LOG_ARG_TYPES(small);
+    u64 expected = 1 | ((u64)LOG_ARG_S32 << 4);
+    ExpectShouldBe(expected, types);
+    // The last argument is in the lowest type nibble.
+    types = LOG_ARG_TYPES(small, big, text, real, pointer);
+    expected = 5 | ((u64)LOG_ARG_POINTER << 4) | ((u64)LOG_ARG_F64 << 8) | ((u64)LOG_ARG_STRING << 12) |
+                   ((u64)LOG_ARG_S64 << 16) | ((u64)LOG_ARG_S32 << 20);
+    ExpectShouldBe(expected, types);
+    return true;
+}
+
+u8 LoggerBinaryRecordsShouldDecodeLikeFormatting()
+{
+    s32 negative = -42;
+    u32 unsignedValue = 4000000000U;
+    u64 large = 18000000000000000000ULL;
+    s64 largeNegative = -9000000000000000000LL;
+    f32 real = 3.14159f;
+    char buffer[16] = "buffer";
+    u8 byte = 200;
+
+    ExpectRoundTrip("No arguments at all.");
+    ExpectRoundTrip("Percent %% signs %%");
+    ExpectRoundTrip("Int %d, padded %05i, hex %x", negative, 42, 255);
+    ExpectRoundTrip("Unsigned %u and byte %u", unsignedValue, byte);
+    ExpectRoundTrip("64-bit %llu %lld %llx", large, largeNegative, large);
+    ExpectRoundTrip("Float %f %.2f %e %g", real, 2.5, real, 1e-10);
+    ExpectRoundTrip("Strings '%s' '%-10s' '%.3s'", "literal", buffer, "truncated");
+    ExpectRoundTrip("Star width '%*d' and precision '%.*f'", 8, negative, 3, real);
+    ExpectRoundTrip("Char '%c'", 'x');
+    ExpectRoundTrip("Twelve %d %d %d %d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12);
+    return true;
+}
+
+u8 LoggerBinaryRecordsShouldTruncateLongStrings()
+{
+    static u32 formatId = 0;
+    u32 id = LogRegisterFormat(&formatId, "%s then %d");
+
+    char longString[600];
+    for (u32 i = 0; i < sizeof(longString) - 1; i++)
+    {
+        longString[i] = 'a' + (i % 26);
+    }
+    longString[sizeof(longString) - 1] = 0;
+
+    // Too small for the string, but the trailing argument must survive.
+    u8 record[128];
+    u64 recordSize = LogBinaryEncode(record, sizeof(record), id, LOG_ARG_TYPES(longString, 7), longString, 7);
+    ExpectToBeTrue(recordSize <= sizeof(record));
+
+    char decoded[1024];
+    u64 length = LogBinaryDecode(record, recordSize, decoded, sizeof(decoded));
+    ExpectToBeTrue(length > 0);
+    ExpectShouldBe('7', decoded[length - 1]);
+    ExpectShouldBe('a', decoded[0]);
+    return true;
+}
+
+u8 LoggerShouldRegisterEachCallSiteOnce()
+{
+    u32 ids[2] = {0, 0};
+    for (u32 i = 0; i < 2; i++)
+    {
+        static u32 formatId = 0;
+        ids[i] = LogRegisterFormat(&formatId, "Call site %d");
+    }
+    ExpectShouldBe(ids[0], ids[1]);
+    ExpectToBeTrue(StringsEqual("Call site %d", LogGetFormat(ids[0])));
+    ExpectShouldBe(0, LogGetFormat(0));
+    return true;
+}
+
+static s32 CountEvaluation(s32* evaluations)
+{
+    return ++(*evaluations);
+}
+
+u8 LoggerShouldFilterByChannelWithoutEvaluatingArguments()
+{
+    log_level previous = LogGetChannelLevel(LOG_CHANNEL_GAME);
+    s32 evaluations = 0;
+
+    LogSetChannelLevel(LOG_CHANNEL_GAME, LOG_LEVEL_WARN);
+    ExpectShouldBe(LOG_LEVEL_WARN, LogGetChannelLevel(LOG_CHANNEL_GAME));
+    TTRACE_CH(LOG_CHANNEL_GAME, "Filtered trace %d", CountEvaluation(&evaluations));
+    TDEBUG_CH(LOG_CHANNEL_GAME, "Filtered debug %d", CountEvaluation(&evaluations));
+    TINFO_CH(LOG_CHANNEL_GAME, "Filtered info %d", CountEvaluation(&evaluations));
+    ExpectShouldBe(0, evaluations);
+
+    // Other channels are unaffected.
+    LogSetChannelLevel(LOG_CHANNEL_CORE, LOG_LEVEL_DEBUG);
+    TDEBUG_CH(LOG_CHANNEL_CORE, "Channel filter test message %d.", CountEvaluation(&evaluations));
+    ExpectShouldBe(1, evaluations);
+
+    // Errors cannot be filtered out.
+    LogSetChannelLevel(LOG_CHANNEL_GAME, LOG_LEVEL_FATAL);
+    ExpectShouldBe(LOG_LEVEL_ERROR, LogGetChannelLevel(LOG_CHANNEL_GAME));
+
+    LogSetChannelLevel(LOG_CHANNEL_GAME, previous);
+    return true;
+}
+
+u8 LoggerBinaryCaptureBenchmark()
+{
+    static u32 formatId = 0;
+    const char* format = "Entity %u moved to (%f, %f, %f) in %s";
+    u32 id = LogRegisterFormat(&formatId, format);
+    const char* zone = "zone";
+    u8 record[1024];
+    char text[1024];
+
+    f64 start = PlatformGetAbsoluteTime();
+    for (u32 i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        LogBinaryEncode(record, sizeof(record), id, LOG_ARG_TYPES(i, 1.0, 2.0, 3.0, zone), i, 1.0, 2.0, 3.0, zone);
+    }
+    f64 binaryTime = PlatformGetAbsoluteTime() - start;
+
+    start = PlatformGetAbsoluteTime();
+    for (u32 i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        StringFormatN(text, sizeof(text), format, i, 1.0, 2.0, 3.0, zone);
+    }
+    f64 formatTime = PlatformGetAbsoluteTime() - start;
+
+    TINFO("Binary capture: %.1fns/call, formatting: %.1fns/call.",
+          binaryTime * 1e9 / BENCHMARK_ITERATIONS, formatTime * 1e9 / BENCHMARK_ITERATIONS);
+    return true;
+}
+
+void LoggerRegisterTests()
+{
+    TestManagerRegisterTest(LoggerArgTypesShouldBeCapturedAtCompileTime, "Logger should capture argument types at compile time");
+    TestManagerRegisterTest(LoggerBinaryRecordsShouldDecodeLikeFormatting, "Logger binary records should decode to the same text as formatting");
+    TestManagerRegisterTest(LoggerBinaryRecordsShouldTruncateLongStrings, "Logger binary records should truncate strings which do not fit");
+    TestManagerRegisterTest(LoggerShouldRegisterEachCallSiteOnce, "Logger should register each call site once");
+    TestManagerRegisterTest(LoggerShouldFilterByChannelWithoutEvaluatingArguments, "Logger should filter by channel without evaluating arguments");
+    TestManagerRegisterTest(LoggerBinaryCaptureBenchmark, "Logger binary capture benchmark");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void LoggerRegisterTests();
\ No newline at end of file
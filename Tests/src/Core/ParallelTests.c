@@ -0,0 +1,150 @@
+#include "ParallelTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include "../TestSystems.h"
+#include <Core/Parallel.h>
+#include <Core/TMemory.h>
+#include <Math/TMath.h>
+#include <Platform/Atomic.h>
+#include <Defines.h>
+
+#define ITEM_COUNT 100000
+#define MATRIX_COUNT 4096
+
+static void CountVisits(u64 start, u64 end, void* userData)
+{
+    u32* visits = userData;
+    for (u64 i = start; i < end; i++)
+    {
+        AtomicFetchAdd32(&visits[i], 1, ATOMIC_RELAXED);
+    }
+}
+
+// Every item should be visited exactly once, whatever the grain.
+static b8 VisitsEveryItemOnce(u64 grainSize)
+{
+    u32* visits = TAllocate(sizeof(u32) * ITEM_COUNT, MEMORY_TAG_JOB);
+    ParallelFor(ITEM_COUNT, grainSize, CountVisits, visits);
+
+    b8 result = true;
+    for (u32 i = 0; i < ITEM_COUNT; i++)
+    {
+        if (visits[i] != 1) result = false;
+    }
+    TFree(visits, sizeof(u32) * ITEM_COUNT, MEMORY_TAG_JOB);
+    return result;
+}
+
+u8 ParallelForShouldVisitEveryItemOnce()
+{
+    test_system jobSystem = {0};
+    b8 started = TestSystemsStartJobSystem(&jobSystem, 4);
+    ExpectToBeTrue(started);
+
+    ExpectToBeTrue(VisitsEveryItemOnce(0));
+    ExpectToBeTrue(VisitsEveryItemOnce(1));
+    ExpectToBeTrue(VisitsEveryItemOnce(777));
+    ExpectToBeTrue(VisitsEveryItemOnce(ITEM_COUNT * 2));
+
+    TestSystemsStopJobSystem(&jobSystem);
+
+    // Without the job system, everything runs on this thread.
+    ExpectToBeTrue(VisitsEveryItemOnce(100));
+    return true;
+}
+
+typedef struct transform_test
+{
+    mat4 parent;
+    mat4* locals;
+    mat4* worlds;
+} transform_test;
+
+static void TransformMatrices(u64 start, u64 end, void* userData)
+{
+    transform_test* test = userData;
+    for (u64 i = start; i < end; i++)
+    {
+        test->worlds[i] = mat4_mul(test->locals[i], test->parent);
+    }
+}
+
+u8 ParallelForShouldTransformMatrices()
+{
+    test_system jobSystem = {0};
+    b8 started = TestSystemsStartJobSystem(&jobSystem, 4);
+    ExpectToBeTrue(started);
+
+    transform_test test;
+    test.parent = mat4_mul(mat4_euler_x(0.5f), mat4_translation((vec3){1.0f, 2.0f, 3.0f}));
+    test.locals = TAllocate(sizeof(mat4) * MATRIX_COUNT, MEMORY_TAG_JOB);
+    test.worlds = TAllocate(sizeof(mat4) * MATRIX_COUNT, MEMORY_TAG_JOB);
+    for (u32 i = 0; i < MATRIX_COUNT; i++)
+    {
+        test.locals[i] = mat4_translation((vec3){(f32)i, 0.0f, -(f32)i});
+    }
+
+    ParallelFor(MATRIX_COUNT, 64, TransformMatrices, &test);
+
+    for (u32 i = 0; i < MATRIX_COUNT; i++)
+    {
+        mat4 expected = mat4_mul(test.locals[i], test.parent);
+        for (u32 j = 0; j < 16; j++)
+        {
+            ExpectFloatToBe(expected.data[j], test.worlds[i].data[j]);
+        }
+    }
+
+    TFree(test.locals, sizeof(mat4) * MATRIX_COUNT, MEMORY_TAG_JOB);
+    TFree(test.worlds, sizeof(mat4) * MATRIX_COUNT, MEMORY_TAG_JOB);
+    TestSystemsStopJobSystem(&jobSystem);
+    return true;
+}
+
+static void SumRange(u64 start, u64 end, void* partial, void* userData)
+{
+    u64* sum = partial;
+    for (u64 i = start; i < end; i++)
+    {
+        *sum += i;
+    }
+}
+
+static void CombineSums(void* result, const void* partial, void* userData)
+{
+    *(u64*)result += *(const u64*)partial;
+}
+
+u8 ParallelReduceShouldCombinePartials()
+{
+    test_system jobSystem = {0};
+    b8 started = TestSystemsStartJobSystem(&jobSystem, 4);
+    ExpectToBeTrue(started);
+
+    u64 identity = 0;
+    u64 expected = (u64)ITEM_COUNT * (ITEM_COUNT - 1) / 2;
+
+    u64 sum = 0;
+    ExpectToBeTrue(ParallelReduce(ITEM_COUNT, 0, sizeof(u64), &identity, SumRange, CombineSums, &sum, 0));
+    ExpectShouldBe(expected, sum);
+
+    // The result's starting value is kept.
+    sum = 10;
+    ExpectToBeTrue(ParallelReduce(ITEM_COUNT, 333, sizeof(u64), &identity, SumRange, CombineSums, &sum, 0));
+    u64 expectedWithStart = expected + 10;
+    ExpectShouldBe(expectedWithStart, sum);
+
+    TDEBUG("The following error is intentionally caused by this test.");
+    u8 tooLarge[PARALLEL_REDUCE_MAX_RESULT_SIZE + 1] = {0};
+    ExpectToBeFalse(ParallelReduce(ITEM_COUNT, 0, sizeof(tooLarge), tooLarge, SumRange, CombineSums, tooLarge, 0));
+
+    TestSystemsStopJobSystem(&jobSystem);
+    return true;
+}
+
+void ParallelRegisterTests()
+{
+    TestManagerRegisterTest(ParallelForShouldVisitEveryItemOnce, "ParallelFor should visit every item exactly once");
+    TestManagerRegisterTest(ParallelForShouldTransformMatrices, "ParallelFor should transform a batch of matrices");
+    TestManagerRegisterTest(ParallelReduceShouldCombinePartials, "ParallelReduce should combine partial results");
+}
\ No newline at end of file
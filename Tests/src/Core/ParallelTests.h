@@ -0,0 +1,3 @@
+#pragma once
+
+void ParallelRegisterTests();
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include "ProfilerTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include "../TestSystems.h"
+#include <Core/Profiler.h>
+#include <Core/TMemory.h>
+#include <Core/TString.h>
+#include <Platform/Platform.h>
+#include <Platform/Filesystem.h>
+#include <Defines.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_PATH "profiler_test_trace.json"
+#define RECORDING_THREAD_COUNT 4
+#define ZONES_PER_THREAD 100
+
+// Reads the whole trace back, and counts how often a string appears in it.
+static u32 CountInTrace(const char* text)
+{
+    file_handle file;
+    if (!FilesystemOpen(TRACE_PATH, FILE_MODE_READ, true, &file)) return 0;
+
+    u8* bytes = 0;
+    u64 size = 0;
+    FilesystemReadAllBytes(&file, &bytes, &size);
+    FilesystemClose(&file);
+
+    u32 count = 0;
+    u64 textLength = StringLength(text);
+    for (u64 i = 0; i + textLength <= size; i++)
+    {
+        if (memcmp(bytes + i, text, textLength) == 0) count++;
+    }
+    TFree(bytes, size, MEMORY_TAG_STRING);
+    return count;
+}
+
+static void RecordNested()
+{
+    TPROFILE_SCOPE("Outer");
+    {
+        TPROFILE_SCOPE("Inner");
+    }
+}
+
+static u32 RecordZones(void* params)
+{
+    ProfilerSetThreadName("Recorder");
+    for (u32 i = 0; i < ZONES_PER_THREAD; i++)
+    {
+        RecordNested();
+    }
+    return 0;
+}
+
+u8 ProfilerShouldWriteZonesFromEveryThread()
+{
+    test_system profiler = {0};
+    b8 started = TestSystemsStart(&profiler, ProfilerInitialize, MEMORY_TAG_PROFILER);
+    ExpectToBeTrue(started);
+
+    platform_thread threads[RECORDING_THREAD_COUNT];
+    for (u32 i = 0; i < RECORDING_THREAD_COUNT; i++)
+    {
+        ExpectToBeTrue(PlatformThreadCreate(RecordZones, 0, &threads[i]));
+    }
+    for (u32 i = 0; i < RECORDING_THREAD_COUNT; i++)
+    {
+        PlatformThreadJoin(&threads[i]);
+    }
+
+    // Paused zones are left out.
+    ProfilerSetEnabled(false);
+    RecordNested();
+    ProfilerSetEnabled(true);
+
+    ExpectToBeTrue(ProfilerWriteChromeTrace(TRACE_PATH));
+    u32 expectedZones = RECORDING_THREAD_COUNT * ZONES_PER_THREAD;
+    u32 outerCount = CountInTrace("\"name\":\"Outer\"");
+    u32 innerCount = CountInTrace("\"name\":\"Inner\"");
+    u32 threadNameCount = CountInTrace("\"name\":\"Recorder\"");
+    ExpectShouldBe(expectedZones, outerCount);
+    ExpectShouldBe(expectedZones, innerCount);
+    ExpectShouldBe(RECORDING_THREAD_COUNT, threadNameCount);
+    ExpectShouldBe(1, CountInTrace("]}"));
+
+    remove(TRACE_PATH);
+    TestSystemsStop(&profiler, ProfilerShutdown);
+    return true;
+}
+
+u8 ProfilerShouldKeepOnlyTheLatestZones()
+{
+    test_system profiler = {0};
+    b8 started = TestSystemsStart(&profiler, ProfilerInitialize, MEMORY_TAG_PROFILER);
+    ExpectToBeTrue(started);
+
+    // Overfill the ring, naming the last zones differently to check those are the ones kept.
+    u32 total = PROFILER_ZONES_PER_THREAD + 1000;
+    for (u32 i = 0; i < total; i++)
+    {
+        profile_zone zone = ProfilerZoneBegin(i < total - 10 ? "Old" : "New");
+        ProfilerZoneEnd(&zone);
+    }
+
+    ExpectToBeTrue(ProfilerWriteChromeTrace(TRACE_PATH));
+    u32 newCount = CountInTrace("\"name\":\"New\"");
+    u32 oldCount = CountInTrace("\"name\":\"Old\"");
+    ExpectShouldBe(10, newCount);
+    ExpectShouldBe(PROFILER_ZONES_PER_THREAD - 10, oldCount);
+
+    remove(TRACE_PATH);
+    TestSystemsStop(&profiler, ProfilerShutdown);
+
+    // Zones after shutdown are ignored, rather than written to freed memory.
+    RecordNested();
+    return true;
+}
+
+void ProfilerRegisterTests()
+{
+    TestManagerRegisterTest(ProfilerShouldWriteZonesFromEveryThread, "Profiler should write zones from every thread as a Chrome trace.");
+    TestManagerRegisterTest(ProfilerShouldKeepOnlyTheLatestZones, "Profiler should keep only the latest zones of each thread.");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void ProfilerRegisterTests();
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void SortRegisterTests();
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "TaskGraphTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include "../TestSystems.h"
+#include <Core/TaskGraph.h>
+#include <Core/TMemory.h>
+#include <Platform/Platform.h>
+#include <Platform/Atomic.h>
+#include <Defines.h>
+
+#define FRAME_COUNT 50
+
+typedef struct graph_test
+{
+    test_system jobSystem;
+    test_system taskGraph;
+} graph_test;
+
+static b8 StartGraph(graph_test* test, u32 workerCount)
+{
+    if (!TestSystemsStartJobSystem(&test->jobSystem, workerCount)) return false;
+
+    return TestSystemsStart(&test->taskGraph, TaskGraphInitialize, MEMORY_TAG_JOB);
+}
+
+static void StopGraph(graph_test* test)
+{
+    TestSystemsStop(&test->taskGraph, TaskGraphShutdown);
+    TestSystemsStopJobSystem(&test->jobSystem);
+}
+
+typedef struct order_state
+{
+    // Bumped by each task as it runs, to give the order they ran in.
+    u32 sequence;
+    u32 ranAt[4];
+    u32 misorderCount;
+} order_state;
+
+typedef struct order_task
+{
+    order_state* state;
+    u32 index;
+} order_task;
+
+static b8 RecordOrderTask(void* userData, const task_frame* frame)
+{
+    order_task* task = userData;
+    task->state->ranAt[task->index] = AtomicFetchAdd32(&task->state->sequence, 1, ATOMIC_RELAXED);
+    return true;
+}
+
+u8 TaskGraphShouldOrderConflictingTasks()
+{
+    graph_test test = {0};
+    ExpectToBeTrue(StartGraph(&test, 4));
+
+    u64 data = TaskGraphResource("data");
+    u64 other = TaskGraphResource("other");
+    ExpectShouldBe(data, TaskGraphResource("data"));
+    ExpectShouldNotBe(data, other);
+
+    // A writes; B and C read, so may run together; D writes again, so waits for both.
+    order_state state = {0};
+    order_task params[4];
+    task_desc descs[4] = {
+        {"A", RecordOrderTask, &params[0], 0, data, false},
+        {"B", RecordOrderTask, &params[1], data, other, false},
+        {"C", RecordOrderTask, &params[2], data, 0, true},
+        {"D", RecordOrderTask, &params[3], 0, data, false}};
+    for (u32 i = 0; i < 4; i++)
+    {
+        params[i].state = &state;
+        params[i].index = i;
+        ExpectToBeTrue(TaskGraphAddTask(&descs[i]));
+    }
+
+    for (u32 f = 0; f < FRAME_COUNT; f++)
+    {
+        u32 frameStart = state.sequence;
+        u64 frameNumber = TaskGraphKickFrame(1.0 / 60.0);
+        ExpectShouldBe(f, frameNumber);
+        ExpectToBeTrue(TaskGraphWaitFrame(frameNumber));
+
+        b8 ordered = state.ranAt[0] == frameStart && state.ranAt[1] > state.ranAt[0] && state.ranAt[2] > state.ranAt[0] &&
+                     state.ranAt[3] > state.ranAt[1] && state.ranAt[3] > state.ranAt[2];
+        ExpectToBeTrue(ordered);
+    }
+
+    u32 timingCount = 0;
+    const task_timing* timings = TaskGraphGetTimings(&timingCount);
+    ExpectShouldBe(4, timingCount);
+    ExpectToBeTrue(timings[2].name == descs[2].name);
+    // C must stay on the main thread.
+    ExpectShouldBe(0, timings[2].workerIndex);
+    ExpectToBeTrue(timings[3].start >= timings[0].start);
+    ExpectToBeTrue(timings[0].duration >= 0.0);
+
+    StopGraph(&test);
+    return true;
+}
+
+typedef struct pipeline_state
+{
+    // The last frame simulated.
+    u64 simulatedFrame;
+    u32 overlapCount;
+    // Set once the last frame is kicked, since no simulation will follow its present.
+    u32 lastFrameKicked;
+} pipeline_state;
+
+static b8 SimulateTask(void* userData, const task_frame* frame)
+{
+    pipeline_state* state = userData;
+    AtomicStore64(&state->simulatedFrame, frame->frameNumber, ATOMIC_RELEASE);
+    return true;
+}
+
+static b8 SubmitTask(void* userData, const task_frame* frame)
+{
+    return true;
+}
+
+// Stands in for handing a frame to the GPU: waits, for a while, to see the next frame's simulation run alongside it.
+static b8 PresentTask(void* userData, const task_frame* frame)
+{
+    pipeline_state* state = userData;
+    f64 deadline = PlatformGetAbsoluteTime() + 2.0;
+    while (PlatformGetAbsoluteTime() < deadline)
+    {
+        if (AtomicLoad64(&state->simulatedFrame, ATOMIC_ACQUIRE) > frame->frameNumber)
+        {
+            state->overlapCount++;
+            return true;
+        }
+        if (AtomicLoad32(&state->lastFrameKicked, ATOMIC_ACQUIRE)) return true;
+        PlatformThreadYield();
+    }
+    return true;
+}
+
+u8 TaskGraphShouldOverlapFrames()
+{
+    graph_test test = {0};
+    ExpectToBeTrue(StartGraph(&test, 2));
+
+    u64 world = TaskGraphResource("world");
+    u64 renderData = TaskGraphResource("render_data");
+    u64 gpu = TaskGraphResource("gpu");
+
+    pipeline_state state = {0};
+    task_desc descs[3] = {
+        {"Simulate", SimulateTask, &state, 0, world, false},
+        {"Submit", SubmitTask, &state, world, renderData, false},
+        {"Present", PresentTask, &state, renderData, gpu, true}};
+    for (u32 i = 0; i < 3; i++)
+    {
+        ExpectToBeTrue(TaskGraphAddTask(&descs[i]));
+    }
+
+    // Kick each frame before waiting on the one before, as the main loop does.
+    u64 previous = TaskGraphKickFrame(0.0);
+    TDEBUG("The following error is intentionally caused by this test.");
+    ExpectToBeFalse(TaskGraphAddTask(&descs[0]));
+    for (u32 f = 1; f < 10; f++)
+    {
+        u64 current = TaskGraphKickFrame(0.0);
+        ExpectToBeTrue(TaskGraphWaitFrame(previous));
+        previous = current;
+    }
+    AtomicStore32(&state.lastFrameKicked, true, ATOMIC_RELEASE);
+    ExpectToBeTrue(TaskGraphWaitFrame(previous));
+
+    // Every frame but the last had the next one's simulation run while it presented.
+    ExpectShouldBe(9, state.overlapCount);
+
+    StopGraph(&test);
+    return true;
+}
+
+static b8 FailingTask(void* userData, const task_frame* frame)
+{
+    u32* runCount = userData;
+    (*runCount)++;
+    return frame->frameNumber != 1;
+}
+
+u8 TaskGraphShouldReportFailedFrames()
+{
+    graph_test test = {0};
+    ExpectToBeTrue(StartGraph(&test, 2));
+
+    u32 runCount = 0;
+    task_desc desc = {"Failing", FailingTask, &runCount, 0, TaskGraphResource("state"), false};
+    ExpectToBeTrue(TaskGraphAddTask(&desc));
+
+    ExpectToBeTrue(TaskGraphWaitFrame(TaskGraphKickFrame(0.0)));
+    TDEBUG("The following error is intentionally caused by this test.");
+    ExpectToBeFalse(TaskGraphWaitFrame(TaskGraphKickFrame(0.0)));
+    ExpectToBeTrue(TaskGraphWaitFrame(TaskGraphKickFrame(0.0)));
+    ExpectShouldBe(3, runCount);
+
+    StopGraph(&test);
+    return true;
+}
+
+void TaskGraphRegisterTests()
+{
+    TestManagerRegisterTest(TaskGraphShouldOrderConflictingTasks, "Task graph should order conflicting tasks and report timings");
+    TestManagerRegisterTest(TaskGraphShouldOverlapFrames, "Task graph should overlap independent work across frames");
+    TestManagerRegisterTest(TaskGraphShouldReportFailedFrames, "Task graph should report failed frames");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void TaskGraphRegisterTests();
\ No newline at end of file
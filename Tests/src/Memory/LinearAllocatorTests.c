@@ -116,6 +116,26 @@ u8 LinearAllocatorMultiAllocationAllSpaceThenFree()
     return true;
 }
 
+u8 LinearAllocatorResetShouldKeepMemory()
+{
+    linear_allocator alloc;
+    LinearAllocatorCreate(sizeof(u64) * 4, 0, &alloc);
+
+    u64* first = LinearAllocatorAllocate(&alloc, sizeof(u64));
+    *first = 42;
+
+    // The next allocation reuses the same memory, still as it was left.
+    LinearAllocatorReset(&alloc);
+    ExpectShouldBe(0, alloc.allocated);
+    u64* again = LinearAllocatorAllocate(&alloc, sizeof(u64));
+    ExpectShouldBe(first, again);
+    ExpectShouldBe(42, *again);
+
+    LinearAllocatorDestroy(&alloc);
+
+    return true;
+}
+
 void LinearAllocatorRegisterTests()
 {
     TestManagerRegisterTest(LinearAllocatorShouldCreateAndDestroy, "Linear allocator should create and destroy");
@@ -123,4 +143,5 @@ void LinearAllocatorRegisterTests()
     TestManagerRegisterTest(LinearAllocatorMultiAllocationAllSpace, "Linear allocator multi alloc for all space");
     TestManagerRegisterTest(LinearAllocatorMultiAllocationOverAllocate, "Linear allocator try over allocate");
     TestManagerRegisterTest(LinearAllocatorMultiAllocationAllSpaceThenFree, "Linear allocator allocated should be 0 after FreeAll");
+    TestManagerRegisterTest(LinearAllocatorResetShouldKeepMemory, "Linear allocator reset should free everything without clearing it");
 }
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "ThreadingTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include <Platform/Platform.h>
+#include <Platform/Atomic.h>
+#include <Defines.h>
+
+#define THREAD_COUNT 4
+#define INCREMENTS_PER_THREAD 100000
+
+typedef struct counter_test
+{
+    platform_mutex mutex;
+    u64 lockedCounter;
+    u64 atomicCounter;
+} counter_test;
+
+static u32 IncrementCounters(void* params)
+{
+    counter_test* test = params;
+    for (u32 i = 0; i < INCREMENTS_PER_THREAD; i++)
+    {
+        PlatformMutexLock(&test->mutex);
+        test->lockedCounter++;
+        PlatformMutexUnlock(&test->mutex);
+
+        AtomicFetchAdd64(&test->atomicCounter, 1, ATOMIC_RELAXED);
+    }
+    return 0;
+}
+
+u8 ThreadingMutexAndAtomicsShouldNotLoseIncrements()
+{
+    counter_test test = {0};
+    ExpectToBeTrue(PlatformMutexCreate(&test.mutex));
+
+    platform_thread threads[THREAD_COUNT];
+    for (u32 i = 0; i < THREAD_COUNT; i++)
+    {
+        ExpectToBeTrue(PlatformThreadCreate(IncrementCounters, &test, &threads[i]));
+        ExpectShouldNotBe(0, threads[i].internalData);
+    }
+    for (u32 i = 0; i < THREAD_COUNT; i++)
+    {
+        PlatformThreadJoin(&threads[i]);
+    }
+
+    u64 expected = THREAD_COUNT * INCREMENTS_PER_THREAD;
+    ExpectShouldBe(expected, test.lockedCounter);
+    ExpectShouldBe(expected, test.atomicCounter);
+
+    PlatformMutexDestroy(&test.mutex);
+    ExpectShouldBe(0, test.mutex.internalData);
+    return true;
+}
+
+u8 ThreadingAtomicsShouldCompareExchange()
+{
+    u32 value32 = 5;
+    u32 expected32 = 4;
+    ExpectToBeFalse(AtomicCompareExchange32(&value32, &expected32, 10, ATOMIC_ACQ_REL, ATOMIC_ACQUIRE));
+    // On failure, expected receives the current value.
+    ExpectShouldBe(5, expected32);
+    ExpectToBeTrue(AtomicCompareExchange32(&value32, &expected32, 10, ATOMIC_ACQ_REL, ATOMIC_ACQUIRE));
+    ExpectShouldBe(10, AtomicLoad32(&value32, ATOMIC_ACQUIRE));
+
+    u64 value64 = 0;
+    ExpectShouldBe(0, AtomicFetchAdd64(&value64, 3, ATOMIC_SEQ_CST));
+    ExpectShouldBe(3, AtomicExchange64(&value64, 7, ATOMIC_SEQ_CST));
+    ExpectShouldBe(7, AtomicFetchSub64(&value64, 2, ATOMIC_SEQ_CST));
+    ExpectShouldBe(5, AtomicLoad64(&value64, ATOMIC_RELAXED));
+
+    void* pointer = 0;
+    void* expectedPointer = 0;
+    ExpectToBeTrue(AtomicCompareExchangePtr(&pointer, &expectedPointer, &value64, ATOMIC_ACQ_REL, ATOMIC_ACQUIRE));
+    ExpectShouldBe(&value64, AtomicLoadPtr(&pointer, ATOMIC_ACQUIRE));
+    return true;
+}
+
+typedef struct semaphore_test
+{
+    platform_semaphore request;
+    platform_semaphore response;
+    u32 value;
+} semaphore_test;
+
+static u32 AnswerRequests(void* params)
+{
+    semaphore_test* test = params;
+    for (u32 i = 0; i < 100; i++)
+    {
+        PlatformSemaphoreWait(&test->request, PLATFORM_WAIT_INFINITE);
+        test->value++;
+        PlatformSemaphoreSignal(&test->response, 1);
+    }
+    return 0;
+}
+
+u8 ThreadingSemaphoresShouldHandOffBetweenThreads()
+{
+    semaphore_test test = {0};
+    ExpectToBeTrue(PlatformSemaphoreCreate(0, &test.request));
+    ExpectToBeTrue(PlatformSemaphoreCreate(0, &test.response));
+
+    // Nothing signalled yet, so a timed wait has to time out.
+    ExpectToBeFalse(PlatformSemaphoreWait(&test.response, 0));
+    ExpectToBeFalse(PlatformSemaphoreWait(&test.response, 10));
+
+    platform_thread thread;
+    PlatformThreadCreate(AnswerRequests, &test, &thread);
+    for (u32 i = 0; i < 100; i++)
+    {
+        PlatformSemaphoreSignal(&test.request, 1);
+        ExpectToBeTrue(PlatformSemaphoreWait(&test.response, PLATFORM_WAIT_INFINITE));
+        ExpectShouldBe(i + 1, test.value);
+    }
+    PlatformThreadJoin(&thread);
+
+    PlatformSemaphoreDestroy(&test.request);
+    PlatformSemaphoreDestroy(&test.response);
+    return true;
+}
+
+typedef struct condvar_test
+{
+    platform_mutex mutex;
+    platform_condvar condvar;
+    b8 isReady;
+    u32 wokenCount;
+} condvar_test;
+
+static u32 WaitUntilReady(void* params)
+{
+    condvar_test* test = params;
+    PlatformMutexLock(&test->mutex);
+    while (!test->isReady)
+    {
+        PlatformCondvarWait(&test->condvar, &test->mutex, PLATFORM_WAIT_INFINITE);
+    }
+    test->wokenCount++;
+    PlatformMutexUnlock(&test->mutex);
+    return 0;
+}
+
+u8 ThreadingCondvarShouldWakeAllWaiters()
+{
+    condvar_test test = {0};
+    PlatformMutexCreate(&test.mutex);
+    ExpectToBeTrue(PlatformCondvarCreate(&test.condvar));
+
+    // A wait with nobody signalling has to time out.
+    PlatformMutexLock(&test.mutex);
+    ExpectToBeFalse(PlatformCondvarWait(&test.condvar, &test.mutex, 10));
+    PlatformMutexUnlock(&test.mutex);
+
+    platform_thread threads[THREAD_COUNT];
+    for (u32 i = 0; i < THREAD_COUNT; i++)
+    {
+        PlatformThreadCreate(WaitUntilReady, &test, &threads[i]);
+    }
+
+    PlatformMutexLock(&test.mutex);
+    test.isReady = true;
+    PlatformCondvarBroadcast(&test.condvar);
+    PlatformMutexUnlock(&test.mutex);
+
+    for (u32 i = 0; i < THREAD_COUNT; i++)
+    {
+        PlatformThreadJoin(&threads[i]);
+    }
+    ExpectShouldBe(THREAD_COUNT, test.wokenCount);
+
+    PlatformCondvarDestroy(&test.condvar);
+    PlatformMutexDestroy(&test.mutex);
+    return true;
+}
+
+u8 ThreadingShouldReportProcessorCount()
+{
+    u32 count = PlatformGetProcessorCount();
+    ExpectToBeTrue(count >= 1);
+    ExpectShouldNotBe(0, PlatformThreadGetCurrentId());
+    return true;
+}
+
+u8 ThreadingSleepShouldLastAtLeastTheRequestedTime()
+{
+    // Only a lower bound is checked; how late the OS wakes the thread depends on the machine.
+    u64 start = PlatformGetTimestampNs();
+    PlatformSleepNs(2000000);
+    u64 elapsed = PlatformGetTimestampNs() - start;
+    ExpectToBeTrue(elapsed >= 2000000);
+
+    u64 later = PlatformGetTimestampNs();
+    ExpectToBeTrue(later >= start + elapsed);
+    return true;
+}
+
+void ThreadingRegisterTests()
+{
+    TestManagerRegisterTest(ThreadingMutexAndAtomicsShouldNotLoseIncrements, "Mutexes and atomics should not lose increments across threads");
+    TestManagerRegisterTest(ThreadingAtomicsShouldCompareExchange, "Atomics should compare-exchange, exchange and fetch-add");
+    TestManagerRegisterTest(ThreadingSemaphoresShouldHandOffBetweenThreads, "Semaphores should hand off between threads and time out");
+    TestManagerRegisterTest(ThreadingCondvarShouldWakeAllWaiters, "Condition variables should wake all waiters and time out");
+    TestManagerRegisterTest(ThreadingShouldReportProcessorCount, "Platform should report processor count and thread id");
+    TestManagerRegisterTest(ThreadingSleepShouldLastAtLeastTheRequestedTime, "Nanosecond sleeps should last at least as long as requested");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void ThreadingRegisterTests();
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "NullRendererTests.h"
+#include "../TestManager.h"
+#include "../Expect.h"
+#include "../TestSystems.h"
+#include <Renderer/RendererFrontEnd.h>
+#include <Renderer/Null/NullBackEnd.h>
+#include <Core/TMemory.h>
+#include <Math/TMath.h>
+#include <Defines.h>
+
+// Starts the renderer with the null backend, which needs no window or GPU.
+static b8 InitializeNullRenderer(u64* memoryRequirement, void* state)
+{
+    return RendererSystemInitialize(memoryRequirement, state, "Null renderer test", RENDERER_BACKEND_TYPE_NULL, false);
+}
+
+u8 NullRendererShouldCountFrameWork()
+{
+    test_system renderer = {0};
+    b8 started = TestSystemsStart(&renderer, InitializeNullRenderer, MEMORY_TAG_RENDERER);
+    ExpectToBeTrue(started);
+
+    // Each frame draws one more object than the last.
+    for (u32 i = 0; i < 3; i++)
+    {
+        for (u32 j = 0; j <= i; j++)
+        {
+            b8 submitted = RendererSubmitDraw(RENDERER_GEOMETRY_TEST_QUAD, 0, false, mat4_identity());
+            ExpectToBeTrue(submitted);
+        }
+
+        render_packet packet;
+        RendererBuildPacket(0.0f, &packet);
+        ExpectShouldBe(i + 1, packet.drawCount);
+        b8 drawn = RendererDrawFrame(&packet);
+        ExpectToBeTrue(drawn);
+    }
+
+    null_renderer_stats stats;
+    NullRendererGetStats(&stats);
+    ExpectShouldBe(1, stats.initializeCalls);
+    ExpectShouldBe(3, stats.beginFrameCalls);
+    ExpectShouldBe(3, stats.endFrameCalls);
+    ExpectShouldBe(3, stats.updateGlobalStateCalls);
+    ExpectShouldBe(3, stats.frameCount);
+    ExpectShouldBe(3, stats.drawListCalls);
+    ExpectShouldBe(6, stats.drawCount);
+    ExpectShouldBe(3, stats.lastFrameDrawCount);
+    ExpectShouldBe(1, stats.lastFrameBatchCount);
+    u64 expectedBytes = 3 * sizeof(global_uniform_object) + 6 * sizeof(mat4);
+    ExpectShouldBe(expectedBytes, stats.uniformBytesUploaded);
+
+    TestSystemsStop(&renderer, RendererSystemShutdown);
+    NullRendererGetStats(&stats);
+    ExpectShouldBe(1, stats.shutdownCalls);
+    return true;
+}
+
+// Submits the test quad at a distance in front of the default camera.
+static void SubmitAtDistance(u32 material, b8 transparent, f32 distance)
+{
+    mat4 model = mat4_translation((vec3){0, 0, 30.0f - distance});
+    RendererSubmitDraw(RENDERER_GEOMETRY_TEST_QUAD, material, transparent, model);
+}
+
+// The draw the packet has drawn at position i.
+static const render_draw* SortedDraw(const render_packet* packet, u32 i)
+{
+    return &packet->draws[packet->drawOrder[i]];
+}
+
+u8 NullRendererShouldSortDraws()
+{
+    test_system renderer = {0};
+    b8 started = TestSystemsStart(&renderer, InitializeNullRenderer, MEMORY_TAG_RENDERER);
+    ExpectToBeTrue(started);
+
+    // Submitted in an order which is wrong every way.
+    SubmitAtDistance(0, true, 10.0f);
+    SubmitAtDistance(0, true, 50.0f);
+    SubmitAtDistance(1, false, 5.0f);
+    SubmitAtDistance(0, false, 50.0f);
+    SubmitAtDistance(0, false, 10.0f);
+
+    render_packet packet;
+    RendererBuildPacket(0.0f, &packet);
+    ExpectShouldBe(5, packet.drawCount);
+
+    // The draws stay where they were submitted; only their order is sorted.
+    ExpectShouldBe(4, packet.drawOrder[0]);
+
+    // Opaque by material, then front-to-back.
+    ExpectShouldBe(0, SortedDraw(&packet, 0)->material);
+    ExpectFloatToBe(20.0f, SortedDraw(&packet, 0)->model.data[14]);
+    ExpectShouldBe(0, SortedDraw(&packet, 1)->material);
+    ExpectFloatToBe(-20.0f, SortedDraw(&packet, 1)->model.data[14]);
+    ExpectShouldBe(1, SortedDraw(&packet, 2)->material);
+
+    // Then transparent, back-to-front.
+    ExpectToBeTrue(SortedDraw(&packet, 3)->transparent);
+    ExpectFloatToBe(-20.0f, SortedDraw(&packet, 3)->model.data[14]);
+    ExpectToBeTrue(SortedDraw(&packet, 4)->transparent);
+    ExpectFloatToBe(20.0f, SortedDraw(&packet, 4)->model.data[14]);
+
+    for (u32 i = 1; i < packet.drawCount; i++)
+    {
+        b8 ascending = SortedDraw(&packet, i - 1)->sortKey <= SortedDraw(&packet, i)->sortKey;
+        ExpectToBeTrue(ascending);
+    }
+
+    b8 drawn = RendererDrawFrame(&packet);
+    ExpectToBeTrue(drawn);
+
+    TestSystemsStop(&renderer, RendererSystemShutdown);
+    return true;
+}
+
+u8 NullRendererShouldBatchRepeatedDraws()
+{
+    test_system renderer = {0};
+    b8 started = TestSystemsStart(&renderer, InitializeNullRenderer, MEMORY_TAG_RENDERER);
+    ExpectToBeTrue(started);
+
+    // Many copies of the same quad, but for one in another material, all opaque: two batches.
+    for (u32 i = 0; i < 1000; i++)
+    {
+        SubmitAtDistance(0, false, (f32)(i % 100));
+    }
+    SubmitAtDistance(1, false, 1.0f);
+
+    // Transparent quads between which others of the same material are nearer or farther
+    // must stay in depth order, so cannot be batched with each other.
+    SubmitAtDistance(0, true, 10.0f);
+    SubmitAtDistance(1, true, 20.0f);
+    SubmitAtDistance(0, true, 30.0f);
+
+    render_packet packet;
+    RendererBuildPacket(0.0f, &packet);
+    b8 drawn = RendererDrawFrame(&packet);
+    ExpectToBeTrue(drawn);
+
+    null_renderer_stats stats;
+    NullRendererGetStats(&stats);
+    ExpectShouldBe(1004, stats.lastFrameDrawCount);
+    ExpectShouldBe(5, stats.lastFrameBatchCount);
+
+    TestSystemsStop(&renderer, RendererSystemShutdown);
+    return true;
+}
+
+u8 NullRendererShouldDrawMoreThan64kDraws()
+{
+    test_system renderer = {0};
+    b8 started = TestSystemsStart(&renderer, InitializeNullRenderer, MEMORY_TAG_RENDERER);
+    ExpectToBeTrue(started);
+
+    // More draws than the Vulkan backend makes room for to start with, so its buffers have to grow.
+    const u32 drawCount = 70000;
+    for (u32 i = 0; i < drawCount; i++)
+    {
+        SubmitAtDistance(i % 2, false, (f32)(i % 50));
+    }
+
+    render_packet packet;
+    RendererBuildPacket(0.0f, &packet);
+    ExpectShouldBe(drawCount, packet.drawCount);
+
+    // None are cut off the end: the last draw is still the last in material order.
+    const render_draw* last = SortedDraw(&packet, drawCount - 1);
+    ExpectShouldBe(1, last->material);
+
+    b8 drawn = RendererDrawFrame(&packet);
+    ExpectToBeTrue(drawn);
+
+    null_renderer_stats stats;
+    NullRendererGetStats(&stats);
+    ExpectShouldBe(drawCount, stats.lastFrameDrawCount);
+    ExpectShouldBe(2, stats.lastFrameBatchCount);
+    u64 expectedBytes = sizeof(global_uniform_object) + drawCount * sizeof(mat4);
+    ExpectShouldBe(expectedBytes, stats.uniformBytesUploaded);
+
+    TestSystemsStop(&renderer, RendererSystemShutdown);
+    return true;
+}
+
+u8 NullRendererShouldTrackTexturesAndReadBlankFrames()
+{
+    test_system renderer = {0};
+    b8 started = TestSystemsStart(&renderer, InitializeNullRenderer, MEMORY_TAG_RENDERER);
+    ExpectToBeTrue(started);
+
+    u8 pixels[4 * 2 * 4];
+    TSetMemory(pixels, 0xFF, sizeof(pixels));
+    texture tex = {0};
+    RendererCreateTexture("test", false, 4, 2, 4, pixels, false, &tex);
+    ExpectShouldBe(4, tex.width);
+    ExpectShouldBe(2, tex.height);
+
+    null_renderer_stats stats;
+    NullRendererGetStats(&stats);
+    ExpectShouldBe(1, stats.liveTextureCount);
+    ExpectShouldBe(sizeof(pixels), stats.textureBytesUploaded);
+
+    RendererDestroyTexture(&tex);
+    NullRendererGetStats(&stats);
+    ExpectShouldBe(0, stats.liveTextureCount);
+    ExpectShouldBe(1, stats.destroyTextureCalls);
+
+    // Frames are the size last resized to, and blank.
+    RendererOnResized(4, 2);
+    u32 width = 0;
+    u32 height = 0;
+    b8 read = RendererReadFrame(&width, &height, pixels);
+    ExpectToBeTrue(read);
+    ExpectShouldBe(4, width);
+    ExpectShouldBe(2, height);
+    for (u32 i = 0; i < sizeof(pixels); i++)
+    {
+        ExpectShouldBe(0, pixels[i]);
+    }
+
+    TestSystemsStop(&renderer, RendererSystemShutdown);
+    return true;
+}
+
+void NullRendererRegisterTests()
+{
+    TestManagerRegisterTest(NullRendererShouldCountFrameWork, "Null renderer should count the work of each frame.");
+    TestManagerRegisterTest(NullRendererShouldSortDraws, "Null renderer should be handed draws sorted by state and depth.");
+    TestManagerRegisterTest(NullRendererShouldBatchRepeatedDraws, "Null renderer should batch repeated draws, except where depth order forbids.");
+    TestManagerRegisterTest(NullRendererShouldDrawMoreThan64kDraws, "Null renderer should draw every one of more than 64k draws.");
+    TestManagerRegisterTest(NullRendererShouldTrackTexturesAndReadBlankFrames, "Null renderer should track textures and read back blank frames.");
+}
\ No newline at end of file
@@ -0,0 +1,3 @@
+#pragma once
+
+void NullRendererRegisterTests();
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "TestSystems.h"
+#include <Core/JobSystem.h>
+#include <Core/TMemory.h>
+
+b8 TestSystemsStart(test_system* system, PFN_test_system_initialize initialize, memory_tag tag)
+{
+    initialize(&system->memoryRequirement, 0);
+    system->state = TAllocate(system->memoryRequirement, tag);
+    system->tag = tag;
+    return initialize(&system->memoryRequirement, system->state);
+}
+
+void TestSystemsStartVoid(test_system* system, PFN_test_system_initialize_void initialize, memory_tag tag)
+{
+    initialize(&system->memoryRequirement, 0);
+    system->state = TAllocate(system->memoryRequirement, tag);
+    system->tag = tag;
+    initialize(&system->memoryRequirement, system->state);
+}
+
+void TestSystemsStop(test_system* system, PFN_test_system_shutdown shutdown)
+{
+    shutdown(system->state);
+    TFree(system->state, system->memoryRequirement, system->tag);
+    system->state = 0;
+}
+
+b8 TestSystemsStartJobSystem(test_system* system, u32 workerCount)
+{
+    JobSystemInitialize(&system->memoryRequirement, 0, workerCount);
+    system->state = TAllocate(system->memoryRequirement, MEMORY_TAG_JOB);
+    system->tag = MEMORY_TAG_JOB;
+    if (!JobSystemInitialize(&system->memoryRequirement, system->state, workerCount))
+    {
+        TFree(system->state, system->memoryRequirement, system->tag);
+        system->state = 0;
+        return false;
+    }
+    return true;
+}
+
+void TestSystemsStopJobSystem(test_system* system)
+{
+    TestSystemsStop(system, JobSystemShutdown);
+}
\ No newline at end of file
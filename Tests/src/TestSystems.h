@@ -0,0 +1,67 @@
+#pragma once
+#include <Defines.h>
+#include <Core/TMemory.h>
+
+/*
+Starts engine subsystems for tests the way the application does: asking each
+how much memory it needs, then starting it in memory of its own.
+*/
+
+// A subsystem started for a test, and the memory it was started in.
+typedef struct test_system
+{
+    u64 memoryRequirement;
+    void* state;
+    // What the memory is counted against.
+    memory_tag tag;
+} test_system;
+
+// Takes the same arguments as the subsystems' own initialize functions.
+typedef b8 (*PFN_test_system_initialize)(u64* memoryRequirement, void* state);
+// For the subsystems whose initialize cannot fail, so returns nothing.
+typedef void (*PFN_test_system_initialize_void)(u64* memoryRequirement, void* state);
+typedef void (*PFN_test_system_shutdown)(void* state);
+
+/**
+ * @brief Starts a subsystem: calls initialize for the memory it needs, allocates it,
+ * then calls initialize again with the memory.
+ *
+ * @param system Holds the subsystem's memory until it is stopped.
+ * @param initialize The subsystem's initialize function.
+ * @param tag What the subsystem's memory is counted against.
+ * @return b8 What initialize returned when given the memory.
+ */
+b8 TestSystemsStart(test_system* system, PFN_test_system_initialize initialize, memory_tag tag);
+
+/**
+ * @brief Starts a subsystem whose initialize returns nothing, like TestSystemsStart.
+ *
+ * @param system Holds the subsystem's memory until it is stopped.
+ * @param initialize The subsystem's initialize function.
+ * @param tag What the subsystem's memory is counted against.
+ */
+void TestSystemsStartVoid(test_system* system, PFN_test_system_initialize_void initialize, memory_tag tag);
+
+/**
+ * @brief Stops a subsystem started by TestSystemsStart or TestSystemsStartVoid, and frees its memory.
+ *
+ * @param system The subsystem to stop.
+ * @param shutdown The subsystem's shutdown function.
+ */
+void TestSystemsStop(test_system* system, PFN_test_system_shutdown shutdown);
+
+/**
+ * @brief Starts the job system.
+ *
+ * @param system Holds the job system's memory until it is stopped. Left empty if starting fails.
+ * @param workerCount The number of workers including the main thread, or 0 for one per physical core.
+ * @return b8 True if the job system started.
+ */
+b8 TestSystemsStartJobSystem(test_system* system, u32 workerCount);
+
+/**
+ * @brief Stops the job system, joining its workers, and frees its memory.
+ *
+ * @param system The job system started by TestSystemsStartJobSystem.
+ */
+void TestSystemsStopJobSystem(test_system* system);
\ No newline at end of file
@@ -1,5 +1,17 @@
 #include "TestManager.h"
 #include "Memory/LinearAllocatorTests.h"
+#include "Core/HashTests.h"
+#include "Core/SortTests.h"
+#include "Containers/RingQueueTests.h"
+#include "Core/LoggerTests.h"
+#include "Platform/ThreadingTests.h"
+#include "Core/JobSystemTests.h"
+#include "Core/ParallelTests.h"
+#include "Core/TaskGraphTests.h"
+#include "Core/EventTests.h"
+#include "Core/ProfilerTests.h"
+#include "Core/FrameStatsTests.h"
+#include "Renderer/NullRendererTests.h"
 #include <Core/Logger.h>
 
 int main()
@@ -9,6 +21,18 @@ int main()
 
     // Test registrations here
     LinearAllocatorRegisterTests();
+    HashRegisterTests();
+    SortRegisterTests();
+    RingQueueRegisterTests();
+    LoggerRegisterTests();
+    ThreadingRegisterTests();
+    JobSystemRegisterTests();
+    ParallelRegisterTests();
+    TaskGraphRegisterTests();
+    EventRegisterTests();
+    ProfilerRegisterTests();
+    FrameStatsRegisterTests();
+    NullRendererRegisterTests();
 
     TDEBUG("Starting tests...");
 
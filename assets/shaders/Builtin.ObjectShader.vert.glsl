@@ -7,13 +7,14 @@ layout(set = 0, binding = 0) uniform global_uniform_object
     mat4 projection;
 	mat4 view;
 } globalUBO;
-layout(push_constant) uniform push_constants
+// The model matrix of every object drawn in the frame. Objects sharing geometry are drawn as
+// instances of one draw, whose first instance is the first of their models.
+layout(set = 1, binding = 0) readonly buffer instance_buffer
 {
-    // Only guaranteed a total of 128 bytes
-    mat4 model; // 64 bytes
-} u_push_constants;
+    mat4 models[];
+} instances;
 
 void main()
 {
-    gl_Position = globalUBO.projection * globalUBO.view * u_push_constants.model * vec4(in_position, 1.0);
+    gl_Position = globalUBO.projection * globalUBO.view * instances.models[gl_InstanceIndex] * vec4(in_position, 1.0);
 }
\ No newline at end of file